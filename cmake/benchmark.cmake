@@ -0,0 +1,55 @@
+# Runs Vox once per benchmark setting, and prints the results of every run side by side.
+#
+#   cmake --build build --target benchmark
+#
+# Each run draws the frames it is given and exits on its own; its "[Benchmark]" line is
+# printed after the setting it ran with. Runs are made from the build directory, which
+# holds the assets and the pipeline cache.
+
+cmake_minimum_required(VERSION 3.28)
+
+if (NOT DEFINED VOX_EXECUTABLE)
+    message(FATAL_ERROR "Run through the benchmark target, or pass -DVOX_EXECUTABLE=<path to Vox>.")
+endif ()
+
+set(BENCHMARK_THREADS 1 2 4 8)
+
+function(run_benchmark LABEL FRAMES)
+    execute_process(
+            COMMAND "${CMAKE_COMMAND}" -E env "VOX_BENCHMARK_FRAMES=${FRAMES}" ${ARGN} "${VOX_EXECUTABLE}"
+            OUTPUT_VARIABLE OUTPUT
+            RESULT_VARIABLE RESULT
+    )
+
+    if (NOT RESULT EQUAL 0)
+        message(FATAL_ERROR "${LABEL}: Vox exited with ${RESULT}.")
+    endif ()
+
+    string(REGEX MATCH "\\[Benchmark\\][^\n]*" LINE "${OUTPUT}")
+
+    if (LINE STREQUAL "")
+        message(FATAL_ERROR "${LABEL}: Vox logged no results.")
+    endif ()
+
+    message("${LABEL} ${LINE}")
+endfunction()
+
+# Pipeline creation, with every pipeline built 32 times so that each worker has some to build.
+# A cold run starts without the pipeline cache; the warm run after it reads what it saved.
+# Pipelines are built before the first frame, so one frame is enough.
+foreach (THREADS ${BENCHMARK_THREADS})
+    file(REMOVE "cache/pipelines.bin")
+
+    run_benchmark("pipelines cold threads=${THREADS}" 1 VOX_PIPELINE_COPIES=32 VOX_PIPELINE_THREADS=${THREADS})
+    run_benchmark("pipelines warm threads=${THREADS}" 1 VOX_PIPELINE_COPIES=32 VOX_PIPELINE_THREADS=${THREADS})
+endforeach ()
+
+# Frame pacing, with the CPU running up to 1 to 4 frames ahead of the GPU.
+foreach (FRAMES_IN_FLIGHT 1 2 3 4)
+    run_benchmark("frames in_flight=${FRAMES_IN_FLIGHT}" 600 VOX_FRAMES_IN_FLIGHT=${FRAMES_IN_FLIGHT})
+endforeach ()
+
+# Draw recording, with the scene drawn 4096 times so that every worker records a few ranges.
+foreach (THREADS ${BENCHMARK_THREADS})
+    run_benchmark("recording threads=${THREADS}" 600 VOX_DRAW_COUNT=4096 VOX_RECORD_THREADS=${THREADS})
+endforeach ()
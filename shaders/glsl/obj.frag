@@ -1,14 +1,25 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
-layout(binding = 1) uniform sampler2D texSampler;
+// Discards texels below half opacity; enabled by the "cutout" variant.
+layout(constant_id = 0) const bool ALPHA_TEST = false;
+
+layout(set = 1, binding = 0) uniform sampler2D textures[];
 
 layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec2 fragTexCoord;
 layout(location = 2) in vec4 colorModulation;
 layout(location = 3) in float decay;
+layout(location = 4) flat in uint textureIndex;
 
 layout(location = 0) out vec4 outColor;
 
 void main() {
-    outColor = texture(texSampler, fragTexCoord) * colorModulation * decay;
+    vec4 texel = texture(textures[nonuniformEXT(textureIndex)], fragTexCoord);
+
+    if (ALPHA_TEST && texel.a < 0.5) {
+        discard;
+    }
+
+    outColor = texel * colorModulation * decay;
 }
\ No newline at end of file
@@ -7,10 +7,15 @@ layout(binding = 0) uniform UniformBufferObject {
 } ubo;
 
 layout(binding = 2) uniform Extras {
-    vec4 colorModulation;
     float decay;
 } extras;
 
+layout(push_constant) uniform Draw {
+    mat4 model;
+    vec4 colorModulation;
+    uint textureIndex;
+} draw;
+
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;
 layout(location = 2) in vec2 inTexCoord;
@@ -19,12 +24,14 @@ layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
 layout(location = 2) out vec4 colorModulation;
 layout(location = 3) out float decay;
+layout(location = 4) flat out uint textureIndex;
 
 void main() {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
+    gl_Position = ubo.proj * ubo.view * draw.model * vec4(inPosition, 1.0);
     fragColor = inColor;
     fragTexCoord = inTexCoord;
 
-    colorModulation = extras.colorModulation;
+    colorModulation = draw.colorModulation;
     decay = extras.decay;
+    textureIndex = draw.textureIndex;
 }
\ No newline at end of file
@@ -2,4 +2,8 @@ C:/VulkanSDK/1.3.275.0/Bin/glslc.exe glsl/obj.vert -o spirv/obj.vert
 C:/VulkanSDK/1.3.275.0/Bin/glslc.exe glsl/obj.frag -o spirv/obj.frag
 C:/VulkanSDK/1.3.275.0/Bin/glslc.exe glsl/obj_red.vert -o spirv/obj_red.vert
 C:/VulkanSDK/1.3.275.0/Bin/glslc.exe glsl/obj_red.frag -o spirv/obj_red.frag
+C:/VulkanSDK/1.3.275.0/Bin/spirv-val.exe --target-env vulkan1.0 spirv/obj.vert
+C:/VulkanSDK/1.3.275.0/Bin/spirv-val.exe --target-env vulkan1.0 spirv/obj.frag
+C:/VulkanSDK/1.3.275.0/Bin/spirv-val.exe --target-env vulkan1.0 spirv/obj_red.vert
+C:/VulkanSDK/1.3.275.0/Bin/spirv-val.exe --target-env vulkan1.0 spirv/obj_red.frag
 pause
\ No newline at end of file
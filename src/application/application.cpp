@@ -1,4 +1,11 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <numeric>
 #include <set>
+#include <utility>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
@@ -15,6 +22,10 @@
 #include "../misc/constants.h"
 #include "../shader/shader.h"
 #include "../misc/util.h"
+#include "../texture/texture_mipmap.h"
+#include "../texture/texture_bc.h"
+#include "../texture/texture_cache.h"
+#include "../misc/mapped_file.h"
 
 namespace vox {
 	void Application::initGlfw() {
@@ -33,20 +44,23 @@ namespace vox {
 		initSurface();
 		initPhysicalDevice();
 		initLogicalDevice();
+		initTimelines();
 		initSwapchain();
 		initShaders();
 		initModels();
         initTextures();
 		initImageViews();
-		initRenderPass();
+		initRenderGraph();
 		initDescriptorSetLayouts();
+		initPipelineCache();
 		initPipeline();
 		initCommandPools();
-		initDepthResources();
-		initFramebuffers();
 		initTextureImage();
 		initTextureImageView();
 		initTextureSampler();
+		initTextureAtlases();
+		initTextureTable();
+		initTextureResidency();
 
 		uploadModels();
 
@@ -54,13 +68,12 @@ namespace vox {
 		initIndexBuffer();
 		initUniformBuffers();
 		initUniformBufferObjects();
-		initDescriptorPool();
 		initDescriptorSets();
 		initCommandBuffers();
 		initSyncObjects();
 	}
 
-	void Application::executeImmediateCommand(std::function<void(VkCommandBuffer commandBuffer)> &&function) const {
+	uint64_t Application::executeImmediateCommand(std::function<void(VkCommandBuffer commandBuffer)> &&function) {
 		VkCommandBufferAllocateInfo allocInfo = {};
 		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
@@ -68,66 +81,84 @@ namespace vox {
 		allocInfo.commandBufferCount = 1;
 
 		VkCommandBuffer commandBuffer;
-		vkAllocateCommandBuffers(mainLogicalDevice, &allocInfo, &commandBuffer);
+
+		if (VK_SUCCESS != vkAllocateCommandBuffers(mainLogicalDevice, &allocInfo, &commandBuffer)) {
+			throw std::runtime_error("[Vulkan] Failed to allocate immediate command buffer!");
+		}
 
 		VkCommandBufferBeginInfo beginInfo = {};
 		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
-		vkBeginCommandBuffer(commandBuffer, &beginInfo);
+		if (VK_SUCCESS != vkBeginCommandBuffer(commandBuffer, &beginInfo)) {
+			vkFreeCommandBuffers(mainLogicalDevice, shortCommandPool, 1, &commandBuffer);
+			throw std::runtime_error("[Vulkan] Failed to begin immediate command buffer!");
+		}
 
 		function(commandBuffer);
 
-		vkEndCommandBuffer(commandBuffer);
+		if (VK_SUCCESS != vkEndCommandBuffer(commandBuffer)) {
+			vkFreeCommandBuffers(mainLogicalDevice, shortCommandPool, 1, &commandBuffer);
+			throw std::runtime_error("[Vulkan] Failed to record immediate command buffer!");
+		}
+
+		const auto timelineValue = graphicsTimeline.next();
+		const auto timelineSemaphore = graphicsTimeline.get();
+
+		VkTimelineSemaphoreSubmitInfo timelineSubmitInfo = {};
+		timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineSubmitInfo.signalSemaphoreValueCount = 1;
+		timelineSubmitInfo.pSignalSemaphoreValues = &timelineValue;
 
 		VkSubmitInfo submitInfo = {};
 		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.pNext = &timelineSubmitInfo;
 		submitInfo.commandBufferCount = 1;
 		submitInfo.pCommandBuffers = &commandBuffer;
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = &timelineSemaphore;
 
-		vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-		vkQueueWaitIdle(graphicsQueue);
+		if (VK_SUCCESS != vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE)) {
+			vkFreeCommandBuffers(mainLogicalDevice, shortCommandPool, 1, &commandBuffer);
+			throw std::runtime_error("[Vulkan] Failed to submit immediate command buffer!");
+		}
 
-		vkFreeCommandBuffers(mainLogicalDevice, shortCommandPool, 1, &commandBuffer);
-	}
+		// Nothing waits for the submission here: its command buffer, like whatever else it reads, is
+		// released once its value is reached, and the next frame waits on it on the GPU instead.
+		graphicsTimeline.defer([device = mainLogicalDevice, commandPool = shortCommandPool, commandBuffer] {
+			vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
+		});
 
-	void Application::transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout) const {
-		executeImmediateCommand([&](const auto& commandBuffer) {
-			VkImageMemoryBarrier barrier = {};
-			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-			barrier.oldLayout = oldLayout;
-			barrier.newLayout = newLayout;
-			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-			barrier.image = image;
-			barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			barrier.subresourceRange.baseMipLevel = 0;
-			barrier.subresourceRange.levelCount = 1;
-			barrier.subresourceRange.baseArrayLayer = 0;
-			barrier.subresourceRange.layerCount = 1;
+		uploadTimelineValue = timelineValue;
 
-			VkPipelineStageFlags sourceStage;
-			VkPipelineStageFlags destinationStage;
+		return timelineValue;
+	}
 
-			if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-				barrier.srcAccessMask = 0;
-				barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	void Application::retireBuffer(VkBuffer buffer, VkDeviceMemory bufferMemory) {
+		graphicsTimeline.defer([device = mainLogicalDevice, buffer, bufferMemory] {
+			vkDestroyBuffer(device, buffer, nullptr);
+			vkFreeMemory(device, bufferMemory, nullptr);
+		});
+	}
 
-				sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-				destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-			} else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
-				barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-				barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	uint64_t Application::transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, const uint32_t mipLevels) {
+		return executeImmediateCommand([&](const auto& commandBuffer) {
+			const auto from = getImageState(oldLayout);
+			const auto to = getImageState(newLayout);
 
-				sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-				destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-			} else {
-				throw std::invalid_argument("unsupported layout transition!");
-			}
+			const VkImageSubresourceRange range = {
+				.aspectMask = getImageAspect(format),
+				.baseMipLevel = 0,
+				.levelCount = mipLevels,
+				.baseArrayLayer = 0,
+				.layerCount = 1
+			};
+
+			const auto barrier = buildImageBarrier(image, range, from, to);
 
 			vkCmdPipelineBarrier(
 				commandBuffer,
-				sourceStage, destinationStage,
+				from.stage, to.stage,
 				0,
 				0, nullptr,
 				0, nullptr,
@@ -175,6 +206,7 @@ namespace vox {
 		initInfo.QueueFamily = getQueueFamilies(mainPhysicalDevice).graphicsFamily.value(); // TODO: Check if this works.
 		initInfo.Queue = graphicsQueue;
 		initInfo.DescriptorPool = imguiDescriptorPool;
+		initInfo.PipelineCache = pipelineCache.get();
 		initInfo.MinImageCount = 3;
 		initInfo.ImageCount = 3;
 		initInfo.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
@@ -293,7 +325,7 @@ namespace vox {
 		appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
 		appInfo.pEngineName = ENGINE;
 		appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-		appInfo.apiVersion = VK_API_VERSION_1_1;
+		appInfo.apiVersion = VK_API_VERSION_1_2;
 
 		VkInstanceCreateInfo createInfo = {};
 		createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -358,7 +390,9 @@ namespace vox {
 	}
 
     void Application::initTextures() {
-        textureManager.loadAll();
+        textureManager.loadAll(threadPool);
+
+        textureManager.stitchAll(mainPhysicalDeviceProperties.limits.maxImageDimension2D);
     }
 
 	void Application::initSurface() {
@@ -386,10 +420,10 @@ namespace vox {
 			if (hasRequiredFeatures(device)) {
 				mainPhysicalDevice = device;
 
-				VkPhysicalDeviceProperties deviceProperties;
-				vkGetPhysicalDeviceProperties(mainPhysicalDevice, &deviceProperties);
+				// Queried once; limits are looked up on every sampler and atlas build.
+				vkGetPhysicalDeviceProperties(mainPhysicalDevice, &mainPhysicalDeviceProperties);
 
-				std::cout << "[Vulkan] Physical device selected: " << deviceProperties.deviceName << "\n" << std::flush;
+				std::cout << "[Vulkan] Physical device selected: " << mainPhysicalDeviceProperties.deviceName << "\n" << std::flush;
 
 				break;
 			}
@@ -416,12 +450,35 @@ namespace vox {
 			queueCreateInfos.push_back(queueCreateInfo);
 		}
 
+		VkPhysicalDeviceFeatures supportedFeatures = {};
+		vkGetPhysicalDeviceFeatures(mainPhysicalDevice, &supportedFeatures);
+
 		VkPhysicalDeviceFeatures deviceFeatures = {};
 		deviceFeatures.samplerAnisotropy = VK_TRUE;
+		deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+
+		textureCompressionEnabled = supportedFeatures.textureCompressionBC == VK_TRUE;
+
+		// Required by the bindless texture table; support is checked when picking the device.
+		VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures = {};
+		descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+		descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+		descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+		descriptorIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+		descriptorIndexingFeatures.descriptorBindingVariableDescriptorCount = VK_TRUE;
+		descriptorIndexingFeatures.runtimeDescriptorArray = VK_TRUE;
+
+		// Every submission signals the graphics timeline; support is checked when picking the device.
+		VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphoreFeatures = {};
+		timelineSemaphoreFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+		timelineSemaphoreFeatures.timelineSemaphore = VK_TRUE;
+
+		descriptorIndexingFeatures.pNext = &timelineSemaphoreFeatures;
 
 		VkDeviceCreateInfo createInfo = {};
 
 		createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+		createInfo.pNext = &descriptorIndexingFeatures;
 		createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
 		createInfo.pQueueCreateInfos = queueCreateInfos.data();
 		createInfo.pEnabledFeatures = &deviceFeatures;
@@ -524,199 +581,296 @@ namespace vox {
 		std::cout << "[Vulkan] Image view creation successfull.\n" << std::flush;
 	}
 
-	void Application::initRenderPass() {
-		VkAttachmentDescription colorAttDesc = {};
-		colorAttDesc.format = swapchainImageFormat;
-		colorAttDesc.samples = VK_SAMPLE_COUNT_1_BIT;
-		colorAttDesc.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-		colorAttDesc.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-		colorAttDesc.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-		colorAttDesc.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-		colorAttDesc.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		colorAttDesc.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-		VkAttachmentDescription depthAttDesc = {};
-		depthAttDesc.format = findDepthFormat();
-		depthAttDesc.samples = VK_SAMPLE_COUNT_1_BIT;
-		depthAttDesc.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-		depthAttDesc.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-		depthAttDesc.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-		depthAttDesc.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-		depthAttDesc.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		depthAttDesc.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-		VkAttachmentReference colorAttRef = {};
-		colorAttRef.attachment = 0;
-		colorAttRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-		VkAttachmentReference depthAttRef = {};
-		depthAttRef.attachment = 1;
-		depthAttRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-		VkSubpassDescription subpassDesc = {};
-		subpassDesc.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-		subpassDesc.colorAttachmentCount = 1;
-		subpassDesc.pColorAttachments = &colorAttRef;\
-		subpassDesc.pDepthStencilAttachment = &depthAttRef;
-
-		VkSubpassDependency subpassDep = {};
-		subpassDep.srcSubpass = VK_SUBPASS_EXTERNAL;
-		subpassDep.dstSubpass = 0;
-		subpassDep.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-		subpassDep.srcAccessMask = 0;
-		subpassDep.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-		subpassDep.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-
-		const std::array attachments = { colorAttDesc, depthAttDesc };
-
-		VkRenderPassCreateInfo renderPassInfo = {};
-		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-		renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-		renderPassInfo.pAttachments = attachments.data();
-		renderPassInfo.subpassCount = 1;
-		renderPassInfo.pSubpasses = &subpassDesc;
-		renderPassInfo.dependencyCount = 1;
-		renderPassInfo.pDependencies = &subpassDep;
-
-		if (VK_SUCCESS != vkCreateRenderPass(mainLogicalDevice, &renderPassInfo, nullptr, &renderPass)) {
-			throw std::runtime_error("[Vulkan] Failed to create render pass!");
+	void Application::initRenderGraph() {
+		// The acquire semaphore is waited on at color output, which the first barrier of the swapchain image chains to.
+		swapchainResource = renderGraph.importImage(
+			"swapchain",
+			{ swapchainImageFormat, swapchainExtent, 0 },
+			{ VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0 },
+			VK_IMAGE_LAYOUT_PRESENT_SRC_KHR
+		);
+
+		const auto depthResource = renderGraph.createImage("depth", { findDepthFormat(), swapchainExtent, 0 });
+
+		mainPass = renderGraph.addPass("main", [&](RenderGraphBuilder& builder) {
+			builder.writeColor(swapchainResource, VK_ATTACHMENT_LOAD_OP_CLEAR, {{ 0.0f, 0.0f, 0.0f, 1.0f }});
+			builder.writeDepth(depthResource, VK_ATTACHMENT_LOAD_OP_CLEAR, { 1.0f, 0 });
+			builder.setContents(VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+		}, [this](const RenderGraphContext& context) {
+			recordMainPass(context);
+		});
+
+		if (VK_SUCCESS != renderGraph.compile(mainPhysicalDevice, mainLogicalDevice)) {
+			throw std::runtime_error("[Vulkan] Failed to compile render graph!");
 		}
+
+		// Rebuilding the graph for a new extent yields the same render pass, so pipelines built against it stay valid.
+		renderPass = renderGraph.getRenderPass(mainPass);
+
+		const auto& stats = renderGraph.getStats();
+
+		std::cout << "[Vulkan] Compiled render graph: " << stats.passes << " pass(es), " << stats.culledPasses << " culled, " << stats.barriers << " barrier(s) per frame, " << stats.transientImages << " transient image(s) in " << stats.transientSize / 1024 << " KiB (" << stats.unaliasedSize / 1024 << " KiB without aliasing).\n" << std::flush;
 	}
 
 	void Application::initDescriptorSetLayouts() {
-		for (auto& shader : shaderManager.getAll() | std::views::values) {
-			shader.reserveBuffer(0);
-			shader.reserveSampler(1);
-			shader.reserveBuffer();
+		for (auto& [id, shader] : shaderManager.getAll()) {
+			shader.reflect();
+
+			// Outside of its own set 0, a shader may only use the texture table.
+			for (const auto& binding : shader.getReflection().bindings) {
+				if (binding.set == 0) continue;
+
+				if (binding.set != 1 || binding.binding != 0 || binding.type != VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER) {
+					throw std::runtime_error("[Vulkan] Shader " + id + " declares set " + std::to_string(binding.set) + ", binding " + std::to_string(binding.binding) + ", which no descriptor set provides!");
+				}
+			}
+
+			for (const auto& range : shader.getPushConstantRanges()) {
+				if (range.offset + range.size > mainPhysicalDeviceProperties.limits.maxPushConstantsSize) {
+					throw std::runtime_error("[Vulkan] Shader " + id + " uses " + std::to_string(range.offset + range.size) + " bytes of push constants, more than the device supports!");
+				}
+			}
 
 			shader.buildDescriptorSetLayout(mainLogicalDevice);
 		}
+
+		// Every pipeline layout shares the texture table, at set 1.
+		textureTable.build(mainLogicalDevice, getTextureTableCapacity());
+	}
+
+	void Application::initPipelineCache() {
+		pipelineCache.build(mainLogicalDevice, mainPhysicalDeviceProperties);
 	}
 
 	void Application::initPipeline() {
+		const auto startTime = std::chrono::high_resolution_clock::now();
+
+		// Pipelines are built into slots in shader order, and stored once all of them are done.
+		std::vector<std::string> ids;
+		std::vector<Shader<>*> shaders;
+
+		for (auto& [id, shader] : shaderManager.getAll()) {
+			ids.push_back(id);
+			shaders.push_back(&shader);
+		}
+
+		// Copies past the first only exist to measure how building scales, and are destroyed once built.
+		// They go through the pipeline cache like the rest, so a warm cache is measured as a warm start.
+		const auto copyCount = getPipelineCopyCount();
+
+		std::vector<VkPipelineLayout> builtPipelineLayouts(shaders.size() * copyCount);
+		std::vector<VkPipeline> builtPipelines(shaders.size() * copyCount);
+
+		// parallelFor never starts more runners than there are pipelines to build.
+		const auto threadCount = static_cast<uint32_t>(std::min<size_t>(getPipelineThreadCount(), std::max<size_t>(builtPipelines.size(), 1)));
+
+		// Object creation is free-threaded on the device, and the pipeline cache is internally synchronized.
+		threadPool.parallelFor(builtPipelines.size(), [&, compatibleRenderPass = renderPass](const size_t index) {
+			const auto shaderIndex = index % shaders.size();
+
+			buildPipeline(ids[shaderIndex], *shaders[shaderIndex], compatibleRenderPass, builtPipelineLayouts[index], builtPipelines[index]);
+		}, threadCount);
+
+		const auto buildTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+		for (auto i = ids.size(); i < builtPipelines.size(); ++i) {
+			vkDestroyPipeline(mainLogicalDevice, builtPipelines[i], nullptr);
+			vkDestroyPipelineLayout(mainLogicalDevice, builtPipelineLayouts[i], nullptr);
+		}
+
+		for (size_t i = 0; i < ids.size(); ++i) {
+			pipelineLayouts[ids[i]] = builtPipelineLayouts[i];
+			pipelines[ids[i]] = builtPipelines[i];
+
+			std::cout << "[Vulkan] Pipeline initialization succeeded for shader: " + ids[i] + "\n" << std::flush;
+		}
+
+		pipelineBuildCount = builtPipelines.size();
+		pipelineBuildThreadCount = threadCount;
+		pipelineBuildTime = buildTime;
+
+		std::cout << "[Vulkan] Built " << builtPipelines.size() << " pipeline(s) in " << buildTime << "ms on " << threadCount << " thread(s).\n" << std::flush;
+
+		// Saved right away, so that a crash later on still keeps the compiled pipelines.
+		pipelineCache.save(mainLogicalDevice);
+	}
+
+	// Runs on workers, so the render pass is passed in rather than read from the application.
+	void Application::buildPipeline(const std::string& id, Shader<>& shader, const VkRenderPass compatibleRenderPass, VkPipelineLayout& pipelineLayout, VkPipeline& pipeline) {
+		if (!shader.getDescriptorSetLayout().has_value()) {
+			throw std::runtime_error("[Vulkan] Descriptor set layout not found for shader: " + id);
+		}
+
+		const std::array descriptorSetLayouts = {
+			shader.getDescriptorSetLayout().value(),
+			textureTable.getDescriptorSetLayout()
+		};
+
+		const auto pushConstantRanges = shader.getPushConstantRanges();
+
+		VkPipelineLayoutCreateInfo layoutCreateInfo = {};
+		layoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutCreateInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
+		layoutCreateInfo.pSetLayouts = descriptorSetLayouts.data();
+		layoutCreateInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
+		layoutCreateInfo.pPushConstantRanges = pushConstantRanges.data();
+
+		if (VK_SUCCESS != vkCreatePipelineLayout(mainLogicalDevice, &layoutCreateInfo, nullptr, &pipelineLayout)) {
+			throw std::runtime_error("[Vulkan] Failed to create pipeline layout for shader: " + id);
+		}
+
+		// Only the default variant is built up front; the others share its layout.
+		try {
+			buildPipelineVariant(id, shader, compatibleRenderPass, pipelineLayout, "", pipeline);
+		} catch (...) {
+			// Reloads survive a broken shader, so nothing may leak when one fails.
+			vkDestroyPipelineLayout(mainLogicalDevice, pipelineLayout, nullptr);
+			pipelineLayout = VK_NULL_HANDLE;
+
+			throw;
+		}
+	}
+
+	void Application::buildPipelineVariant(const std::string& id, const Shader<>& shader, const VkRenderPass compatibleRenderPass, const VkPipelineLayout pipelineLayout, const std::string& variant, VkPipeline& pipeline) {
 		// TODO: Implement shader module metadata. This would be useful for entrynames, etc.
 		// TODO: Another issue is, how do we dictate the attributes, descriptor layouts, etc? This is
 		// TODO: why Minecraft has the shader JSON files.
-		for (auto& [id, shader] : shaderManager.getAll()) {
-			const auto vertexShaderCode = shader.getVertexShaderCode();
-			const auto fragmentShaderCode = shader.getFragmentShaderCode();
+		const auto vertexShaderCode = shader.getVertexShaderCode();
+		const auto fragmentShaderCode = shader.getFragmentShaderCode();
 
-			if (!vertexShaderCode.has_value()) {
-				throw std::runtime_error("[Vulkan] Vertex shader code not found for shader: " + id);
-			}
+		if (!vertexShaderCode.has_value()) {
+			throw std::runtime_error("[Vulkan] Vertex shader code not found for shader: " + id);
+		}
 
-			if (!fragmentShaderCode.has_value()) {
-				throw std::runtime_error("[Vulkan] Fragment shader code not found for shader: " + id);
-			}
+		if (!fragmentShaderCode.has_value()) {
+			throw std::runtime_error("[Vulkan] Fragment shader code not found for shader: " + id);
+		}
 
-			const auto vertexShaderModule = buildShaderModule(vertexShaderCode.value());
-			const auto fragmentShaderModule = buildShaderModule(fragmentShaderCode.value());
+		// Both stages get every constant; the ones a stage does not declare are ignored.
+		const auto specialization = shader.getSpecialization(variant);
+		const auto specializationInfo = specialization.getInfo();
 
-			shader.setVertexShaderCode(std::nullopt); // Free the memory used by the vector.
-			shader.setFragmentShaderCode(std::nullopt); // Free the memory used by the vector.
+		const auto vertexShaderModule = buildShaderModule(vertexShaderCode.value());
+		const auto fragmentShaderModule = buildShaderModule(fragmentShaderCode.value());
 
-			shader.setVertexShaderModule(vertexShaderModule);
-			shader.setFragmentShaderModule(fragmentShaderModule);
+		const auto vertexShaderStageCreateInfo = buildPipelineShaderStageCreateInfo(vertexShaderModule, VK_SHADER_STAGE_VERTEX_BIT, &specializationInfo);
+		const auto fragmentShaderStageCreateInfo = buildPipelineShaderStageCreateInfo(fragmentShaderModule, VK_SHADER_STAGE_FRAGMENT_BIT, &specializationInfo);
 
-			const auto vertexShaderStageCreateInfo = buildPipelineShaderStageCreateInfo(vertexShaderModule, VK_SHADER_STAGE_VERTEX_BIT);
-			const auto fragmentShaderStageCreateInfo = buildPipelineShaderStageCreateInfo(fragmentShaderModule, VK_SHADER_STAGE_FRAGMENT_BIT);
+		const auto shaderStageCreateInfos = std::array { vertexShaderStageCreateInfo, fragmentShaderStageCreateInfo };
 
-			const auto shaderStageCreateInfos = std::array { vertexShaderStageCreateInfo, fragmentShaderStageCreateInfo };
+		VkPipelineVertexInputStateCreateInfo vertexInputStateCreateInfo = {};
+		vertexInputStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+		vertexInputStateCreateInfo.vertexBindingDescriptionCount = 1;
 
-			VkPipelineVertexInputStateCreateInfo vertexInputStateCreateInfo = {};
-			vertexInputStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-			vertexInputStateCreateInfo.vertexBindingDescriptionCount = 1;
+		const auto vertexBindingDescription = shader.getBindingDescription();
+		const auto vertexAttributeDescription = shader.getAttributeDescriptions();
 
-			const auto vertexBindingDescription = shader.getBindingDescription();
-			const auto vertexAttributeDescription = shader.getAttributeDescriptions();
+		vertexInputStateCreateInfo.pVertexBindingDescriptions = &vertexBindingDescription;
 
-			vertexInputStateCreateInfo.pVertexBindingDescriptions = &vertexBindingDescription;
+		vertexInputStateCreateInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexAttributeDescription.size());
+		vertexInputStateCreateInfo.pVertexAttributeDescriptions = vertexAttributeDescription.data();
 
-			vertexInputStateCreateInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexAttributeDescription.size());
-			vertexInputStateCreateInfo.pVertexAttributeDescriptions = vertexAttributeDescription.data();
+		VkPipelineInputAssemblyStateCreateInfo inputAssemblyStateCreateInfo = {};
+		inputAssemblyStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+		inputAssemblyStateCreateInfo.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+		inputAssemblyStateCreateInfo.primitiveRestartEnable = VK_FALSE;
 
-			VkPipelineInputAssemblyStateCreateInfo inputAssemblyStateCreateInfo = {};
-			inputAssemblyStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-			inputAssemblyStateCreateInfo.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-			inputAssemblyStateCreateInfo.primitiveRestartEnable = VK_FALSE;
+		// Set while recording instead, so that resizing the swapchain leaves every pipeline valid.
+		constexpr std::array dynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
 
-			VkViewport viewport = {
-				.x = 0.0f,
-				.y = 0.0f,
-				.width = static_cast<float>(swapchainExtent.width),
-				.height = static_cast<float>(swapchainExtent.height),
-				.minDepth = 0.0f,
-				.maxDepth = 1.0f
-			};
+		const auto viewportStateCreateInfo = buildPipelineViewportStateCreateInfo();
+		const auto dynamicStateCreateInfo = buildPipelineDynamicStateCreateInfo(dynamicStates);
+		const auto rasterizationStateCreateInfo = buildPipelineRasterizationStateCreateInfo();
+		const auto multisamplerStateCreateInfo = buildPipelineMultisampleStateCreateInfo();
+		const auto colorBlendAttachmentState = buildPipelineColorBlendAttachmentState();
+		const auto colorBlendStateCreateInfo = buildPipelineColorBlendStateCreateInfo(&colorBlendAttachmentState);
+		const auto depthStencilStateCreateInfo = buildPipelineDepthStencilStateCreateInfo();
 
-			VkRect2D scissor = {
-				.offset = { 0, 0 },
-				.extent = swapchainExtent
-			};
+		VkGraphicsPipelineCreateInfo pipelineCreateInfo = {};
+		pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		pipelineCreateInfo.stageCount = 2;
+		pipelineCreateInfo.pStages = shaderStageCreateInfos.data();
+		pipelineCreateInfo.pVertexInputState = &vertexInputStateCreateInfo;
+		pipelineCreateInfo.pInputAssemblyState = &inputAssemblyStateCreateInfo;
+		pipelineCreateInfo.pViewportState = &viewportStateCreateInfo;
+		pipelineCreateInfo.pRasterizationState = &rasterizationStateCreateInfo;
+		pipelineCreateInfo.pMultisampleState = &multisamplerStateCreateInfo;
+		pipelineCreateInfo.pDepthStencilState = &depthStencilStateCreateInfo;
+		pipelineCreateInfo.pColorBlendState = &colorBlendStateCreateInfo;
+		pipelineCreateInfo.pDynamicState = &dynamicStateCreateInfo;
+		pipelineCreateInfo.layout = pipelineLayout;
+		pipelineCreateInfo.renderPass = compatibleRenderPass;
+		pipelineCreateInfo.subpass = 0;
+		pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+		pipelineCreateInfo.basePipelineIndex = -1;
 
-			const auto viewportStateCreateInfo = buildPipelineViewportStateCreateInfo(&viewport, &scissor);
-			const auto rasterizationStateCreateInfo = buildPipelineRasterizationStateCreateInfo();
-			const auto multisamplerStateCreateInfo = buildPipelineMultisampleStateCreateInfo();
-			const auto colorBlendAttachmentState = buildPipelineColorBlendAttachmentState();
-			const auto colorBlendStateCreateInfo = buildPipelineColorBlendStateCreateInfo(&colorBlendAttachmentState);
-			const auto depthStencilStateCreateInfo = buildPipelineDepthStencilStateCreateInfo();
+		const auto result = vkCreateGraphicsPipelines(mainLogicalDevice, pipelineCache.get(), 1, &pipelineCreateInfo, nullptr, &pipeline);
 
-			if (!shader.getDescriptorSetLayout().has_value()) {
-				throw std::runtime_error("[Vulkan] Descriptor set layout not found for shader: " + id);
-			}
+		vkDestroyShaderModule(mainLogicalDevice, vertexShaderModule, nullptr);
+		vkDestroyShaderModule(mainLogicalDevice, fragmentShaderModule, nullptr);
+
+		if (VK_SUCCESS != result) {
+			throw std::runtime_error("[Vulkan] Failed to create graphics pipeline for shader: " + id + (variant.empty() ? "" : " (variant " + variant + ")"));
+		}
+	}
 
-			auto descriptorSetLayout = shader.getDescriptorSetLayout().value();
+	VkPipeline Application::getPipeline(const std::string& id, const std::string& variant) {
+		if (variant.empty()) {
+			return pipelines[id];
+		}
 
-			VkPipelineLayoutCreateInfo layoutCreateInfo = {};
-			layoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-			layoutCreateInfo.setLayoutCount = 1;
-			layoutCreateInfo.pSetLayouts = &descriptorSetLayout;
+		auto& variants = pipelineVariants[id];
 
-			if (VK_SUCCESS != vkCreatePipelineLayout(mainLogicalDevice, &layoutCreateInfo, nullptr, &pipelineLayouts[id])) {
-				throw std::runtime_error("[Vulkan] Failed to create pipeline layout for shader: " + id);
-			}
+		if (const auto built = variants.find(variant); built != variants.end()) {
+			return built->second;
+		}
 
-			std::cout << "[Vulkan] Pipeline layout initialization succeeded.\n" << std::flush;
-
-			VkGraphicsPipelineCreateInfo pipelineCreateInfo = {};
-			pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-			pipelineCreateInfo.stageCount = 2;
-			pipelineCreateInfo.pStages = shaderStageCreateInfos.data();
-			pipelineCreateInfo.pVertexInputState = &vertexInputStateCreateInfo;
-			pipelineCreateInfo.pInputAssemblyState = &inputAssemblyStateCreateInfo;
-			pipelineCreateInfo.pViewportState = &viewportStateCreateInfo;
-			pipelineCreateInfo.pRasterizationState = &rasterizationStateCreateInfo;
-			pipelineCreateInfo.pMultisampleState = &multisamplerStateCreateInfo;
-			pipelineCreateInfo.pDepthStencilState = &depthStencilStateCreateInfo;
-			pipelineCreateInfo.pColorBlendState = &colorBlendStateCreateInfo;
-			pipelineCreateInfo.pDynamicState = nullptr;
-			pipelineCreateInfo.layout = pipelineLayouts[id];
-			pipelineCreateInfo.renderPass = renderPass;
-			pipelineCreateInfo.subpass = 0;
-			pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
-			pipelineCreateInfo.basePipelineIndex = -1;
-
-			if (VK_SUCCESS != vkCreateGraphicsPipelines(mainLogicalDevice, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipelines[id])) {
-				throw std::runtime_error("[Vulkan] Failed to create graphics pipeline for shader: " + id);
-			}
+		// Built while recording; the pipeline cache keeps this cheap on later runs.
+		try {
+			VkPipeline pipeline;
+			buildPipelineVariant(id, shaderManager.get(id), renderPass, pipelineLayouts[id], variant, pipeline);
+
+			variants[variant] = pipeline;
+
+			std::cout << "[Vulkan] Built variant " << variant << " of shader: " << id << "\n" << std::flush;
+
+			return pipeline;
+		} catch (const std::exception& exception) {
+			std::cerr << "[Vulkan] Failed to build variant " << variant << " of shader " << id << ", drawing the default one: " << exception.what() << "\n" << std::flush;
 
-			std::cout << "[Vulkan] Pipeline initialization succeeded for shader: " + id + "\n" << std::flush;
+			shaderVariants[id].clear();
 
-			vkDestroyShaderModule(mainLogicalDevice, vertexShaderModule, nullptr);
-			vkDestroyShaderModule(mainLogicalDevice, fragmentShaderModule, nullptr);
+			return pipelines[id];
 		}
 	}
 
-	void Application::initFramebuffers() {
-		swapchainFramebuffers.resize(swapchainImageViews.size());
+	ReloadedPipeline Application::reloadShader(const std::string& id, const ShaderReflection& liveReflection, const VkDescriptorSetLayout descriptorSetLayout, const VkRenderPass compatibleRenderPass) {
+		auto shader = ShaderManager::load(id);
+		shader.reflect();
 
-		for (auto i = 0; i < swapchainFramebuffers.size(); ++i) {
-			if (VK_SUCCESS != buildFramebuffer(&swapchainFramebuffers[i], renderPass, { swapchainImageViews[i], depthImageView }, swapchainExtent.width, swapchainExtent.height)) {
-				throw std::runtime_error("[Vulkan] Failed to create framebuffer!");
-			}
+		// The live descriptor sets and uniform buffers stay in use, so only pipelines that fit them are swapped in.
+		if (!liveReflection.isLayoutCompatible(shader.getReflection())) {
+			throw std::runtime_error("[Vulkan] Shader " + id + " changed its descriptor or push constant layout, restart to apply it!");
 		}
 
-		std::cout << "[Vulkan] Framebuffer initialization succeeded.\n" << std::flush;
+		shader.setDescriptorSetLayout(descriptorSetLayout);
+
+		ReloadedPipeline reloaded = { shader.getMetadata(), shader.getVertexShaderCode(), shader.getFragmentShaderCode() };
+		buildPipeline(id, shader, compatibleRenderPass, reloaded.pipelineLayout, reloaded.pipeline);
+
+		return reloaded;
+	}
+
+	void Application::submitShaderReload(const std::string& id) {
+		const auto& shader = shaderManager.get(id);
+
+		auto& shaderReload = shaderReloads[id];
+
+		// Everything the worker needs from the application is captured now, while nothing else changes it.
+		shaderReload.result = threadPool.submit([this, id, reflection = shader.getReflection(), descriptorSetLayout = shader.getDescriptorSetLayout().value(), compatibleRenderPass = renderPass] {
+			return reloadShader(id, reflection, descriptorSetLayout, compatibleRenderPass);
+		});
+		shaderReload.pending = false;
 	}
 
 	void Application::initCommandPools() {
@@ -729,6 +883,10 @@ namespace vox {
 		if (VK_SUCCESS != buildCommandPool(&shortCommandPool, graphicsFamily.value(), VK_COMMAND_POOL_CREATE_TRANSIENT_BIT)) {
 			throw std::runtime_error("[Vulkan] Failed to create short command pool!");
 		}
+
+		if (VK_SUCCESS != commandRecorder.build(mainLogicalDevice, graphicsFamily.value())) {
+			throw std::runtime_error("[Vulkan] Failed to create secondary command pools!");
+		}
 	}
 
 	void Application::initVertexBuffer() {
@@ -743,51 +901,20 @@ namespace vox {
 		}
 	}
 
-	void Application::initDescriptorPool() {
-		std::array<VkDescriptorPoolSize, 2> sizes = {};
-		sizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		sizes[0].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT * 5); // TODO: Adjust!
-		sizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		sizes[1].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT * 5); // TODO: Adjust!
-
-		VkDescriptorPoolCreateInfo createInfo = {};
-		createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-		createInfo.poolSizeCount = sizes.size();
-		createInfo.pPoolSizes = sizes.data();
-
-		createInfo.maxSets = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT * 5); // TODO: Adjust!
-
-		if (VK_SUCCESS != vkCreateDescriptorPool(mainLogicalDevice, &createInfo, nullptr, &descriptorPool)) {
-			throw std::runtime_error("[Vulkan] Failed to create descriptor pool!");
-		}
-	}
-
 	void Application::initDescriptorSets() {
 		for (auto& [id, shader] : shaderManager.getAll()) {
-			shader.buildDescriptorSets(mainLogicalDevice, descriptorPool, MAX_FRAMES_IN_FLIGHT);
-		}
-	}
-
-	void Application::initDepthResources() {
-		const auto depthFormat = findDepthFormat();
-
-		if (VK_SUCCESS != buildImage(swapchainExtent.width, swapchainExtent.height, depthFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, depthImage, depthImageMemory)) {
-			throw std::runtime_error("[Vulkan] Failed to create depth image!");
-		}
-
-		if (VK_SUCCESS != buildImageView(depthImage, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT, depthImageView)) {
-			throw std::runtime_error("[Vulkan] Failed to create depth image view!");
+			shader.buildDescriptorSets(mainLogicalDevice, descriptorAllocator, framesInFlight);
 		}
 	}
 
 	void Application::initTextureImage() {
-		if (VK_SUCCESS != buildTextureImage(TEXTURE_PATH, textureImage, textureImageMemory)) {
+		if (VK_SUCCESS != buildTextureImage(TEXTURE_PATH, textureImage, textureImageMemory, textureFormat, textureMipLevels, textureSource)) {
 			throw std::runtime_error("[Vulkan] Failed to create texture image!");
 		}
 	}
 
 	void Application::initTextureImageView() {
-		if (VK_SUCCESS != buildImageView(textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT, textureImageView)) {
+		if (VK_SUCCESS != buildImageView(textureImage, textureFormat, VK_IMAGE_ASPECT_COLOR_BIT, textureImageView, textureMipLevels)) {
 			throw std::runtime_error("[Vulkan] Failed to create texture image view!");
 		}
 	}
@@ -798,12 +925,60 @@ namespace vox {
 		}
 	}
 
+	void Application::initTextureAtlases() {
+		for (const auto& [atlasId, atlas] : textureManager.getAtlases()) {
+			const auto mipLevels = atlas.getMipLevels();
+
+			if (VK_SUCCESS != buildImage(atlas.getWidth(), atlas.getHeight(), mipLevels, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, atlasImages[atlasId], atlasImageMemories[atlasId])) {
+				throw std::runtime_error("[Vulkan] Failed to create atlas image!");
+			}
+
+			uploadTextureAtlas(atlasId, VK_IMAGE_LAYOUT_UNDEFINED);
+
+			if (VK_SUCCESS != buildImageView(atlasImages[atlasId], VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT, atlasImageViews[atlasId], mipLevels)) {
+				throw std::runtime_error("[Vulkan] Failed to create atlas image view!");
+			}
+
+			std::cout << "[Vulkan] Uploaded atlas " << atlasId << ".\n" << std::flush;
+		}
+	}
+
+	void Application::initTextureTable() {
+		textureTableIndex = textureTable.add(mainLogicalDevice, textureImageView, textureSampler);
+
+		textureManager.registerAll(mainLogicalDevice, textureTable, atlasImageViews, textureSampler);
+
+		std::cout << "[Vulkan] Initialized texture table (" << textureTable.getCount() << " of " << textureTable.getCapacity() << " slots).\n" << std::flush;
+	}
+
+	void Application::initTextureResidency() {
+		// Atlas textures keep their full pixels on the CPU, and can be placed from any level; duplicates follow the texture they alias.
+		for (const auto& [textureId, texture] : textureManager.getTextures()) {
+			if (textureManager.getCanonicalId(textureId) == textureId) {
+				textureResidency.addTexture(textureId | TEXTURE_RESIDENCY_ATLAS_BIT, TextureBlockFormat::RGBA8, texture.getWidth(), texture.getHeight(), getMipLevelCount(texture.getWidth(), texture.getHeight()));
+			}
+		}
+
+		// RGBA8 textures have their mip chain generated on the GPU, with no levels on the CPU to stream from.
+		if (textureSource.has_value()) {
+			textureResidencyId = textureTableIndex;
+
+			textureResidency.addTexture(textureResidencyId, textureSource->getFormat(), textureSource->getWidth(), textureSource->getHeight(), textureSource->getLevelCount());
+		}
+
+		for (const auto& model : modelManager.getAll() | std::views::values) {
+			textureModelBounds.push_back(model.getBounds());
+		}
+
+		std::cout << "[Vulkan] Initialized texture residency (" << textureResidency.getResidentSize() / 1024 << " of " << textureResidency.getBudget() / 1024 << " KiB).\n" << std::flush;
+	}
+
 	void Application::initUniformBuffers() {
-		uniformBuffers.resize(MAX_FRAMES_IN_FLIGHT);
-		uniformBufferMemories.resize(MAX_FRAMES_IN_FLIGHT);
-		uniformBuffersMapped.resize(MAX_FRAMES_IN_FLIGHT);
+		uniformBuffers.resize(framesInFlight);
+		uniformBufferMemories.resize(framesInFlight);
+		uniformBuffersMapped.resize(framesInFlight);
 
-		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+		for (size_t i = 0; i < framesInFlight; i++) {
 			if (VK_SUCCESS != buildUniformBuffer<UniformBufferObject>(&uniformBuffers[i], &uniformBufferMemories[i])) {
 				throw std::runtime_error("[Vulkan] Failed to create uniform buffer!");
 			}
@@ -814,20 +989,19 @@ namespace vox {
 		}
 
 		for (auto& [id, shader] : shaderManager.getAll()) {
-			auto uniformBufferPtrs = std::vector<VkBuffer*>(3);
-			auto uniformBufferMemoryPtrs = std::vector<VkDeviceMemory*>(3);
+			auto uniformBufferPtrs = std::vector<VkBuffer*>(framesInFlight);
+			auto uniformBufferMemoryPtrs = std::vector<VkDeviceMemory*>(framesInFlight);
 
 			std::ranges::transform(uniformBuffers, uniformBufferPtrs.begin(), [](auto& buffer) { return &buffer; });
 			std::ranges::transform(uniformBufferMemories, uniformBufferMemoryPtrs.begin(), [](auto& memory) { return &memory; });
 
 			shader.bindBuffer(0, uniformBufferPtrs, 0, sizeof(UniformBufferObject), uniformBufferMemoryPtrs, uniformBuffersMapped);
-			shader.bindSampler(1, &textureImageView, &textureSampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
 			auto buildBufferLambda = [&](VkBuffer* buffer, VkDeviceMemory* bufferMemory, VkDeviceSize size) -> VkResult {
 				return buildUniformBuffer(buffer, bufferMemory, size);
 			};
 
-			shader.buildBuffers(buildBufferLambda);
+			shader.buildBuffers(buildBufferLambda, framesInFlight);
 		}
 	}
 
@@ -840,13 +1014,13 @@ namespace vox {
 	}
 
 	void Application::initCommandBuffers() {
-		commandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+		commandBuffers.resize(framesInFlight);
 
 		VkCommandBufferAllocateInfo allocInfo = {};
 		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 		allocInfo.commandPool = commandPool;
 		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-		allocInfo.commandBufferCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
+		allocInfo.commandBufferCount = framesInFlight;
 
 		if (VK_SUCCESS != vkAllocateCommandBuffers(mainLogicalDevice, &allocInfo, commandBuffers.data())) {
 			throw std::runtime_error("[Vulkan] Failed to allocate command buffers!");
@@ -855,31 +1029,45 @@ namespace vox {
 		std::cout << "[Vulkan] Command buffer allocation succeeded!\n" << std::flush;
 	}
 
+	void Application::initTimelines() {
+		if (VK_SUCCESS != graphicsTimeline.build(mainLogicalDevice)) {
+			throw std::runtime_error("[Vulkan] Failed to create graphics timeline semaphore!");
+		}
+
+		std::cout << "[Vulkan] Timeline semaphore creation succeeded.\n" << std::flush;
+	}
+
 	void Application::initSyncObjects() {
-		imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-		renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
+		imageAvailableSemaphores.resize(framesInFlight);
 
-		inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
+		// Each slot waits for the timeline value its last frame signalled; none was submitted yet.
+		frameTimelineValues.assign(framesInFlight, 0);
 
 		VkSemaphoreCreateInfo semaphoreCreateInfo = {};
 		semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-		VkFenceCreateInfo fenceCreateInfo = {};
-		fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-		fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-		for (auto i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-			if (VK_SUCCESS != vkCreateSemaphore(mainLogicalDevice, &semaphoreCreateInfo, nullptr, &imageAvailableSemaphores[i]) ||
-				VK_SUCCESS != vkCreateSemaphore(mainLogicalDevice, &semaphoreCreateInfo, nullptr, &renderFinishedSemaphores[i])) {
+		for (uint32_t i = 0; i < framesInFlight; i++) {
+			if (VK_SUCCESS != vkCreateSemaphore(mainLogicalDevice, &semaphoreCreateInfo, nullptr, &imageAvailableSemaphores[i])) {
 				throw std::runtime_error("[Vulkan] Failed to create semaphore(s)!");
 			}
+		}
+
+		initSwapchainSyncObjects();
+
+		std::cout << "[Vulkan] Semaphore creation succeeded for " << framesInFlight << " frame(s) in flight.\n" << std::flush;
+	}
+
+	void Application::initSwapchainSyncObjects() {
+		renderFinishedSemaphores.resize(swapchainImages.size());
+
+		VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+		semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-			if (VK_SUCCESS != vkCreateFence(mainLogicalDevice, &fenceCreateInfo, nullptr, &inFlightFences[i])) {
-				throw std::runtime_error("[Vulkan] Failed to create fence(s)!");
+		for (auto& semaphore : renderFinishedSemaphores) {
+			if (VK_SUCCESS != vkCreateSemaphore(mainLogicalDevice, &semaphoreCreateInfo, nullptr, &semaphore)) {
+				throw std::runtime_error("[Vulkan] Failed to create semaphore(s)!");
 			}
 		}
-
-		std::cout << "[Vulkan] Semaphore creation succeeded.\n" << std::flush;
 	}
 
 	void Application::uploadModels() {
@@ -888,103 +1076,400 @@ namespace vox {
 		}
 	}
 
-	void Application::updateUniformBuffers(uint32_t currentImage) {
-		static auto startTime = std::chrono::high_resolution_clock::now();
+	void Application::uploadTextureAtlas(const uint32_t atlasId, const VkImageLayout oldLayout) {
+		const auto& atlas = textureManager.getAtlas(atlasId);
 
-		const auto currentTime = std::chrono::high_resolution_clock::now();
-		const auto timeDelta = std::chrono::duration<float>(currentTime - startTime).count();
+		VkBuffer stagingBuffer;
+		VkDeviceMemory stagingBufferMemory;
 
-		handleInput(glfwWindow, timeDelta);
+		if (VK_SUCCESS != buildBuffer(&stagingBuffer, &stagingBufferMemory, atlas.getSize(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+			throw std::runtime_error("[Vulkan] Failed to create atlas staging buffer!");
+		}
 
-		ubo.view = camera.getViewMatrix();
+		void* data;
 
-		const auto aspectRatio = static_cast<float>(swapchainExtent.width) / static_cast<float>(swapchainExtent.height);
+		if (VK_SUCCESS != vkMapMemory(mainLogicalDevice, stagingBufferMemory, 0, atlas.getSize(), 0, &data)) {
+			throw std::runtime_error("[Vulkan] Failed to map atlas staging buffer!");
+		}
 
-		ubo.proj = camera.getProjectionMatrix(aspectRatio);
-		ubo.proj[1][1] *= -1;
+		// Texture rows, and their mip chains, are blitted straight into the staging memory.
+		atlas.blitTextures(textureManager, threadPool, data);
 
-		memcpy(uniformBuffersMapped[currentImage], &ubo, sizeof(ubo));
+		if (enableAtlasDumps) {
+			atlas.dump("atlas_" + std::to_string(atlasId) + ".png", data);
+		}
 
-		for (auto &shader: shaderManager.getAll() | std::views::values) {
-			shader.setUniform("decay", 4.5f);
-			shader.setUniform("colorModulation", glm::vec4(1.0f, 0.3f, 0.3f, 1.0f));
+		vkUnmapMemory(mainLogicalDevice, stagingBufferMemory);
 
-			shader.uploadUniforms(mainLogicalDevice, currentImage);
+		const auto mipLevels = atlas.getMipLevels();
+
+		transitionImageLayout(atlasImages[atlasId], VK_FORMAT_R8G8B8A8_SRGB, oldLayout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels);
+
+		// The atlas mip chain is built per cell on the CPU, as a GPU blit
+		// would filter across cell borders; every level is copied as is.
+		std::vector<VkBufferImageCopy> regions(mipLevels);
+
+		for (uint32_t level = 0; level < mipLevels; ++level) {
+			auto& region = regions[level];
+			region.bufferOffset = atlas.getLevelOffset(level);
+			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.mipLevel = level;
+			region.imageSubresource.baseArrayLayer = 0;
+			region.imageSubresource.layerCount = 1;
+			region.imageExtent = {
+				getMipDimension(atlas.getWidth(), level),
+				getMipDimension(atlas.getHeight(), level),
+				1
+			};
 		}
+
+		copyBufferToImage(stagingBuffer, atlasImages[atlasId], regions);
+
+		transitionImageLayout(atlasImages[atlasId], VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, mipLevels);
+
+		retireBuffer(stagingBuffer, stagingBufferMemory);
 	}
 
-	bool Application::checkValidationLayers() const {
-		uint32_t layerCount = 0;
-		if (VK_SUCCESS != vkEnumerateInstanceLayerProperties(&layerCount, nullptr)) {
-			throw std::runtime_error("[Vulkan] Failed to enumerate instance layer properties!");
+	void Application::updateTextureAtlases() {
+		textureManager.compactAtlases(threadPool, ATLAS_COMPACTION_THRESHOLD);
+
+		// Every cell of a compacted atlas moved, leaving stale texels in what is now free space;
+		// the whole image is uploaded again, so that no filtered or mipmapped sample picks them up.
+		for (const auto atlasId : textureManager.finishCompactions()) {
+			uploadTextureAtlas(atlasId, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+			std::cout << "[Vulkan] Uploaded compacted atlas " << atlasId << " (" << textureManager.getAtlas(atlasId).getSize() / 1024 << " KiB).\n" << std::flush;
 		}
 
-		std::vector<VkLayerProperties> availableLayers(layerCount);
-		if (vkEnumerateInstanceLayerProperties(&layerCount, availableLayers.data())) {
-			throw std::runtime_error("[Vulkan] Failed to enumerate instance layer properties!");
+		// Only cells placed since the last upload are copied, each at its offset in the atlas.
+		for (auto& [atlasId, atlas] : textureManager.getAtlases()) {
+			if (!atlas.hasDirtyTextures()) {
+				continue;
+			}
+
+			const auto dirtySize = atlas.getDirtySize();
+
+			VkBuffer stagingBuffer;
+			VkDeviceMemory stagingBufferMemory;
+
+			if (VK_SUCCESS != buildBuffer(&stagingBuffer, &stagingBufferMemory, dirtySize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+				throw std::runtime_error("[Vulkan] Failed to create atlas staging buffer!");
+			}
+
+			void* data;
+
+			if (VK_SUCCESS != vkMapMemory(mainLogicalDevice, stagingBufferMemory, 0, dirtySize, 0, &data)) {
+				throw std::runtime_error("[Vulkan] Failed to map atlas staging buffer!");
+			}
+
+			const auto atlasRegions = atlas.blitDirtyTextures(textureManager, threadPool, data);
+
+			vkUnmapMemory(mainLogicalDevice, stagingBufferMemory);
+
+			std::vector<VkBufferImageCopy> regions(atlasRegions.size());
+
+			for (size_t i = 0; i < atlasRegions.size(); ++i) {
+				auto& region = regions[i];
+				region.bufferOffset = atlasRegions[i].offset;
+				region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+				region.imageSubresource.mipLevel = atlasRegions[i].level;
+				region.imageSubresource.baseArrayLayer = 0;
+				region.imageSubresource.layerCount = 1;
+				region.imageOffset = {
+					static_cast<int32_t>(atlasRegions[i].x),
+					static_cast<int32_t>(atlasRegions[i].y),
+					0
+				};
+				region.imageExtent = {
+					atlasRegions[i].width,
+					atlasRegions[i].height,
+					1
+				};
+			}
+
+			transitionImageLayout(atlasImages[atlasId], VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, atlas.getMipLevels());
+
+			copyBufferToImage(stagingBuffer, atlasImages[atlasId], regions);
+
+			transitionImageLayout(atlasImages[atlasId], VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, atlas.getMipLevels());
+
+			retireBuffer(stagingBuffer, stagingBufferMemory);
+
+			std::cout << "[Vulkan] Updated atlas " << atlasId << " (" << dirtySize / 1024 << " KiB).\n" << std::flush;
 		}
+	}
 
-		std::vector<std::string> availableLayerNames;
+	void Application::updateTextureResidency() {
+		// The texture is shared by every model, so the largest one on screen decides its level.
+		auto screenSize = 0.0f;
 
-		for (const auto& [layerName, specVersion, implementationVersion, description] : availableLayers) {
-			availableLayerNames.emplace_back(layerName);
-			std::cout << "[Vulkan] Available layer: " << layerName << "\n" << std::flush;
+		for (const auto& bounds : textureModelBounds) {
+			screenSize = std::max(screenSize, getScreenSize(bounds));
 		}
 
-		for (const auto& layerName : validationLayers) {
-			if (std::ranges::find(availableLayerNames, layerName) == availableLayerNames.end()) {
-				std::cout << "[Vulkan] Validation layer verification failed.\n" << std::flush;
-				return false;
+		if (textureSource.has_value()) {
+			textureResidency.requestLevel(textureResidencyId, TextureResidency::getDesiredLevel(textureSource->getWidth(), textureSource->getHeight(), textureSource->getLevelCount(), screenSize));
+		}
+
+		// The atlas copy of the model texture is requested at the same size; the other
+		// atlas textures are not drawn, and give up their levels when room is needed.
+		for (const auto& [textureId, texture] : textureManager.getTextures()) {
+			if (textureManager.getCanonicalId(textureId) == textureId && std::filesystem::path(texture.getPath()) == std::filesystem::path(TEXTURE_PATH)) {
+				textureResidency.requestLevel(textureId | TEXTURE_RESIDENCY_ATLAS_BIT, TextureResidency::getDesiredLevel(texture.getWidth(), texture.getHeight(), getMipLevelCount(texture.getWidth(), texture.getHeight()), screenSize));
 			}
 		}
 
-		std::cout << "[Vulkan] Validation layers successfully verified.\n" << std::flush;
+		swapTextureImages();
 
-		return true;
-	}
+		// Streams whose levels were copied into staging memory are uploaded, and swapped in once that finished.
+		for (auto stream = textureStreams.begin(); stream != textureStreams.end();) {
+			auto& [textureId, textureStream] = *stream;
 
-	void Application::buildDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& createInfo) {
-		createInfo = {};
-		createInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
-		createInfo.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
-		createInfo.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
-		createInfo.pfnUserCallback = debugCallback;
-		createInfo.pUserData = nullptr;
-	}
+			if (textureStream.copy.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				++stream;
+				continue;
+			}
 
-	VkShaderModule Application::buildShaderModule(const std::vector<char>& rawShader) const {
-		VkShaderModuleCreateInfo createInfo = {};
-		createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-		createInfo.codeSize = rawShader.size();
-		createInfo.pCode = reinterpret_cast<const uint32_t*>(rawShader.data());
+			textureStream.copy.get();
 
-		VkShaderModule module;
+			vkUnmapMemory(mainLogicalDevice, textureStream.stagingBufferMemory);
 
-		if (VK_SUCCESS != vkCreateShaderModule(mainLogicalDevice, &createInfo, nullptr, &module)) {
-			throw std::runtime_error("[Vulkna] Failed to create shader module!");
+			replaceTextureImage(textureStream.baseLevel, textureStream.stagingBuffer, true);
+
+			retireBuffer(textureStream.stagingBuffer, textureStream.stagingBufferMemory);
+
+			stream = textureStreams.erase(stream);
 		}
 
-		std::cout << "[Vulkan] Built shader with " << rawShader.size() << " bytes.\n" << std::flush;
+		for (const auto& change : textureResidency.update()) {
+			// Atlas textures are reduced from their pixels on the CPU, so their changes are applied
+			// right away; the cells they move to are uploaded with the next atlas update.
+			if ((change.textureId & TEXTURE_RESIDENCY_ATLAS_BIT) != 0) {
+				const auto textureId = change.textureId & ~TEXTURE_RESIDENCY_ATLAS_BIT;
+				const auto placed = textureManager.setBaseLevel(textureId, change.toLevel);
 
-		return module;
-	}
+				if (change.isEviction()) {
+					if (!placed) {
+						throw std::runtime_error("[Vulkan] Failed to shrink the atlas cell of texture " + std::to_string(textureId) + "!");
+					}
 
-	VkPipelineShaderStageCreateInfo Application::buildPipelineShaderStageCreateInfo(const VkShaderModule shaderModule, const VkShaderStageFlagBits stage) {
-		VkPipelineShaderStageCreateInfo info{};
-		info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-		info.stage = stage;
-		info.module = shaderModule;
-		info.pName = "main";
-		return info;
-	}
+					std::cout << "[Vulkan] Evicted atlas texture " << textureId << " down to level " << change.toLevel << ".\n" << std::flush;
+				} else if (placed) {
+					textureResidency.finishStream(change.textureId);
 
-	VkPipelineViewportStateCreateInfo Application::buildPipelineViewportStateCreateInfo(const VkViewport* viewport, const VkRect2D* scissor) {
-	    VkPipelineViewportStateCreateInfo info{};
+					std::cout << "[Vulkan] Streamed atlas texture " << textureId << " in from level " << change.toLevel << ".\n" << std::flush;
+				} else {
+					textureResidency.cancelStream(change.textureId);
+
+					std::cout << "[Vulkan] No atlas has room for texture " << textureId << " at level " << change.toLevel << ", keeping level " << change.fromLevel << ".\n" << std::flush;
+				}
+
+				continue;
+			}
+
+			const auto dataSize = textureSource->getDataSize(change.toLevel);
+
+			VkBuffer stagingBuffer;
+			VkDeviceMemory stagingBufferMemory;
+
+			if (VK_SUCCESS != buildBuffer(&stagingBuffer, &stagingBufferMemory, dataSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+				throw std::runtime_error("[Vulkan] Failed to create texture staging buffer!");
+			}
+
+			void* data;
+
+			if (VK_SUCCESS != vkMapMemory(mainLogicalDevice, stagingBufferMemory, 0, dataSize, 0, &data)) {
+				throw std::runtime_error("[Vulkan] Failed to map texture staging buffer!");
+			}
+
+			// Evictions only keep the smaller levels, and are uploaded right away.
+			if (change.isEviction()) {
+				textureSource->copyLevels(change.toLevel, static_cast<uint8_t*>(data));
+
+				vkUnmapMemory(mainLogicalDevice, stagingBufferMemory);
+
+				replaceTextureImage(change.toLevel, stagingBuffer, false);
+
+				retireBuffer(stagingBuffer, stagingBufferMemory);
+
+				std::cout << "[Vulkan] Evicted texture " << change.textureId << " down to level " << change.toLevel << ".\n" << std::flush;
+
+				continue;
+			}
+
+			// Sharper levels are copied on a worker, and uploaded on a later frame once ready.
+			auto copy = threadPool.submit([this, baseLevel = change.toLevel, data] {
+				textureSource->copyLevels(baseLevel, static_cast<uint8_t*>(data));
+			});
+
+			textureStreams.insert_or_assign(change.textureId, TextureStream { change.toLevel, stagingBuffer, stagingBufferMemory, std::move(copy) });
+		}
+	}
+
+	void Application::updateShaders() {
+		for (const auto& file : shaderWatcher.poll()) {
+			for (const auto& id : shaderManager.getDependents(file)) {
+				// A rebuild already running would miss this edit, so it is queued behind it.
+				if (const auto shaderReload = shaderReloads.find(id); shaderReload != shaderReloads.end()) {
+					shaderReload->second.pending = true;
+				} else {
+					submitShaderReload(id);
+				}
+			}
+		}
+
+		// Rebuilt pipelines are swapped in between frames; frames still in flight keep using the old ones.
+		for (auto reload = shaderReloads.begin(); reload != shaderReloads.end();) {
+			auto& [id, shaderReload] = *reload;
+
+			if (shaderReload.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				++reload;
+				continue;
+			}
+
+			try {
+				const auto reloaded = shaderReload.result.get();
+
+				// Variants were built from the old code, and are rebuilt from the new one when next drawn.
+				graphicsTimeline.defer([device = mainLogicalDevice, pipelineLayout = pipelineLayouts[id], pipeline = pipelines[id], variants = pipelineVariants[id]] {
+					for (const auto& variant : variants | std::views::values) {
+						vkDestroyPipeline(device, variant, nullptr);
+					}
+
+					vkDestroyPipeline(device, pipeline, nullptr);
+					vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+				});
+
+				pipelineVariants.erase(id);
+
+				pipelineLayouts[id] = reloaded.pipelineLayout;
+				pipelines[id] = reloaded.pipeline;
+
+				auto& shader = shaderManager.get(id);
+				shader.setMetadata(reloaded.metadata);
+				shader.setVertexShaderCode(reloaded.vertexShaderCode);
+				shader.setFragmentShaderCode(reloaded.fragmentShaderCode);
+
+				std::cout << "[Vulkan] Reloaded shader: " << id << "\n" << std::flush;
+			} catch (const std::exception& exception) {
+				std::cerr << "[Vulkan] Failed to reload shader " << id << ", keeping the previous pipeline: " << exception.what() << "\n" << std::flush;
+			}
+
+			if (shaderReload.pending) {
+				submitShaderReload(id);
+				++reload;
+			} else {
+				reload = shaderReloads.erase(reload);
+			}
+		}
+	}
+
+	void Application::updateUniformBuffers(uint32_t currentImage) {
+		static auto startTime = std::chrono::high_resolution_clock::now();
+
+		const auto currentTime = std::chrono::high_resolution_clock::now();
+		const auto timeDelta = std::chrono::duration<float>(currentTime - startTime).count();
+
+		handleInput(glfwWindow, timeDelta);
+
+		ubo.view = camera.getViewMatrix();
+
+		const auto aspectRatio = static_cast<float>(swapchainExtent.width) / static_cast<float>(swapchainExtent.height);
+
+		ubo.proj = camera.getProjectionMatrix(aspectRatio);
+		ubo.proj[1][1] *= -1;
+
+		memcpy(uniformBuffersMapped[currentImage], &ubo, sizeof(ubo));
+
+		for (auto &shader: shaderManager.getAll() | std::views::values) {
+			shader.setUniform("decay", 4.5f);
+
+			shader.uploadUniforms(mainLogicalDevice, currentImage);
+		}
+	}
+
+	bool Application::checkValidationLayers() const {
+		uint32_t layerCount = 0;
+		if (VK_SUCCESS != vkEnumerateInstanceLayerProperties(&layerCount, nullptr)) {
+			throw std::runtime_error("[Vulkan] Failed to enumerate instance layer properties!");
+		}
+
+		std::vector<VkLayerProperties> availableLayers(layerCount);
+		if (vkEnumerateInstanceLayerProperties(&layerCount, availableLayers.data())) {
+			throw std::runtime_error("[Vulkan] Failed to enumerate instance layer properties!");
+		}
+
+		std::vector<std::string> availableLayerNames;
+
+		for (const auto& [layerName, specVersion, implementationVersion, description] : availableLayers) {
+			availableLayerNames.emplace_back(layerName);
+			std::cout << "[Vulkan] Available layer: " << layerName << "\n" << std::flush;
+		}
+
+		for (const auto& layerName : validationLayers) {
+			if (std::ranges::find(availableLayerNames, layerName) == availableLayerNames.end()) {
+				std::cout << "[Vulkan] Validation layer verification failed.\n" << std::flush;
+				return false;
+			}
+		}
+
+		std::cout << "[Vulkan] Validation layers successfully verified.\n" << std::flush;
+
+		return true;
+	}
+
+	void Application::buildDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& createInfo) {
+		createInfo = {};
+		createInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
+		createInfo.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+		createInfo.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
+		createInfo.pfnUserCallback = debugCallback;
+		createInfo.pUserData = nullptr;
+	}
+
+	VkShaderModule Application::buildShaderModule(const std::vector<char>& rawShader) const {
+		VkShaderModuleCreateInfo createInfo = {};
+		createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		createInfo.codeSize = rawShader.size();
+		createInfo.pCode = reinterpret_cast<const uint32_t*>(rawShader.data());
+
+		VkShaderModule module;
+
+		if (VK_SUCCESS != vkCreateShaderModule(mainLogicalDevice, &createInfo, nullptr, &module)) {
+			throw std::runtime_error("[Vulkna] Failed to create shader module!");
+		}
+
+		std::cout << "[Vulkan] Built shader with " << rawShader.size() << " bytes.\n" << std::flush;
+
+		return module;
+	}
+
+	VkPipelineShaderStageCreateInfo Application::buildPipelineShaderStageCreateInfo(const VkShaderModule shaderModule, const VkShaderStageFlagBits stage, const VkSpecializationInfo* specializationInfo) {
+		VkPipelineShaderStageCreateInfo info{};
+		info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		info.stage = stage;
+		info.module = shaderModule;
+		info.pName = "main";
+		info.pSpecializationInfo = specializationInfo;
+		return info;
+	}
+
+	VkPipelineViewportStateCreateInfo Application::buildPipelineViewportStateCreateInfo() {
+	    // Viewport and scissor are dynamic, only their counts are baked.
+	    VkPipelineViewportStateCreateInfo info{};
 	    info.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
 	    info.viewportCount = 1;
-	    info.pViewports = viewport;
+	    info.pViewports = nullptr;
 	    info.scissorCount = 1;
-	    info.pScissors = scissor;
+	    info.pScissors = nullptr;
+	    return info;
+	}
+
+	VkPipelineDynamicStateCreateInfo Application::buildPipelineDynamicStateCreateInfo(const std::span<const VkDynamicState> dynamicStates) {
+	    VkPipelineDynamicStateCreateInfo info{};
+	    info.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	    info.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+	    info.pDynamicStates = dynamicStates.data();
 	    return info;
 	}
 
@@ -1100,14 +1585,14 @@ namespace vox {
 		return VK_SUCCESS;
 	}
 
-	VkResult Application::buildImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usageFlags, VkMemoryPropertyFlags propertyFlags, VkImage& image, VkDeviceMemory& imageMemory) {
+	VkResult Application::buildImage(uint32_t width, uint32_t height, uint32_t mipLevels, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usageFlags, VkMemoryPropertyFlags propertyFlags, VkImage& image, VkDeviceMemory& imageMemory) {
 		VkImageCreateInfo createInfo = {};
 		createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 		createInfo.imageType = VK_IMAGE_TYPE_2D;
 		createInfo.extent.width = width;
 		createInfo.extent.height = height;
 		createInfo.extent.depth = 1;
-		createInfo.mipLevels = 1;
+		createInfo.mipLevels = mipLevels;
 		createInfo.arrayLayers = 1;
 		createInfo.format = format;
 		createInfo.tiling = tiling;
@@ -1146,7 +1631,7 @@ namespace vox {
 		return VK_SUCCESS;
 	}
 
-	VkResult Application::buildImageView(VkImage image, VkFormat format, VkImageAspectFlags imageAspectFlags, VkImageView& imageView) {
+	VkResult Application::buildImageView(VkImage image, VkFormat format, VkImageAspectFlags imageAspectFlags, VkImageView& imageView, const uint32_t mipLevels) {
 		VkImageViewCreateInfo createInfo = {};
 		createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
 		createInfo.image = image;
@@ -1154,24 +1639,101 @@ namespace vox {
 		createInfo.format = format;
 		createInfo.subresourceRange.aspectMask = imageAspectFlags;
 		createInfo.subresourceRange.baseMipLevel = 0;
-		createInfo.subresourceRange.levelCount = 1;
+		createInfo.subresourceRange.levelCount = mipLevels;
 		createInfo.subresourceRange.baseArrayLayer = 0;
 		createInfo.subresourceRange.layerCount = 1;
 
-		return vkCreateImageView(mainLogicalDevice, &createInfo, nullptr, &imageView);
+		return imageViewCache.get(mainLogicalDevice, createInfo, imageView);
 	}
 
-	VkResult Application::buildTextureImage(const std::string& imagePath, VkImage& textureImage, VkDeviceMemory& textureImageMemory) {
+	void Application::releaseImageViews(VkImage image) {
+		// A later view may be given the handle of one destroyed here, so no cached set may still point at it.
+		for (const auto imageView : imageViewCache.getViews(image)) {
+			descriptorAllocator.evict(imageView);
+		}
+
+		imageViewCache.release(mainLogicalDevice, image);
+	}
+
+	VkResult Application::buildTextureImage(const std::string& imagePath, VkImage& textureImage, VkDeviceMemory& textureImageMemory, VkFormat& format, uint32_t& mipLevels, std::optional<TextureKtx2>& source) {
+	    const MappedFile sourceFile(imagePath);
+	    const auto sourceBytes = sourceFile.getBytes();
+
+	    // Baked mip chains are cached by source content, and rebaked whenever it changes.
+	    const auto sourceHash = TextureCache::hashSource(sourceBytes);
+
+	    std::optional<TextureKtx2> bakedTexture = std::nullopt;
+
+	    if (textureCompressionEnabled) {
+	    	bakedTexture = textureManager.getCache().find(sourceHash, "bc");
+	    }
+
 	    int textureWidth;
 		int textureHeight;
 		int textureChannels;
 
-	    stbi_uc* pixels = stbi_load(imagePath.c_str(), &textureWidth, &textureHeight, &textureChannels, STBI_rgb_alpha);
+	    stbi_uc* pixels = nullptr;
+
+	    if (!bakedTexture.has_value()) {
+	    	pixels = stbi_load_from_memory(sourceBytes.data(), static_cast<int>(sourceBytes.size()), &textureWidth, &textureHeight, &textureChannels, STBI_rgb_alpha);
+
+	    	if (!pixels) {
+	    		throw std::runtime_error("[STB] Failed to load texture image!");
+	    	}
+	    }
+
+	    if (textureCompressionEnabled && !bakedTexture.has_value()) {
+	    	const auto startTime = std::chrono::high_resolution_clock::now();
+
+	    	const std::span<const uint8_t> pixelSpan(pixels, static_cast<size_t>(textureWidth) * textureHeight * 4);
+
+	    	// Opaque textures get the smaller BC1, anything with alpha the higher quality BC7.
+	    	const auto blockFormat = isOpaque(pixelSpan) ? TextureBlockFormat::BC1 : TextureBlockFormat::BC7;
+
+	    	bakedTexture = TextureKtx2::bake(threadPool, pixelSpan, textureWidth, textureHeight, blockFormat);
+
+	    	// The bake is still used when it can't be cached.
+	    	try {
+	    		textureManager.getCache().store(sourceHash, "bc", bakedTexture.value());
+	    	} catch (const std::runtime_error& error) {
+	    		std::cerr << "[Cache] Failed to store baked texture " << imagePath << ": " << error.what() << "\n" << std::flush;
+	    	}
+
+	    	const auto bakeTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+	    	std::cout << "[KTX2] Baked " << imagePath << " in " << bakeTime << "ms.\n" << std::flush;
+	    }
+
+	    // Formats are optional even with textureCompressionBC; fall back to RGBA8 when missing.
+	    if (bakedTexture.has_value() && hasFormatSupport(bakedTexture->getVkFormat(), VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT)) {
+	    	if (pixels) {
+	    		stbi_image_free(pixels);
+	    	}
+
+	    	format = bakedTexture->getVkFormat();
+	    	mipLevels = bakedTexture->getLevelCount();
+
+	    	if (const auto result = buildCompressedTextureImage(bakedTexture.value(), 0, textureImage, textureImageMemory);
+	    		result != VK_SUCCESS) {
+	    		return result;
+	    	}
+
+	    	// Kept, so that levels dropped under the residency budget can be streamed back in.
+	    	source = std::move(bakedTexture);
+
+	    	return VK_SUCCESS;
+	    }
 
 	    if (!pixels) {
-	        throw std::runtime_error("[STB] Failed to load texture image!");
+	    	pixels = stbi_load_from_memory(sourceBytes.data(), static_cast<int>(sourceBytes.size()), &textureWidth, &textureHeight, &textureChannels, STBI_rgb_alpha);
+
+	    	if (!pixels) {
+	    		throw std::runtime_error("[STB] Failed to load texture image!");
+	    	}
 	    }
 
+	    format = VK_FORMAT_R8G8B8A8_SRGB;
+
 	    const VkDeviceSize imageSize = textureWidth * textureHeight * 4; // Assuming 4 bytes per pixel (RGBA).
 
 	    VkBuffer stagingBuffer;
@@ -1194,32 +1756,156 @@ namespace vox {
 
 	    stbi_image_free(pixels);
 
-	    if (const auto result = buildImage(textureWidth, textureHeight, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, textureImageMemory);
+	    mipLevels = getMipLevelCount(textureWidth, textureHeight);
+
+	    if (const auto result = buildImage(textureWidth, textureHeight, mipLevels, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, textureImageMemory);
 	    	result != VK_SUCCESS) {
 		    return result;
 	    }
 
-	    transitionImageLayout(textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+	    transitionImageLayout(textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels);
+
+	    copyBufferToImage(stagingBuffer, textureImage, static_cast<uint32_t>(textureWidth), static_cast<uint32_t>(textureHeight));
+
+	    // Leaves every level in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL.
+	    generateMipmaps(textureImage, VK_FORMAT_R8G8B8A8_SRGB, textureWidth, textureHeight, mipLevels);
+
+	    retireBuffer(stagingBuffer, stagingBufferMemory);
 
-		if (const auto result = copyBufferToImage(stagingBuffer, textureImage, static_cast<uint32_t>(textureWidth), static_cast<uint32_t>(textureHeight));
+	    return VK_SUCCESS;
+	}
+
+	VkResult Application::buildCompressedTextureImage(const TextureKtx2& texture, const uint32_t baseLevel, VkImage& textureImage, VkDeviceMemory& textureImageMemory) {
+		const auto dataSize = texture.getDataSize(baseLevel);
+
+		VkBuffer stagingBuffer;
+		VkDeviceMemory stagingBufferMemory;
+
+		if (const auto result = buildBuffer(&stagingBuffer, &stagingBufferMemory, dataSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+			result != VK_SUCCESS) {
+			return result;
+		}
+
+		void* mappedData;
+
+		if (const auto result = vkMapMemory(mainLogicalDevice, stagingBufferMemory, 0, dataSize, 0, &mappedData);
 			result != VK_SUCCESS) {
 			return result;
 		}
 
-	    transitionImageLayout(textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		// Levels are copied straight out of the mapped file, tightly packed.
+		texture.copyLevels(baseLevel, static_cast<uint8_t*>(mappedData));
 
-	    vkDestroyBuffer(mainLogicalDevice, stagingBuffer, nullptr);
-	    vkFreeMemory(mainLogicalDevice, stagingBufferMemory, nullptr);
+		vkUnmapMemory(mainLogicalDevice, stagingBufferMemory);
 
-	    return VK_SUCCESS;
+		if (const auto result = uploadCompressedTextureImage(texture, baseLevel, stagingBuffer, textureImage, textureImageMemory);
+			result != VK_SUCCESS) {
+			return result;
+		}
+
+		retireBuffer(stagingBuffer, stagingBufferMemory);
+
+		std::cout << "[Vulkan] Uploaded " << dataSize / 1024 << " KiB of compressed texture data, against " << static_cast<size_t>(getMipDimension(texture.getWidth(), baseLevel)) * getMipDimension(texture.getHeight(), baseLevel) * 4 * 4 / 3 / 1024 << " KiB as RGBA8.\n" << std::flush;
+
+		return VK_SUCCESS;
+	}
+
+	VkResult Application::uploadCompressedTextureImage(const TextureKtx2& texture, const uint32_t baseLevel, VkBuffer stagingBuffer, VkImage& textureImage, VkDeviceMemory& textureImageMemory) {
+		const auto mipLevels = texture.getLevelCount() - baseLevel;
+
+		if (const auto result = buildImage(getMipDimension(texture.getWidth(), baseLevel), getMipDimension(texture.getHeight(), baseLevel), mipLevels, texture.getVkFormat(), VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, textureImageMemory);
+			result != VK_SUCCESS) {
+			return result;
+		}
+
+		transitionImageLayout(textureImage, texture.getVkFormat(), VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels);
+
+		// Compressed levels are copied as they are; image extents may be smaller than a block.
+		// Level baseLevel of the source is level 0 of the image.
+		std::vector<VkBufferImageCopy> regions(mipLevels);
+
+		VkDeviceSize offset = 0;
+
+		for (uint32_t level = 0; level < mipLevels; ++level) {
+			auto& region = regions[level];
+			region.bufferOffset = offset;
+			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.mipLevel = level;
+			region.imageSubresource.baseArrayLayer = 0;
+			region.imageSubresource.layerCount = 1;
+			region.imageExtent = {
+				getMipDimension(texture.getWidth(), baseLevel + level),
+				getMipDimension(texture.getHeight(), baseLevel + level),
+				1
+			};
+
+			offset += texture.getLevelSize(baseLevel + level);
+		}
+
+		copyBufferToImage(stagingBuffer, textureImage, regions);
+
+		transitionImageLayout(textureImage, texture.getVkFormat(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, mipLevels);
+
+		return VK_SUCCESS;
+	}
+
+	void Application::replaceTextureImage(const uint32_t baseLevel, VkBuffer stagingBuffer, const bool isStream) {
+		const auto mipLevels = textureSource->getLevelCount() - baseLevel;
+
+		VkImage image;
+		VkDeviceMemory imageMemory;
+		VkImageView imageView;
+
+		if (VK_SUCCESS != uploadCompressedTextureImage(textureSource.value(), baseLevel, stagingBuffer, image, imageMemory)) {
+			throw std::runtime_error("[Vulkan] Failed to create texture image!");
+		}
+
+		if (VK_SUCCESS != buildImageView(image, textureFormat, VK_IMAGE_ASPECT_COLOR_BIT, imageView, mipLevels)) {
+			throw std::runtime_error("[Vulkan] Failed to create texture image view!");
+		}
+
+		// The upload ends with its last submission.
+		textureSwaps.push_back({ baseLevel, image, imageMemory, imageView, mipLevels, graphicsTimeline.getSubmitted(), isStream });
+	}
+
+	void Application::swapTextureImages() {
+		// Uploads finish in the order they were submitted, so the first swap not ready holds back the rest.
+		while (!textureSwaps.empty() && graphicsTimeline.isCompleted(mainLogicalDevice, textureSwaps.front().timelineValue)) {
+			const auto swap = textureSwaps.front();
+			textureSwaps.pop_front();
+
+			// Frames in flight may still read the old slot, so the new image gets its own,
+			// and the old slot and image go once they finished.
+			const auto index = textureTable.add(mainLogicalDevice, swap.imageView, textureSampler);
+
+			graphicsTimeline.defer([this, index = textureTableIndex, image = textureImage, imageMemory = textureImageMemory] {
+				textureTable.remove(index);
+
+				releaseImageViews(image);
+				vkDestroyImage(mainLogicalDevice, image, nullptr);
+				vkFreeMemory(mainLogicalDevice, imageMemory, nullptr);
+			});
+
+			textureImage = swap.image;
+			textureImageMemory = swap.imageMemory;
+			textureImageView = swap.imageView;
+			textureMipLevels = swap.mipLevels;
+			textureTableIndex = index;
+
+			if (swap.isStream) {
+				textureResidency.finishStream(textureResidencyId);
+
+				std::cout << "[Vulkan] Streamed texture " << textureResidencyId << " in from level " << swap.baseLevel << ".\n" << std::flush;
+			}
+		}
 	}
 
 	VkResult Application::buildUniformBuffer(VkBuffer*buffer, VkDeviceMemory*bufferMemory, const VkDeviceSize size) {
 		return buildBuffer(buffer, bufferMemory, size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 	}
 
-	void Application::copyBuffer(VkBuffer srcBuffer, VkBuffer destBuffer, VkDeviceSize bufferSize) {
-		executeImmediateCommand([&](const auto& commandBuffer) {
+	uint64_t Application::copyBuffer(VkBuffer srcBuffer, VkBuffer destBuffer, VkDeviceSize bufferSize) {
+		return executeImmediateCommand([&](const auto& commandBuffer) {
 			VkBufferCopy bufferCopy = {};
 			bufferCopy.srcOffset = 0;
 			bufferCopy.dstOffset = 0;
@@ -1229,8 +1915,8 @@ namespace vox {
 		});
 	}
 
-	VkResult Application::copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height) {
-		executeImmediateCommand([&](const auto& commandBuffer) {
+	uint64_t Application::copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height) {
+		return executeImmediateCommand([&](const auto& commandBuffer) {
 			VkBufferImageCopy bufferImageCopy = {};
 			bufferImageCopy.bufferOffset = 0;
 			bufferImageCopy.bufferRowLength = 0;
@@ -1255,8 +1941,83 @@ namespace vox {
 				&bufferImageCopy
 			);
 		});
+	}
 
-		return VK_SUCCESS;
+	uint64_t Application::copyBufferToImage(VkBuffer buffer, VkImage image, const std::vector<VkBufferImageCopy>& regions) {
+		return executeImmediateCommand([&](const auto& commandBuffer) {
+			vkCmdCopyBufferToImage(
+				commandBuffer,
+				buffer,
+				image,
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				static_cast<uint32_t>(regions.size()),
+				regions.data()
+			);
+		});
+	}
+
+	uint64_t Application::generateMipmaps(VkImage image, VkFormat format, const uint32_t width, const uint32_t height, const uint32_t mipLevels) {
+		VkFormatProperties formatProperties;
+		vkGetPhysicalDeviceFormatProperties(mainPhysicalDevice, format, &formatProperties);
+
+		if (!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)) {
+			throw std::runtime_error("[Vulkan] Texture image format does not support linear blitting!");
+		}
+
+		return executeImmediateCommand([&](const auto& commandBuffer) {
+			VkImageMemoryBarrier barrier = {};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.image = image;
+			barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			barrier.subresourceRange.levelCount = 1;
+			barrier.subresourceRange.baseArrayLayer = 0;
+			barrier.subresourceRange.layerCount = 1;
+
+			// Every level is blitted from the one before it, which is then
+			// done being written to and can move to its final layout.
+			for (uint32_t level = 1; level < mipLevels; ++level) {
+				barrier.subresourceRange.baseMipLevel = level - 1;
+				barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+				barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+				barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+				barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+				vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+				VkImageBlit blit = {};
+				blit.srcOffsets[0] = { 0, 0, 0 };
+				blit.srcOffsets[1] = { static_cast<int32_t>(getMipDimension(width, level - 1)), static_cast<int32_t>(getMipDimension(height, level - 1)), 1 };
+				blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+				blit.srcSubresource.mipLevel = level - 1;
+				blit.srcSubresource.baseArrayLayer = 0;
+				blit.srcSubresource.layerCount = 1;
+				blit.dstOffsets[0] = { 0, 0, 0 };
+				blit.dstOffsets[1] = { static_cast<int32_t>(getMipDimension(width, level)), static_cast<int32_t>(getMipDimension(height, level)), 1 };
+				blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+				blit.dstSubresource.mipLevel = level;
+				blit.dstSubresource.baseArrayLayer = 0;
+				blit.dstSubresource.layerCount = 1;
+
+				vkCmdBlitImage(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+				barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+				barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+				barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+				barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+				vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+			}
+
+			barrier.subresourceRange.baseMipLevel = mipLevels - 1;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+		});
 	}
 
 	VkResult Application::buildSampler(
@@ -1271,7 +2032,7 @@ namespace vox {
 		const VkSamplerMipmapMode mipmapMode,
 		const float mipLodBias,
 		const float minLod,
-		const float maxLod) const {
+		const float maxLod) {
 		VkSamplerCreateInfo samplerInfo = {};
 		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
 		samplerInfo.magFilter = magFilter;
@@ -1290,14 +2051,12 @@ namespace vox {
 		samplerInfo.minLod = minLod;
 		samplerInfo.maxLod = maxLod;
 
-		VkPhysicalDeviceProperties properties = {};
-		vkGetPhysicalDeviceProperties(mainPhysicalDevice, &properties);
-
-		if (samplerInfo.maxAnisotropy > properties.limits.maxSamplerAnisotropy) {
-			samplerInfo.maxAnisotropy = properties.limits.maxSamplerAnisotropy;
+		// Clamped before the lookup, so that requests above the limit share one sampler.
+		if (samplerInfo.maxAnisotropy > mainPhysicalDeviceProperties.limits.maxSamplerAnisotropy) {
+			samplerInfo.maxAnisotropy = mainPhysicalDeviceProperties.limits.maxSamplerAnisotropy;
 		}
 
-		return vkCreateSampler(mainLogicalDevice, &samplerInfo, nullptr, sampler);
+		return samplerCache.get(mainLogicalDevice, samplerInfo, *sampler);
 	}
 
 	VkResult Application::buildCommandPool(VkCommandPool*pool, const uint32_t queueFamilyIndex, const VkCommandPoolCreateFlags flags) const {
@@ -1314,24 +2073,6 @@ namespace vox {
 		return VK_SUCCESS;
 	}
 
-	VkResult Application::buildFramebuffer(VkFramebuffer *framebuffer, VkRenderPass renderPass, const std::vector<VkImageView> &attachments, const uint32_t width, const uint32_t height, const uint32_t layers) const {
-		VkFramebufferCreateInfo framebufferCreateInfo = {};
-		framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-		framebufferCreateInfo.renderPass = renderPass;
-		framebufferCreateInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-		framebufferCreateInfo.pAttachments = attachments.data();
-		framebufferCreateInfo.width = width;
-		framebufferCreateInfo.height = height;
-		framebufferCreateInfo.layers = layers;
-
-		if (const auto result = vkCreateFramebuffer(mainLogicalDevice, &framebufferCreateInfo, nullptr, framebuffer);
-			result != VK_SUCCESS) {
-			return result;
-		}
-
-		return VK_SUCCESS;
-	}
-
 	VkSurfaceFormatKHR Application::selectSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& surfaceFormats) {
 		if (const auto it = std::ranges::find_if(surfaceFormats, [](const auto& surfaceFormat) {
 			return surfaceFormat.format == VK_FORMAT_B8G8R8A8_SRGB && surfaceFormat.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
@@ -1477,7 +2218,45 @@ namespace vox {
 		VkPhysicalDeviceFeatures supportedFeatures = {};
 		vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
 
-		return getQueueFamilies(physicalDevice).areValid() && hasExtensionSupport(physicalDevice) && getSwapChainSupport(physicalDevice).isValid() && hasSamplerAnisotropySupport(supportedFeatures);
+		return getQueueFamilies(physicalDevice).areValid() && hasExtensionSupport(physicalDevice) && getSwapChainSupport(physicalDevice).isValid() && hasSamplerAnisotropySupport(supportedFeatures) && hasDescriptorIndexingSupport(physicalDevice) && hasTimelineSemaphoreSupport(physicalDevice);
+	}
+
+	bool Application::hasTimelineSemaphoreSupport(VkPhysicalDevice physicalDevice) {
+		VkPhysicalDeviceProperties properties = {};
+		vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+		// Timeline semaphores are core since Vulkan 1.2, which the instance asks for.
+		if (properties.apiVersion < VK_API_VERSION_1_2) {
+			return false;
+		}
+
+		VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphoreFeatures = {};
+		timelineSemaphoreFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+
+		VkPhysicalDeviceFeatures2 features = {};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features.pNext = &timelineSemaphoreFeatures;
+
+		vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+		return timelineSemaphoreFeatures.timelineSemaphore;
+	}
+
+	bool Application::hasDescriptorIndexingSupport(VkPhysicalDevice physicalDevice) {
+		VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures = {};
+		descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+		VkPhysicalDeviceFeatures2 features = {};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features.pNext = &descriptorIndexingFeatures;
+
+		vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+		return descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing
+		    && descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind
+		    && descriptorIndexingFeatures.descriptorBindingPartiallyBound
+		    && descriptorIndexingFeatures.descriptorBindingVariableDescriptorCount
+		    && descriptorIndexingFeatures.runtimeDescriptorArray;
 	}
 
 	uint32_t Application::getMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags memoryPropertyFlags) {
@@ -1494,6 +2273,123 @@ namespace vox {
 		throw std::runtime_error("[Vulkan] Failed to find suitable memory type!");
 	}
 
+	uint32_t Application::getTextureTableCapacity() {
+		VkPhysicalDeviceDescriptorIndexingPropertiesEXT descriptorIndexingProperties = {};
+		descriptorIndexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+
+		VkPhysicalDeviceProperties2 properties = {};
+		properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		properties.pNext = &descriptorIndexingProperties;
+
+		vkGetPhysicalDeviceProperties2(mainPhysicalDevice, &properties);
+
+		return std::min({
+			TEXTURE_TABLE_CAPACITY,
+			descriptorIndexingProperties.maxDescriptorSetUpdateAfterBindSampledImages,
+			descriptorIndexingProperties.maxDescriptorSetUpdateAfterBindSamplers,
+			descriptorIndexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+			descriptorIndexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers
+		});
+	}
+
+	uint32_t Application::getPipelineThreadCount() const {
+		const auto poolThreadCount = threadPool.getThreadCount();
+
+		// VOX_PIPELINE_THREADS caps the workers building pipelines, to measure how startup scales.
+		const auto* threadCountVariable = std::getenv("VOX_PIPELINE_THREADS");
+
+		if (threadCountVariable == nullptr) {
+			return poolThreadCount;
+		}
+
+		const auto threadCount = std::strtoul(threadCountVariable, nullptr, 10);
+
+		return threadCount == 0 ? poolThreadCount : std::min(static_cast<uint32_t>(threadCount), poolThreadCount);
+	}
+
+	uint32_t Application::getPipelineCopyCount() {
+		// VOX_PIPELINE_COPIES builds every pipeline that many times, so that the few shaders there are keep every worker busy.
+		const auto* copyCountVariable = std::getenv("VOX_PIPELINE_COPIES");
+
+		if (copyCountVariable == nullptr) {
+			return 1;
+		}
+
+		const auto copyCount = std::strtoul(copyCountVariable, nullptr, 10);
+
+		return static_cast<uint32_t>(std::clamp<unsigned long>(copyCount, 1, MAX_PIPELINE_COPIES));
+	}
+
+	uint32_t Application::getRecordThreadCount() const {
+		const auto poolThreadCount = threadPool.getThreadCount();
+
+		// VOX_RECORD_THREADS caps the workers recording draws, to measure how recording scales.
+		const auto* threadCountVariable = std::getenv("VOX_RECORD_THREADS");
+
+		if (threadCountVariable == nullptr) {
+			return poolThreadCount;
+		}
+
+		const auto threadCount = std::strtoul(threadCountVariable, nullptr, 10);
+
+		return threadCount == 0 ? poolThreadCount : std::min(static_cast<uint32_t>(threadCount), poolThreadCount);
+	}
+
+	uint32_t Application::getFramesInFlight() {
+		// VOX_FRAMES_IN_FLIGHT sets how far the CPU may run ahead, e.g. 1 to measure it against a serialized loop.
+		const auto* framesInFlightVariable = std::getenv("VOX_FRAMES_IN_FLIGHT");
+
+		if (framesInFlightVariable == nullptr) {
+			return DEFAULT_FRAMES_IN_FLIGHT;
+		}
+
+		const auto requestedFrames = std::strtoul(framesInFlightVariable, nullptr, 10);
+
+		return requestedFrames == 0 ? DEFAULT_FRAMES_IN_FLIGHT : std::min(static_cast<uint32_t>(requestedFrames), MAX_FRAMES_IN_FLIGHT);
+	}
+
+	uint32_t Application::getDrawCount() {
+		// VOX_DRAW_COUNT draws the scene that many times, so that recording has enough draws to spread over the workers.
+		const auto* drawCountVariable = std::getenv("VOX_DRAW_COUNT");
+
+		if (drawCountVariable == nullptr) {
+			return 1;
+		}
+
+		const auto drawCount = std::strtoul(drawCountVariable, nullptr, 10);
+
+		return static_cast<uint32_t>(std::clamp<unsigned long>(drawCount, 1, MAX_DRAW_COUNT));
+	}
+
+	uint32_t Application::getBenchmarkFrameCount() {
+		// VOX_BENCHMARK_FRAMES closes the window after that many measured frames, and logs the results as a single line.
+		const auto* frameCountVariable = std::getenv("VOX_BENCHMARK_FRAMES");
+
+		if (frameCountVariable == nullptr) {
+			return 0;
+		}
+
+		const auto frameCount = std::strtoul(frameCountVariable, nullptr, 10);
+
+		return static_cast<uint32_t>(std::min<unsigned long>(frameCount, MAX_BENCHMARK_FRAMES));
+	}
+
+	float Application::getScreenSize(const MeshBounds& bounds) const {
+		// The model matrix only rotates, so the bounding sphere keeps its radius.
+		const auto center = glm::vec3(ubo.model * glm::vec4((bounds.min + bounds.max) * 0.5f, 1.0f));
+		const auto radius = glm::length(bounds.max - bounds.min) * 0.5f;
+
+		const auto distance = glm::length(center - camera.getPosition());
+
+		// From inside its bounding sphere, a model may cover the whole screen.
+		if (distance <= radius) {
+			return std::numeric_limits<float>::max();
+		}
+
+		// Projected diameter of the bounding sphere, in pixels.
+		return radius / (distance * std::tan(glm::radians(camera.getFieldOfView()) * 0.5f)) * static_cast<float>(swapchainExtent.height);
+	}
+
 	QueueFamilies Application::getQueueFamilies(VkPhysicalDevice physicalDevice) {
 		QueueFamilies queueFamilyIndices;
 
@@ -1539,43 +2435,106 @@ namespace vox {
 			throw std::runtime_error("[Vulkan] Failed to begin recording command buffer!");
 		}
 
-		VkRenderPassBeginInfo renderPassBeginInfo = {};
-		renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-		renderPassBeginInfo.renderPass = renderPass;
-		renderPassBeginInfo.framebuffer = swapchainFramebuffers[imageIndex];
-		renderPassBeginInfo.renderArea.offset = {0, 0};
-		renderPassBeginInfo.renderArea.extent = swapchainExtent;
+		// Barriers, render passes and framebuffers all come from the graph.
+		renderGraph.setImage(swapchainResource, swapchainImages[imageIndex], swapchainImageViews[imageIndex]);
+		renderGraph.execute(mainLogicalDevice, commandBuffer);
+
+		if (VK_SUCCESS != vkEndCommandBuffer(commandBuffer)) {
+			throw std::runtime_error("[Vulkan] Failed to record command buffer!");
+		}
+	}
+
+	void Application::recordMainPass(const RenderGraphContext& context) {
+		const VkViewport viewport = {
+			.x = 0.0f,
+			.y = 0.0f,
+			.width = static_cast<float>(context.extent.width),
+			.height = static_cast<float>(context.extent.height),
+			.minDepth = 0.0f,
+			.maxDepth = 1.0f
+		};
 
-		std::array<VkClearValue, 2> clearValues = {};
-		clearValues[0].color = {{ 0.0f, 0.0f, 0.0f, 1.0f } };
-		clearValues[1].depthStencil = { 1.0f, 0 };
+		const VkRect2D scissor = {
+			.offset = { 0, 0 },
+			.extent = context.extent
+		};
 
-		renderPassBeginInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-		renderPassBeginInfo.pClearValues = clearValues.data();
+		// Draws are queued in any order, and recorded sorted by pipeline, material and depth.
+		renderQueue.clear();
 
-		vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+		// Copies of the scene are laid out in a square grid, centered on the original.
+		const auto gridSize = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(drawCount))));
+		const auto gridCenter = static_cast<float>(gridSize - 1) * 0.5f;
 
-		for (const auto& [id, shader] : shaderManager.getAll()) {
-			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines[id]);
+		for (auto& [id, shader] : shaderManager.getAll()) {
+			const RenderDraw renderDraw = {
+				.pipeline = getPipeline(id, shaderVariants[id]),
+				.pipelineLayout = pipelineLayouts[id],
+				.material = { shader.getDescriptorSets()[currentFrame], textureTable.getDescriptorSet() },
+				.vertexBuffer = vertexBuffer,
+				.indexBuffer = indexBuffer,
+				.indexCount = static_cast<uint32_t>(indices.size()),
+				.firstIndex = 0,
+				.vertexOffset = 0
+			};
 
-			const VkBuffer vertexBuffers[] = { vertexBuffer };
-			const VkDeviceSize offsets[] = { 0 };
+			// Per-draw values go through push constants, rather than a uniform buffer write per draw.
+			shader.setPushConstant("colorModulation", glm::vec4(1.0f, 0.3f, 0.3f, 1.0f));
+			shader.setPushConstant("textureIndex", textureTableIndex);
 
-			vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
-			vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+			for (uint32_t copy = 0; copy < drawCount; ++copy) {
+				const auto offset = glm::vec3(static_cast<float>(copy % gridSize) - gridCenter, static_cast<float>(copy / gridSize) - gridCenter, 0.0f) * DRAW_GRID_SPACING;
+				const auto model = glm::translate(glm::mat4(1.0f), offset) * ubo.model;
 
-			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayouts[id], 0, 1, &shader.getDescriptorSets()[currentFrame], 0, nullptr);
+				shader.setPushConstant("model", model);
 
-			vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(indices.size()), 1, 0, 0, 0);
+				renderQueue.submit(RenderQueuePass::Opaque, renderDraw, glm::distance(camera.getPosition(), glm::vec3(model[3])), shader.getPushConstantBytes(), shader.getPushConstantUpdates());
+			}
 		}
 
-		ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), commandBuffer);
+		renderQueue.sort();
 
-		vkCmdEndRenderPass(commandBuffer);
+		VkCommandBufferInheritanceInfo inheritanceInfo = {};
+		inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+		inheritanceInfo.renderPass = context.renderPass;
+		inheritanceInfo.subpass = 0;
+		inheritanceInfo.framebuffer = context.framebuffer;
 
-		if (VK_SUCCESS != vkEndCommandBuffer(commandBuffer)) {
-			throw std::runtime_error("[Vulkan] Failed to record command buffer!");
+		const auto recordStart = std::chrono::high_resolution_clock::now();
+
+		std::ranges::fill(recordStats, RenderQueueStats {});
+
+		// Each worker records a contiguous range of the sorted queue, so only the first draw of a range rebinds.
+		const auto recorded = commandRecorder.record(mainLogicalDevice, threadPool, currentFrame, inheritanceInfo, renderQueue.getSize(), RENDER_QUEUE_MIN_DRAWS_PER_THREAD, getRecordThreadCount(), [&](VkCommandBuffer secondary, const size_t chunk, const size_t begin, const size_t end) {
+			// Dynamic state is not inherited from the primary, so every secondary sets its own.
+			vkCmdSetViewport(secondary, 0, 1, &viewport);
+			vkCmdSetScissor(secondary, 0, 1, &scissor);
+
+			recordStats[chunk] = renderQueue.record(secondary, begin, end);
+		});
+
+		recordThreadCount = static_cast<uint32_t>(recorded.size());
+		recordTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - recordStart).count();
+
+		renderQueueStats = {};
+
+		for (const auto& stats : recordStats) {
+			renderQueueStats += stats;
+		}
+
+		// The UI goes last, on top, from the main slot since ImGui is only used from this thread.
+		const auto imguiCommandBuffer = commandRecorder.begin(mainLogicalDevice, currentFrame, commandRecorder.getMainSlot(), inheritanceInfo);
+
+		ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), imguiCommandBuffer);
+
+		if (VK_SUCCESS != vkEndCommandBuffer(imguiCommandBuffer)) {
+			throw std::runtime_error("[Vulkan] Failed to record ImGui command buffer!");
 		}
+
+		secondaryCommandBuffers.assign(recorded.begin(), recorded.end());
+		secondaryCommandBuffers.push_back(imguiCommandBuffer);
+
+		vkCmdExecuteCommands(context.commandBuffer, static_cast<uint32_t>(secondaryCommandBuffers.size()), secondaryCommandBuffers.data());
 	}
 
 	VkFormat Application::findSupportedFormat(const std::vector<VkFormat> &formats, VkImageTiling imageTiling, VkFormatFeatureFlags formatFatureFlags) {
@@ -1607,6 +2566,13 @@ namespace vox {
 		return vkFormat == VK_FORMAT_D32_SFLOAT_S8_UINT || vkFormat == VK_FORMAT_D24_UNORM_S8_UINT;
 	}
 
+	bool Application::hasFormatSupport(VkFormat vkFormat, VkFormatFeatureFlags formatFeatureFlags) {
+		VkFormatProperties formatProperties;
+		vkGetPhysicalDeviceFormatProperties(mainPhysicalDevice, vkFormat, &formatProperties);
+
+		return (formatProperties.optimalTilingFeatures & formatFeatureFlags) == formatFeatureFlags;
+	}
+
 	void Application::handleInput(GLFWwindow *window, const float timeDelta) {
 		camera.handleKeyboardInput(window, timeDelta);
 		camera.handleMouseInput(window);
@@ -1629,8 +2595,19 @@ namespace vox {
 	void Application::draw() {
 		uint32_t imageIndex;
 
-		if (VK_SUCCESS != vkWaitForFences(mainLogicalDevice, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX)) {
-			throw std::runtime_error("[Vulkan] Failed to wait for fence!");
+		if (VK_SUCCESS != graphicsTimeline.wait(mainLogicalDevice, frameTimelineValues[currentFrame])) {
+			throw std::runtime_error("[Vulkan] Failed to wait for frame!");
+		}
+
+		// Objects retired while earlier frames were recorded are destroyed once those frames finished.
+		graphicsTimeline.collect(mainLogicalDevice);
+
+		// The last frame recorded into this slot is done, and so are the transient sets it used.
+		descriptorAllocator.resetTransient(mainLogicalDevice, currentFrame);
+
+		// Along with the secondaries it executed.
+		if (VK_SUCCESS != commandRecorder.reset(mainLogicalDevice, currentFrame)) {
+			throw std::runtime_error("[Vulkan] Failed to reset secondary command pools!");
 		}
 
 		if (const auto result = vkAcquireNextImageKHR(mainLogicalDevice, swapchain, UINT64_MAX, imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
@@ -1643,10 +2620,6 @@ namespace vox {
 
 		drawImGui();
 
-		if (VK_SUCCESS != vkWaitForFences(mainLogicalDevice, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX)) {
-			throw std::runtime_error("[Vulkan] Failed to wait for fence!");
-		}
-
 		if (VK_SUCCESS != vkResetCommandBuffer(commandBuffers[currentFrame], 0)) {
 			throw std::runtime_error("[Vulkan] Failed to reset command buffer!");
 		}
@@ -1655,31 +2628,49 @@ namespace vox {
 
 		updateUniformBuffers(currentFrame);
 
-		if (VK_SUCCESS != vkResetFences(mainLogicalDevice, 1, &inFlightFences[currentFrame])) {
-			throw std::runtime_error("[Vulkan] Failed to reset fence!");
-		}
-
 		VkSubmitInfo submitInfo = {};
 		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-		const std::vector waitSemaphores = { imageAvailableSemaphores[currentFrame] };
-		const std::vector<VkPipelineStageFlags> waitStages = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+		// The frame also waits for the last immediate command, so it never reads an upload still in flight.
+		const std::vector waitSemaphores = { imageAvailableSemaphores[currentFrame], graphicsTimeline.get() };
+		const std::vector<VkPipelineStageFlags> waitStages = {
+			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+			VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+		};
 
-		submitInfo.waitSemaphoreCount = 1;
+		submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
 		submitInfo.pWaitSemaphores = waitSemaphores.data();
 		submitInfo.pWaitDstStageMask = waitStages.data();
 
 		submitInfo.commandBufferCount = 1;
 		submitInfo.pCommandBuffers = &commandBuffers[currentFrame];
 
-		const std::vector signalSemaphores = { renderFinishedSemaphores[currentFrame] };
-		submitInfo.signalSemaphoreCount = 1;
+		// Presentation only takes binary semaphores, so the frame signals both kinds.
+		const std::vector signalSemaphores = { renderFinishedSemaphores[imageIndex], graphicsTimeline.get() };
+		submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
 		submitInfo.pSignalSemaphores = signalSemaphores.data();
 
-		if (VK_SUCCESS != vkQueueSubmit(graphicsQueue, 1, &submitInfo, inFlightFences[currentFrame])) {
+		const auto frameTimelineValue = graphicsTimeline.next();
+
+		// Values of binary semaphores are ignored.
+		const std::vector<uint64_t> waitSemaphoreValues = { 0, uploadTimelineValue };
+		const std::vector<uint64_t> signalSemaphoreValues = { 0, frameTimelineValue };
+
+		VkTimelineSemaphoreSubmitInfo timelineSubmitInfo = {};
+		timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineSubmitInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitSemaphoreValues.size());
+		timelineSubmitInfo.pWaitSemaphoreValues = waitSemaphoreValues.data();
+		timelineSubmitInfo.signalSemaphoreValueCount = static_cast<uint32_t>(signalSemaphoreValues.size());
+		timelineSubmitInfo.pSignalSemaphoreValues = signalSemaphoreValues.data();
+
+		submitInfo.pNext = &timelineSubmitInfo;
+
+		if (VK_SUCCESS != vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE)) {
 			throw std::runtime_error("[Vulkan] Failed to submit draw command buffer!");
 		}
 
+		frameTimelineValues[currentFrame] = frameTimelineValue;
+
 		VkPresentInfoKHR presentInfo = {};
 		presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 		presentInfo.waitSemaphoreCount = 1;
@@ -1697,11 +2688,9 @@ namespace vox {
 			throw std::runtime_error("[Vulkan] Failed to present swap chain image!");
 		}
 
-		if (VK_SUCCESS != vkQueueWaitIdle(presentQueue)) {
-			throw std::runtime_error("[Vulkan] Failed to wait for queue to become idle!");
-		}
-
-		currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+		// Nothing waits for the GPU here: the next frame records into its own slot, fenced separately.
+		currentFrame = (currentFrame + 1) % framesInFlight;
+		frameCount++;
 	}
 
 	void Application::drawImGui() {
@@ -1733,10 +2722,76 @@ namespace vox {
 
 		ImGui::End();
 
+		ImGui::Begin("Textures");
+
+		auto budget = static_cast<int>(textureResidency.getBudget() / 1024);
+		if (ImGui::SliderInt("Budget (KiB)", &budget, 64, 256 * 1024, "%d", ImGuiSliderFlags_Logarithmic)) {
+			textureResidency.setBudget(static_cast<size_t>(budget) * 1024);
+		}
+
+		ImGui::Text("Resident: %zu / %zu KiB", textureResidency.getResidentSize() / 1024, textureResidency.getBudget() / 1024);
+		ImGui::Text("Streams in flight: %zu", textureStreams.size());
+		ImGui::Text("Swaps pending: %zu", textureSwaps.size());
+
+		ImGui::Separator();
+
+		// Most recent first.
+		for (const auto& event : textureResidency.getEvents() | std::views::reverse) {
+			ImGui::Text(
+				"%s %s %u, level %u -> %u, %zu KiB (frame %llu)",
+				event.type == TextureResidencyEventType::Stream ? "Stream" : "Evict",
+				(event.textureId & TEXTURE_RESIDENCY_ATLAS_BIT) != 0 ? "atlas texture" : "texture",
+				event.textureId & ~TEXTURE_RESIDENCY_ATLAS_BIT,
+				event.fromLevel,
+				event.toLevel,
+				event.size / 1024,
+				static_cast<unsigned long long>(event.frame)
+			);
+		}
+
+		ImGui::End();
+
+		ImGui::Begin("Shaders");
+
+		ImGui::Text("Draws: %u", renderQueueStats.draws);
+		ImGui::Text("Binds: %u pipeline, %u descriptor set, %u buffer", renderQueueStats.pipelineBinds, renderQueueStats.descriptorSetBinds, renderQueueStats.bufferBinds);
+		ImGui::Text("Recorded in %.3f ms on %u thread(s)", recordTime, recordThreadCount);
+
+		ImGui::Separator();
+
+		for (const auto& [id, shader] : shaderManager.getAll()) {
+			const auto metadata = shader.getMetadata();
+			auto& selected = shaderVariants[id];
+
+			if (ImGui::BeginCombo(id.c_str(), selected.empty() ? "default" : selected.c_str())) {
+				if (ImGui::Selectable("default", selected.empty())) {
+					selected.clear();
+				}
+
+				for (const auto& variant : metadata.variants | std::views::keys) {
+					if (ImGui::Selectable(variant.c_str(), selected == variant)) {
+						selected = variant;
+					}
+				}
+
+				ImGui::EndCombo();
+			}
+		}
+
+		ImGui::End();
+
 		ImGui::Render();
 	}
 
 	void Application::loop() {
+		const auto startTime = std::chrono::high_resolution_clock::now();
+		const auto startFrame = frameCount;
+
+		benchmarkFrameTimes.reserve(benchmarkFrameCount);
+		benchmarkRecordTimes.reserve(benchmarkFrameCount);
+
+		auto frameEndTime = startTime;
+
 		while (!glfwWindowShouldClose(glfwWindow)) {
 			glfwPollEvents();
 
@@ -1747,10 +2802,78 @@ namespace vox {
 				ImGui::GetIO().ConfigFlags &= ~ImGuiConfigFlags_NoMouse;
 			}
 
+			updateTextureAtlases();
+			updateTextureResidency();
+			updateShaders();
+
+			const auto previousFrameCount = frameCount;
+
 			draw();
+
+			// A frame given up on, e.g. to recreate the swapchain, counts towards the next one drawn.
+			if (frameCount == previousFrameCount) {
+				continue;
+			}
+
+			const auto previousFrameEndTime = std::exchange(frameEndTime, std::chrono::high_resolution_clock::now());
+
+			if (benchmarkFrameCount == 0 || frameCount - startFrame <= BENCHMARK_WARMUP_FRAMES) {
+				continue;
+			}
+
+			// Every benchmark run of a setting measures the same frames, counted once warmed up.
+			benchmarkFrameTimes.push_back(std::chrono::duration<double, std::milli>(frameEndTime - previousFrameEndTime).count());
+			benchmarkRecordTimes.push_back(recordTime);
+
+			if (benchmarkFrameTimes.size() >= benchmarkFrameCount) {
+				glfwSetWindowShouldClose(glfwWindow, GLFW_TRUE);
+			}
+		}
+
+		const auto frames = frameCount - startFrame;
+		const auto loopTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+		std::cout << "[Vulkan] Drew " << frames << " frame(s) in " << loopTime << "ms (" << loopTime / static_cast<double>(std::max<uint64_t>(frames, 1)) << "ms per frame) with " << framesInFlight << " frame(s) in flight.\n" << std::flush;
+
+		if (benchmarkFrameCount != 0) {
+			logBenchmark();
 		}
 	}
 
+	void Application::logBenchmark() const {
+		auto frameTimes = benchmarkFrameTimes;
+		std::ranges::sort(frameTimes);
+
+		auto recordTimes = benchmarkRecordTimes;
+		std::ranges::sort(recordTimes);
+
+		// Percentiles of the measured frames, which unlike means are not skewed by a single hitch.
+		const auto getPercentile = [](const std::vector<double>& times, const double percentile) {
+			return times.empty() ? 0.0 : times[static_cast<size_t>(percentile * static_cast<double>(times.size() - 1))];
+		};
+
+		const auto getMean = [](const std::vector<double>& times) {
+			return times.empty() ? 0.0 : std::accumulate(times.begin(), times.end(), 0.0) / static_cast<double>(times.size());
+		};
+
+		// Key=value pairs on one line, which the benchmark target collects from every run.
+		std::cout << "[Benchmark]"
+			<< " pipelines=" << pipelineBuildCount
+			<< " pipeline_threads=" << pipelineBuildThreadCount
+			<< " pipeline_ms=" << pipelineBuildTime
+			<< " frames_in_flight=" << framesInFlight
+			<< " frames=" << frameTimes.size()
+			<< " frame_ms_mean=" << getMean(frameTimes)
+			<< " frame_ms_p50=" << getPercentile(frameTimes, 0.5)
+			<< " frame_ms_p99=" << getPercentile(frameTimes, 0.99)
+			<< " draws=" << renderQueueStats.draws
+			<< " record_threads=" << recordThreadCount
+			<< " record_ms_mean=" << getMean(recordTimes)
+			<< " record_ms_p50=" << getPercentile(recordTimes, 0.5)
+			<< " record_ms_p99=" << getPercentile(recordTimes, 0.99)
+			<< "\n" << std::flush;
+	}
+
 	void Application::free() {
 	    ImGui_ImplVulkan_Shutdown();
 	    ImGui_ImplGlfw_Shutdown();
@@ -1759,14 +2882,28 @@ namespace vox {
 
 	    vkDeviceWaitIdle(mainLogicalDevice);
 
-	    for (auto i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-	        vkDestroySemaphore(mainLogicalDevice, renderFinishedSemaphores[i], nullptr);
+	    // Rebuilds still running use the descriptor set layouts and pipeline cache destroyed below.
+	    for (auto &shaderReload: shaderReloads | std::views::values) {
+	        try {
+	            const auto reloaded = shaderReload.result.get();
+
+	            vkDestroyPipeline(mainLogicalDevice, reloaded.pipeline, nullptr);
+	            vkDestroyPipelineLayout(mainLogicalDevice, reloaded.pipelineLayout, nullptr);
+	        } catch (const std::exception&) {
+	            // Nothing was built.
+	        }
+	    }
+
+	    // Runs whatever destruction is still deferred, now that the device is idle.
+	    graphicsTimeline.destroy(mainLogicalDevice);
+
+	    for (uint32_t i = 0; i < framesInFlight; i++) {
 	        vkDestroySemaphore(mainLogicalDevice, imageAvailableSemaphores[i], nullptr);
-	        vkDestroyFence(mainLogicalDevice, inFlightFences[i], nullptr);
 	    }
 
 	    vkDestroyCommandPool(mainLogicalDevice, commandPool, nullptr);
 	    vkDestroyCommandPool(mainLogicalDevice, shortCommandPool, nullptr);
+	    commandRecorder.destroy(mainLogicalDevice);
 
 		vkDestroyBuffer(mainLogicalDevice, vertexBuffer, nullptr);
 		vkFreeMemory(mainLogicalDevice, vertexBufferMemory, nullptr);
@@ -1776,16 +2913,35 @@ namespace vox {
 
 	    freeVkSwapchain();
 
-	    vkDestroySampler(mainLogicalDevice, textureSampler, nullptr);
-	    vkDestroyImageView(mainLogicalDevice, textureImageView, nullptr);
+	    for (auto& textureStream : textureStreams | std::views::values) {
+	        textureStream.copy.wait();
+
+	        vkUnmapMemory(mainLogicalDevice, textureStream.stagingBufferMemory);
+	        vkDestroyBuffer(mainLogicalDevice, textureStream.stagingBuffer, nullptr);
+	        vkFreeMemory(mainLogicalDevice, textureStream.stagingBufferMemory, nullptr);
+	    }
+
+	    for (const auto& textureSwap : textureSwaps) {
+	        releaseImageViews(textureSwap.image);
+	        vkDestroyImage(mainLogicalDevice, textureSwap.image, nullptr);
+	        vkFreeMemory(mainLogicalDevice, textureSwap.imageMemory, nullptr);
+	    }
+
+	    samplerCache.destroy(mainLogicalDevice);
+	    imageViewCache.destroy(mainLogicalDevice);
+
 	    vkDestroyImage(mainLogicalDevice, textureImage, nullptr);
 	    vkFreeMemory(mainLogicalDevice, textureImageMemory, nullptr);
 
-	    vkDestroyImageView(mainLogicalDevice, depthImageView, nullptr);
-	    vkDestroyImage(mainLogicalDevice, depthImage, nullptr);
-	    vkFreeMemory(mainLogicalDevice, depthImageMemory, nullptr);
+		for (const auto &atlasImage: atlasImages | std::views::values) {
+			vkDestroyImage(mainLogicalDevice, atlasImage, nullptr);
+		}
 
-	    for (auto i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+		for (const auto &atlasImageMemory: atlasImageMemories | std::views::values) {
+			vkFreeMemory(mainLogicalDevice, atlasImageMemory, nullptr);
+		}
+
+	    for (uint32_t i = 0; i < framesInFlight; i++) {
 	        vkDestroyBuffer(mainLogicalDevice, uniformBuffers[i], nullptr);
 	        vkFreeMemory(mainLogicalDevice, uniformBufferMemories[i], nullptr);
 	    }
@@ -1797,18 +2953,30 @@ namespace vox {
 			shader.destroyOwnedDescriptorSetLayot(mainLogicalDevice);
 		}
 
-		vkDestroyDescriptorPool(mainLogicalDevice, descriptorPool, nullptr);
+		descriptorAllocator.destroy(mainLogicalDevice);
 		vkDestroyDescriptorPool(mainLogicalDevice, imguiDescriptorPool, nullptr);
 
+		textureTable.destroy(mainLogicalDevice);
+
 		for (const auto &pipeline: pipelines | std::views::values) {
 			vkDestroyPipeline(mainLogicalDevice, pipeline, nullptr);
 		}
 
+		for (const auto &variants: pipelineVariants | std::views::values) {
+			for (const auto &pipeline: variants | std::views::values) {
+				vkDestroyPipeline(mainLogicalDevice, pipeline, nullptr);
+			}
+		}
+
 		for (const auto &pipelineLayout: pipelineLayouts | std::views::values) {
 			vkDestroyPipelineLayout(mainLogicalDevice, pipelineLayout, nullptr);
 		}
 
-	    vkDestroyRenderPass(mainLogicalDevice, renderPass, nullptr);
+		// Picks up pipelines created after startup, e.g. by ImGui.
+		pipelineCache.save(mainLogicalDevice);
+		pipelineCache.destroy(mainLogicalDevice);
+
+	    renderGraph.destroy(mainLogicalDevice);
 
 	    vkDestroyDevice(mainLogicalDevice, nullptr);
 
@@ -1826,15 +2994,20 @@ namespace vox {
 	}
 
 	void Application::freeVkSwapchain() {
-	    for (const auto imageView : swapchainImageViews) {
-	        vkDestroyImageView(mainLogicalDevice, imageView, nullptr);
+	    // Drops the framebuffers of the swapchain images, and the transient images sized after them.
+	    renderGraph.reset(mainLogicalDevice);
+
+	    for (const auto image : swapchainImages) {
+	        releaseImageViews(image);
 	    }
 
 	    vkDestroySwapchainKHR(mainLogicalDevice, swapchain, nullptr);
 
-	    for (const auto framebuffer : swapchainFramebuffers) {
-	        vkDestroyFramebuffer(mainLogicalDevice, framebuffer, nullptr);
+	    for (const auto semaphore : renderFinishedSemaphores) {
+	        vkDestroySemaphore(mainLogicalDevice, semaphore, nullptr);
 	    }
+
+	    renderFinishedSemaphores.clear();
 	}
 
 
@@ -1851,9 +3024,9 @@ namespace vox {
 		freeVkSwapchain();
 
 		initSwapchain();
+		initSwapchainSyncObjects();
 		initImageViews();
-		initDepthResources();
-		initFramebuffers();
+		initRenderGraph();
 	}
 
 	VKAPI_ATTR VkBool32 VKAPI_CALL Application::debugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity, VkDebugUtilsMessageTypeFlagsEXT messageType, const VkDebugUtilsMessengerCallbackDataEXT* callbackData, void* userData) {
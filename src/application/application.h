@@ -2,11 +2,15 @@
 #define APPLICATION_H
 
 #include <iostream>
+#include <deque>
 #include <functional>
 #include <vector>
 #include <filesystem>
+#include <future>
 #include <map>
 #include <memory>
+#include <optional>
+#include <span>
 
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
@@ -18,12 +22,27 @@
 
 #include "../camera/camera.h"
 #include "../model/model.h"
+#include "../misc/constants.h"
 #include "../misc/util.h"
+#include "../misc/thread_pool.h"
 #include "../vertex/vertex.h"
 #include "../shader/shader.h"
 #include "../shader/shader_manager.h"
+#include "../shader/shader_watcher.h"
+#include "../descriptor/descriptor_allocator.h"
 #include "../model/model_manager.h"
+#include "../pipeline/pipeline_cache.h"
+#include "../render/command_recorder.h"
+#include "../render/render_graph.h"
+#include "../render/render_queue.h"
+#include "../sync/image_barrier.h"
+#include "../sync/timeline.h"
 #include "../texture/texture_manager.h"
+#include "../texture/texture_ktx2.h"
+#include "../texture/image_view_cache.h"
+#include "../texture/sampler_cache.h"
+#include "../texture/texture_residency.h"
+#include "../texture/texture_table.h"
 
 #ifdef NDEBUG
 constexpr auto enableValidationLayers = false;
@@ -31,7 +50,58 @@ constexpr auto enableValidationLayers = false;
 constexpr auto enableValidationLayers = true;
 #endif
 
+#ifdef VOX_DUMP_ATLASES
+constexpr auto enableAtlasDumps = true;
+#else
+constexpr auto enableAtlasDumps = false;
+#endif
+
 namespace vox {
+	// Levels of a texture being streamed in; a worker copies them into the mapped staging buffer.
+	struct TextureStream {
+		uint32_t baseLevel;
+
+		VkBuffer stagingBuffer;
+		VkDeviceMemory stagingBufferMemory;
+
+		std::future<void> copy;
+	};
+
+	// Texture image uploaded from a new base level, swapped in once its upload finished.
+	struct TextureSwap {
+		uint32_t baseLevel;
+
+		VkImage image;
+		VkDeviceMemory imageMemory;
+		VkImageView imageView;
+		uint32_t mipLevels;
+
+		// Value the last command of the upload signals.
+		uint64_t timelineValue;
+
+		// Set when the swap finishes a stream, rather than applying an eviction.
+		bool isStream;
+	};
+
+	// Pipeline rebuilt by a worker from a shader's edited files.
+	struct ReloadedPipeline {
+		ShaderMetadata metadata;
+
+		// Kept by the live shader, to build its variants from.
+		std::optional<std::vector<char>> vertexShaderCode;
+		std::optional<std::vector<char>> fragmentShaderCode;
+
+		VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+		VkPipeline pipeline = VK_NULL_HANDLE;
+	};
+
+	struct ShaderReload {
+		std::future<ReloadedPipeline> result;
+
+		// Set when the files changed again while the rebuild was running.
+		bool pending = false;
+	};
+
 	class Application : public std::enable_shared_from_this<Application> {
 	public:
 		void run();
@@ -43,7 +113,8 @@ namespace vox {
 		};
 
 		const std::vector<const char*> deviceExtensions = {
-			VK_KHR_SWAPCHAIN_EXTENSION_NAME
+			VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+			VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME
 		};
 
 		const std::string MODEL_PATH = "models/viking_room.obj";
@@ -52,6 +123,8 @@ namespace vox {
 		const char* NAME = "Vulkan";
 		const char* ENGINE = "None";
 
+        ThreadPool threadPool;
+
         ShaderManager shaderManager;
         ModelManager modelManager;
         TextureManager textureManager;
@@ -59,8 +132,31 @@ namespace vox {
 //		std::map<std::string, Shader<>> shaders = {};
 //		std::map<std::string, Model> models = {};
 
+		// Frames recorded ahead of the GPU; per-frame resources are sized by it.
+		uint32_t framesInFlight = getFramesInFlight();
+
+		// Copies of the scene drawn every frame, 1 unless benchmarking recording.
+		uint32_t drawCount = getDrawCount();
+
+		// Frames drawn before a benchmark run exits on its own; 0 unless benchmarking.
+		uint32_t benchmarkFrameCount = getBenchmarkFrameCount();
+
+		// Last pipeline build, as reported by benchmark runs.
+		size_t pipelineBuildCount = 0;
+		uint32_t pipelineBuildThreadCount = 0;
+		double pipelineBuildTime = 0.0;
+
+		// Milliseconds each measured frame of a benchmark run took, from the end of the previous one.
+		std::vector<double> benchmarkFrameTimes;
+
+		// Milliseconds the draws of each measured frame took to record.
+		std::vector<double> benchmarkRecordTimes;
+
 		uint32_t currentFrame = 0;
 
+		// Frames submitted so far.
+		uint64_t frameCount = 0;
+
 		GLFWwindow* glfwWindow;
 
 		VkInstance vkInstance;
@@ -70,6 +166,7 @@ namespace vox {
 		VkSurfaceKHR surface;
 
 		VkPhysicalDevice mainPhysicalDevice = VK_NULL_HANDLE;
+		VkPhysicalDeviceProperties mainPhysicalDeviceProperties = {};
 		VkDevice mainLogicalDevice = VK_NULL_HANDLE;
 
 		VkQueue graphicsQueue;
@@ -80,16 +177,44 @@ namespace vox {
 		VkExtent2D swapchainExtent;
 		std::vector<VkImage> swapchainImages;
 		std::vector<VkImageView> swapchainImageViews;
-		std::vector<VkFramebuffer> swapchainFramebuffers;
 
+		// Passes of a frame; rebuilt with the swapchain.
+		RenderGraph renderGraph;
+		RenderGraphResource swapchainResource = 0;
+		RenderGraphPass mainPass = 0;
+
+		// Of the main pass, which pipelines and ImGui are built against.
 		VkRenderPass renderPass;
 
-		VkDescriptorPool descriptorPool;
+		DescriptorAllocator descriptorAllocator { framesInFlight };
 		VkDescriptorPool imguiDescriptorPool;
 
+		PipelineCache pipelineCache { PIPELINE_CACHE_PATH };
+
 		std::map<std::string, VkPipelineLayout> pipelineLayouts;
 		std::map<std::string, VkPipeline> pipelines;
 
+		// Pipelines of the named variants, by shader id then variant; each is built the first time it is drawn with.
+		std::map<std::string, std::map<std::string, VkPipeline>> pipelineVariants;
+
+		// Variant each shader is drawn with, as picked in the "Shaders" window; missing or empty is the default.
+		std::map<std::string, std::string> shaderVariants;
+
+		ShaderWatcher shaderWatcher { { "shaders/spirv", "shaders/metadata" }, std::chrono::milliseconds(SHADER_WATCH_INTERVAL) };
+		std::map<std::string, ShaderReload> shaderReloads;
+
+		RenderQueue renderQueue;
+
+		// Secondaries of the render pass, recorded by the workers plus one for ImGui on this thread.
+		CommandRecorder commandRecorder { framesInFlight, threadPool.getThreadCount() };
+		std::vector<VkCommandBuffer> secondaryCommandBuffers;
+
+		// Of the last frame, for the "Shaders" window; one entry per worker.
+		std::vector<RenderQueueStats> recordStats = std::vector<RenderQueueStats>(threadPool.getThreadCount());
+		RenderQueueStats renderQueueStats = {};
+		float recordTime = 0.0f;
+		uint32_t recordThreadCount = 0;
+
 		VkCommandPool commandPool;
 		VkCommandPool shortCommandPool;
 
@@ -101,11 +226,33 @@ namespace vox {
 		VkImage textureImage;
 		VkDeviceMemory textureImageMemory;
 		VkImageView textureImageView;
+		VkFormat textureFormat = VK_FORMAT_R8G8B8A8_SRGB;
+		uint32_t textureMipLevels = 1;
+		bool textureCompressionEnabled = false;
 		VkSampler textureSampler;
 
-		VkImage depthImage;
-		VkDeviceMemory depthImageMemory;
-		VkImageView depthImageView;
+		// Mip chain of the texture on the CPU, when it was baked; only then are its levels streamed.
+		std::optional<TextureKtx2> textureSource = std::nullopt;
+
+		TextureResidency textureResidency { TEXTURE_RESIDENCY_BUDGET };
+		std::map<uint32_t, TextureStream> textureStreams;
+		std::deque<TextureSwap> textureSwaps;
+		std::vector<MeshBounds> textureModelBounds;
+
+		std::map<uint32_t, VkImage> atlasImages;
+		std::map<uint32_t, VkDeviceMemory> atlasImageMemories;
+		std::map<uint32_t, VkImageView> atlasImageViews;
+
+		// Samplers and image views are shared by creation parameters, and owned by these caches.
+		SamplerCache samplerCache;
+		ImageViewCache imageViewCache;
+
+		TextureTable textureTable;
+		uint32_t textureTableIndex = 0;
+
+		// The slot of the texture changes with every swap, so residency keeps the id of its first one.
+		uint32_t textureResidencyId = 0;
+
 		VkSampler depthSampler; // TODO
 
 		std::vector<VkBuffer> uniformBuffers;
@@ -119,9 +266,18 @@ namespace vox {
 		std::vector<VkCommandBuffer> commandBuffers;
 
 		std::vector<VkSemaphore> imageAvailableSemaphores;
+
+		// One per swapchain image rather than per frame, as presentation may still wait on it when the frame slot comes around.
 		std::vector<VkSemaphore> renderFinishedSemaphores;
 
-		std::vector<VkFence> inFlightFences;
+		// Signalled by every graphics queue submission; objects the GPU may still use are destroyed behind it.
+		Timeline graphicsTimeline;
+
+		// Value the last frame recorded in each slot signals on the graphics timeline.
+		std::vector<uint64_t> frameTimelineValues;
+
+		// Value the last immediate command signals, which the next frame waits for before reading what it uploaded.
+		uint64_t uploadTimelineValue = 0;
 
 		Camera camera = {};
 
@@ -131,8 +287,17 @@ namespace vox {
 
 		VkShaderModule buildShaderModule(const std::vector<char>& rawShader) const;
 
-		static VkPipelineShaderStageCreateInfo buildPipelineShaderStageCreateInfo(VkShaderModule shaderModule, VkShaderStageFlagBits stage);
-		static VkPipelineViewportStateCreateInfo buildPipelineViewportStateCreateInfo(const VkViewport *viewport, const VkRect2D *scissor);
+		void buildPipeline(const std::string& id, Shader<>& shader, VkRenderPass compatibleRenderPass, VkPipelineLayout& pipelineLayout, VkPipeline& pipeline);
+		void buildPipelineVariant(const std::string& id, const Shader<>& shader, VkRenderPass compatibleRenderPass, VkPipelineLayout pipelineLayout, const std::string& variant, VkPipeline& pipeline);
+
+		VkPipeline getPipeline(const std::string& id, const std::string& variant);
+
+		ReloadedPipeline reloadShader(const std::string& id, const ShaderReflection& liveReflection, VkDescriptorSetLayout descriptorSetLayout, VkRenderPass compatibleRenderPass);
+		void submitShaderReload(const std::string& id);
+
+		static VkPipelineShaderStageCreateInfo buildPipelineShaderStageCreateInfo(VkShaderModule shaderModule, VkShaderStageFlagBits stage, const VkSpecializationInfo* specializationInfo);
+		static VkPipelineViewportStateCreateInfo buildPipelineViewportStateCreateInfo();
+		static VkPipelineDynamicStateCreateInfo buildPipelineDynamicStateCreateInfo(std::span<const VkDynamicState> dynamicStates);
 		static VkPipelineRasterizationStateCreateInfo buildPipelineRasterizationStateCreateInfo();
 		static VkPipelineMultisampleStateCreateInfo buildPipelineMultisampleStateCreateInfo();
 		static VkPipelineColorBlendAttachmentState buildPipelineColorBlendAttachmentState();
@@ -142,9 +307,16 @@ namespace vox {
 		static void buildDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& createInfo);
 
 		VkResult buildBuffer(VkBuffer *buffer, VkDeviceMemory *bufferMemory, VkDeviceSize deviceSize, VkBufferUsageFlags bufferUsageFlags, VkMemoryPropertyFlags memoryPropertyFlags);
-		VkResult buildImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usageFlags, VkMemoryPropertyFlags propertyFlags, VkImage& image, VkDeviceMemory& imageMemory);
-		VkResult buildImageView(VkImage image, VkFormat format, VkImageAspectFlags imageAspectFlags, VkImageView& imageView);
-		VkResult buildTextureImage(const std::string& imagePath, VkImage& textureImage, VkDeviceMemory& textureImageMemory);
+		VkResult buildImage(uint32_t width, uint32_t height, uint32_t mipLevels, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usageFlags, VkMemoryPropertyFlags propertyFlags, VkImage& image, VkDeviceMemory& imageMemory);
+		VkResult buildImageView(VkImage image, VkFormat format, VkImageAspectFlags imageAspectFlags, VkImageView& imageView, uint32_t mipLevels = 1);
+		void releaseImageViews(VkImage image);
+		VkResult buildTextureImage(const std::string& imagePath, VkImage& textureImage, VkDeviceMemory& textureImageMemory, VkFormat& format, uint32_t& mipLevels, std::optional<TextureKtx2>& source);
+		VkResult buildCompressedTextureImage(const TextureKtx2& texture, uint32_t baseLevel, VkImage& textureImage, VkDeviceMemory& textureImageMemory);
+		VkResult uploadCompressedTextureImage(const TextureKtx2& texture, uint32_t baseLevel, VkBuffer stagingBuffer, VkImage& textureImage, VkDeviceMemory& textureImageMemory);
+
+		// Uploads the levels from baseLevel on into a new image, and queues it to be swapped in.
+		void replaceTextureImage(uint32_t baseLevel, VkBuffer stagingBuffer, bool isStream);
+		void swapTextureImages();
 
 		VkResult buildUniformBuffer(VkBuffer *buffer, VkDeviceMemory *bufferMemory, const VkDeviceSize size);
 
@@ -157,15 +329,16 @@ namespace vox {
 		template<class T>
 		VkResult buildIndexBuffer(VkBuffer *buffer, VkDeviceMemory *bufferMemory, const std::vector<T> &data);
 
-		void copyBuffer(VkBuffer srcBuffer, VkBuffer destBuffer, VkDeviceSize bufferSize);
+		uint64_t copyBuffer(VkBuffer srcBuffer, VkBuffer destBuffer, VkDeviceSize bufferSize);
 
-		VkResult copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
+		uint64_t copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
+		uint64_t copyBufferToImage(VkBuffer buffer, VkImage image, const std::vector<VkBufferImageCopy>& regions);
 
-		VkResult buildSampler(VkSampler* sampler, VkFilter magFilter = VK_FILTER_LINEAR, VkFilter minFilter = VK_FILTER_LINEAR, VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT, float maxAnisotropy = 1.0f, VkBorderColor borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK, bool compareEnable = false, VkCompareOp compareOp = VK_COMPARE_OP_ALWAYS, VkSamplerMipmapMode mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR, float mipLodBias = 0.0f, float minLod = 0.0f, float maxLod = 0.0f) const;
+		uint64_t generateMipmaps(VkImage image, VkFormat format, uint32_t width, uint32_t height, uint32_t mipLevels);
 
-		VkResult buildCommandPool(VkCommandPool *pool, uint32_t queueFamilyIndex, VkCommandPoolCreateFlags flags) const;
+		VkResult buildSampler(VkSampler* sampler, VkFilter magFilter = VK_FILTER_LINEAR, VkFilter minFilter = VK_FILTER_LINEAR, VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT, float maxAnisotropy = 1.0f, VkBorderColor borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK, bool compareEnable = false, VkCompareOp compareOp = VK_COMPARE_OP_ALWAYS, VkSamplerMipmapMode mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR, float mipLodBias = 0.0f, float minLod = 0.0f, float maxLod = VK_LOD_CLAMP_NONE);
 
-		VkResult buildFramebuffer(VkFramebuffer* framebuffer, VkRenderPass renderPass, const std::vector<VkImageView> &attachments, uint32_t width, uint32_t height, uint32_t layers = 1) const;
+		VkResult buildCommandPool(VkCommandPool *pool, uint32_t queueFamilyIndex, VkCommandPoolCreateFlags flags) const;
 
 		VkSurfaceFormatKHR selectSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& surfaceFormats);
 		VkPresentModeKHR selectSwapPresentMode(const std::vector<VkPresentModeKHR>& presentModes);
@@ -179,13 +352,27 @@ namespace vox {
 
 		bool hasSamplerAnisotropySupport(VkPhysicalDeviceFeatures physicalDeviceFeatures);
 		bool hasExtensionSupport(VkPhysicalDevice vkPhysicalDevice);
+		bool hasDescriptorIndexingSupport(VkPhysicalDevice physicalDevice);
+		bool hasTimelineSemaphoreSupport(VkPhysicalDevice physicalDevice);
 		bool hasRequiredFeatures(VkPhysicalDevice physicalDevice);
 
 		uint32_t getMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags memoryPropertyFlags);
 
+		uint32_t getTextureTableCapacity();
+
+		uint32_t getPipelineThreadCount() const;
+		static uint32_t getPipelineCopyCount();
+		uint32_t getRecordThreadCount() const;
+		static uint32_t getFramesInFlight();
+		static uint32_t getDrawCount();
+		static uint32_t getBenchmarkFrameCount();
+
+		float getScreenSize(const MeshBounds& bounds) const;
+
 		QueueFamilies getQueueFamilies(VkPhysicalDevice physicalDevice);
 
 		void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+		void recordMainPass(const RenderGraphContext& context);
 
 		VkFormat findSupportedFormat(const std::vector<VkFormat>& formats, VkImageTiling imageTiling, VkFormatFeatureFlags formatFatureFlags);
 
@@ -193,6 +380,8 @@ namespace vox {
 
 		bool hasStencilComponent(VkFormat vkFormat);
 
+		bool hasFormatSupport(VkFormat vkFormat, VkFormatFeatureFlags formatFeatureFlags);
+
 		void handleInput(GLFWwindow *window, float timeDelta);
 		static void handleMouseScroll(GLFWwindow *window, double x, double y);
 		static void handleFramebufferResize(GLFWwindow *window, int width, int height);
@@ -213,31 +402,43 @@ namespace vox {
 		void initLogicalDevice();
 		void initSwapchain();
 		void initImageViews();
-		void initRenderPass();
+		void initRenderGraph();
 		void initDescriptorSetLayouts();
+		void initPipelineCache();
 		void initPipeline();
-		void initFramebuffers();
 		void initCommandPools();
 		void initVertexBuffer();
 		void initIndexBuffer();
 		void initUniformBuffers();
 		void initUniformBufferObjects();
-		void initDescriptorPool();
 		void initDescriptorSets();
-		void initDepthResources();
 		void initTextureImage();
 		void initTextureImageView();
 		void initTextureSampler();
+		void initTextureAtlases();
+		void initTextureTable();
+		void initTextureResidency();
 		void initCommandBuffers();
+		void initTimelines();
 		void initSyncObjects();
+		void initSwapchainSyncObjects();
 
 		void uploadModels();
 
+		void uploadTextureAtlas(uint32_t atlasId, VkImageLayout oldLayout);
+		void updateTextureAtlases();
+		void updateTextureResidency();
+		void updateShaders();
+
 		void updateUniformBuffers(uint32_t currentImage);
 
-		void executeImmediateCommand(std::function<void(VkCommandBuffer cmd)> &&function) const;
+		// Submits the recorded commands without waiting for them, and returns the timeline value they signal.
+		uint64_t executeImmediateCommand(std::function<void(VkCommandBuffer cmd)> &&function);
+
+		// Destroys a buffer once every submission made so far has finished.
+		void retireBuffer(VkBuffer buffer, VkDeviceMemory bufferMemory);
 
-		void transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout) const;
+		uint64_t transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels = 1);
 
 		void freeVkSwapchain();
 		void resetVkSwapchain();
@@ -246,6 +447,7 @@ namespace vox {
 		void drawImGui();
 
 		void loop();
+		void logBenchmark() const;
 		void free();
 
 		static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity, VkDebugUtilsMessageTypeFlagsEXT messageType, const VkDebugUtilsMessengerCallbackDataEXT* callbackData, void* userData);
@@ -285,8 +487,7 @@ namespace vox {
 
 		copyBuffer(stagingBuffer, *buffer, bufferSize);
 
-		vkDestroyBuffer(mainLogicalDevice, stagingBuffer, nullptr);
-		vkFreeMemory(mainLogicalDevice, stagingBufferMemory, nullptr);
+		retireBuffer(stagingBuffer, stagingBufferMemory);
 
 		return VK_SUCCESS;
 	}
@@ -321,8 +522,7 @@ namespace vox {
 
 		copyBuffer(stagingBuffer, *buffer, bufferSize);
 
-		vkDestroyBuffer(mainLogicalDevice, stagingBuffer, nullptr);
-		vkFreeMemory(mainLogicalDevice, stagingBufferMemory, nullptr);
+		retireBuffer(stagingBuffer, stagingBufferMemory);
 
 		return VK_SUCCESS;
 	}
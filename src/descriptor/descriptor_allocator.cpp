@@ -0,0 +1,305 @@
+#include "descriptor_allocator.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "../misc/constants.h"
+
+namespace {
+    // Descriptors of each type a pool holds per set it is created for.
+    constexpr std::array POOL_RATIOS = {
+        VkDescriptorPoolSize { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2 },
+        VkDescriptorPoolSize { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2 },
+        VkDescriptorPoolSize { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1 },
+        VkDescriptorPoolSize { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1 },
+        VkDescriptorPoolSize { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1 },
+        VkDescriptorPoolSize { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1 },
+        VkDescriptorPoolSize { VK_DESCRIPTOR_TYPE_SAMPLER, 1 }
+    };
+
+    // Non-dispatchable handles are pointers on 64-bit platforms, and integers elsewhere.
+    template<typename T>
+    uint64_t getHandleBits(const T handle) {
+        uint64_t bits = 0;
+        std::memcpy(&bits, &handle, sizeof(handle));
+
+        return bits;
+    }
+
+    bool isPooled(const VkDescriptorType type) {
+        return std::ranges::any_of(POOL_RATIOS, [&](const VkDescriptorPoolSize& size) { return size.type == type; });
+    }
+
+    bool isImageType(const VkDescriptorType type) {
+        switch (type) {
+            case VK_DESCRIPTOR_TYPE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+            case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+                return true;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+                return false;
+            default:
+                throw std::runtime_error("[Descriptor] Unsupported descriptor type in cached set: " + std::to_string(type));
+        }
+    }
+
+    // A full pool reports either error, depending on the driver.
+    bool isPoolExhausted(const VkResult result) {
+        return result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL;
+    }
+
+    VkResult allocateFrom(const VkDevice& device, const VkDescriptorPool pool, const VkDescriptorSetLayout layout, VkDescriptorSet& set) {
+        VkDescriptorSetAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocateInfo.descriptorPool = pool;
+        allocateInfo.descriptorSetCount = 1;
+        allocateInfo.pSetLayouts = &layout;
+
+        return vkAllocateDescriptorSets(device, &allocateInfo, &set);
+    }
+}
+
+vox::DescriptorAllocator::DescriptorAllocator(const uint32_t frameCount)
+        : transientPools(frameCount),
+          nextPoolSetCount(DESCRIPTOR_POOL_SET_COUNT) {
+}
+
+VkDescriptorPool vox::DescriptorAllocator::buildPool(const VkDevice& device) {
+    std::array<VkDescriptorPoolSize, POOL_RATIOS.size()> sizes = {};
+
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        sizes[i] = { POOL_RATIOS[i].type, POOL_RATIOS[i].descriptorCount * nextPoolSetCount };
+    }
+
+    VkDescriptorPoolCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    createInfo.poolSizeCount = static_cast<uint32_t>(sizes.size());
+    createInfo.pPoolSizes = sizes.data();
+    createInfo.maxSets = nextPoolSetCount;
+
+    VkDescriptorPool pool;
+
+    if (VK_SUCCESS != vkCreateDescriptorPool(device, &createInfo, nullptr, &pool)) {
+        throw std::runtime_error("[Descriptor] Failed to create descriptor pool!");
+    }
+
+    nextPoolSetCount = std::min(nextPoolSetCount * 2, DESCRIPTOR_POOL_MAX_SET_COUNT);
+
+    return pool;
+}
+
+VkResult vox::DescriptorAllocator::allocate(const VkDevice& device, const VkDescriptorSetLayout layout, VkDescriptorSet& set) {
+    if (!pools.empty()) {
+        if (const auto result = allocateFrom(device, pools.back(), layout, set); !isPoolExhausted(result)) {
+            return result;
+        }
+    }
+
+    pools.push_back(buildPool(device));
+
+    const auto result = allocateFrom(device, pools.back(), layout, set);
+
+    // Not even an empty pool fits the set, so every further pool would be wasted too.
+    if (isPoolExhausted(result)) {
+        throw std::runtime_error("[Descriptor] Descriptor set layout does not fit in an empty pool!");
+    }
+
+    return result;
+}
+
+VkResult vox::DescriptorAllocator::allocateTransient(const VkDevice& device, const uint32_t frame, const VkDescriptorSetLayout layout, VkDescriptorSet& set) {
+    auto& [framePools, current] = transientPools.at(frame);
+
+    // Pools emptied by the last reset are reused before any new one is created.
+    for (; current < framePools.size(); ++current) {
+        if (const auto result = allocateFrom(device, framePools[current], layout, set); !isPoolExhausted(result)) {
+            return result;
+        }
+    }
+
+    framePools.push_back(buildPool(device));
+
+    const auto result = allocateFrom(device, framePools[current], layout, set);
+
+    if (isPoolExhausted(result)) {
+        throw std::runtime_error("[Descriptor] Descriptor set layout does not fit in an empty pool!");
+    }
+
+    return result;
+}
+
+void vox::DescriptorAllocator::resetTransient(const VkDevice& device, const uint32_t frame) {
+    auto& [framePools, current] = transientPools.at(frame);
+
+    for (size_t i = 0; i < framePools.size() && i <= current; ++i) {
+        vkResetDescriptorPool(device, framePools[i], 0);
+    }
+
+    current = 0;
+}
+
+vox::Hash128 vox::DescriptorAllocator::getKey(const VkDescriptorSetLayout layout, const std::span<const DescriptorWrite> writes) {
+    std::vector<uint64_t> words;
+    words.reserve(1 + writes.size() * 5);
+
+    words.push_back(getHandleBits(layout));
+
+    for (const auto& write : writes) {
+        words.push_back(write.binding);
+        words.push_back(write.type);
+
+        if (isImageType(write.type)) {
+            words.push_back(getHandleBits(write.imageInfo.sampler));
+            words.push_back(getHandleBits(write.imageInfo.imageView));
+            words.push_back(write.imageInfo.imageLayout);
+        } else {
+            words.push_back(getHandleBits(write.bufferInfo.buffer));
+            words.push_back(write.bufferInfo.offset);
+            words.push_back(write.bufferInfo.range);
+        }
+    }
+
+    return hash128(std::span(reinterpret_cast<const uint8_t*>(words.data()), words.size() * sizeof(uint64_t)));
+}
+
+VkResult vox::DescriptorAllocator::getCached(const VkDevice& device, const VkDescriptorSetLayout layout, const std::span<const DescriptorWrite> writes, VkDescriptorSet& set) {
+    const auto key = getKey(layout, writes);
+
+    if (const auto cached = cachedSets.find(key); cached != cachedSets.end()) {
+        set = cached->second.set;
+
+        return VK_SUCCESS;
+    }
+
+    std::vector<VkImageView> imageViews;
+
+    for (const auto& write : writes) {
+        if (!isPooled(write.type)) {
+            throw std::runtime_error("[Descriptor] Pools hold no descriptors of type " + std::to_string(write.type) + "!");
+        }
+
+        if (isImageType(write.type) && write.imageInfo.imageView != VK_NULL_HANDLE) {
+            imageViews.push_back(write.imageInfo.imageView);
+        }
+    }
+
+    std::ranges::sort(imageViews);
+    imageViews.erase(std::ranges::unique(imageViews).begin(), imageViews.end());
+
+    if (const auto freeSet = freeSets.find(getHandleBits(layout)); freeSet != freeSets.end() && !freeSet->second.empty()) {
+        set = freeSet->second.back();
+        freeSet->second.pop_back();
+    } else if (const auto result = allocate(device, layout, set); result != VK_SUCCESS) {
+        return result;
+    }
+
+    std::vector<VkWriteDescriptorSet> descriptorWrites;
+    descriptorWrites.reserve(writes.size());
+
+    for (const auto& write : writes) {
+        VkWriteDescriptorSet descriptorWrite = {};
+        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrite.dstSet = set;
+        descriptorWrite.dstBinding = write.binding;
+        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.descriptorType = write.type;
+        descriptorWrite.descriptorCount = 1;
+
+        if (isImageType(write.type)) {
+            descriptorWrite.pImageInfo = &write.imageInfo;
+        } else {
+            descriptorWrite.pBufferInfo = &write.bufferInfo;
+        }
+
+        descriptorWrites.push_back(descriptorWrite);
+    }
+
+    if (!descriptorWrites.empty()) {
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+    }
+
+    for (const auto imageView : imageViews) {
+        imageViewKeys[getHandleBits(imageView)].push_back(key);
+    }
+
+    cachedSets.emplace(key, CachedSet { set, layout, std::move(imageViews) });
+
+    return VK_SUCCESS;
+}
+
+void vox::DescriptorAllocator::evict(const VkImageView imageView) {
+    const auto keys = imageViewKeys.find(getHandleBits(imageView));
+
+    if (keys == imageViewKeys.end()) {
+        return;
+    }
+
+    const auto evictedKeys = std::move(keys->second);
+    imageViewKeys.erase(keys);
+
+    for (const auto& key : evictedKeys) {
+        const auto cached = cachedSets.find(key);
+
+        if (cached == cachedSets.end()) continue;
+
+        // The set goes from the lists of the other views written to it as well.
+        for (const auto other : cached->second.imageViews) {
+            if (other == imageView) continue;
+
+            if (const auto otherKeys = imageViewKeys.find(getHandleBits(other)); otherKeys != imageViewKeys.end()) {
+                std::erase(otherKeys->second, key);
+
+                if (otherKeys->second.empty()) {
+                    imageViewKeys.erase(otherKeys);
+                }
+            }
+        }
+
+        freeSets[getHandleBits(cached->second.layout)].push_back(cached->second.set);
+        cachedSets.erase(cached);
+    }
+}
+
+void vox::DescriptorAllocator::destroy(const VkDevice& device) {
+    for (const auto pool : pools) {
+        vkDestroyDescriptorPool(device, pool, nullptr);
+    }
+
+    for (auto& [framePools, current] : transientPools) {
+        for (const auto pool : framePools) {
+            vkDestroyDescriptorPool(device, pool, nullptr);
+        }
+
+        framePools.clear();
+        current = 0;
+    }
+
+    pools.clear();
+    cachedSets.clear();
+    imageViewKeys.clear();
+    freeSets.clear();
+
+    nextPoolSetCount = DESCRIPTOR_POOL_SET_COUNT;
+}
+
+size_t vox::DescriptorAllocator::getPoolCount() const {
+    auto count = pools.size();
+
+    for (const auto& framePools : transientPools) {
+        count += framePools.pools.size();
+    }
+
+    return count;
+}
+
+size_t vox::DescriptorAllocator::getCachedSetCount() const {
+    return cachedSets.size();
+}
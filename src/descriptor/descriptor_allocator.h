@@ -0,0 +1,113 @@
+#ifndef VOX_DESCRIPTOR_ALLOCATOR_H
+#define VOX_DESCRIPTOR_ALLOCATOR_H
+
+/**
+ * Descriptor set allocator, over pools that are added as they fill up.
+ *
+ * Sets come from three places:
+ * - persistent pools, for sets that live as long as the allocator;
+ * - transient pools, one list per frame in flight, reset wholesale once
+ *   that frame's fence passed, so per-frame sets are never freed one by one;
+ * - a cache of written sets, keyed by a hash of their layout and contents.
+ *
+ * Cached sets are never rewritten while cached. Binding something else
+ * looks up (or writes) another set, so frames still in flight keep reading
+ * the old one, and rebinding what was bound before allocates nothing.
+ * Before an image view is destroyed, evict() drops the sets written with
+ * it, as a later view may be given the same handle; evicted sets are
+ * rewritten for the next sets of their layout.
+ *
+ * Pools are only created when the existing ones run out, so a steady
+ * workload stops allocating after its first frames.
+ */
+
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan_core.h>
+
+#include "../misc/hash.h"
+
+namespace vox {
+    // One buffer or image written to a binding of a cached set.
+    struct DescriptorWrite {
+        uint32_t binding;
+        VkDescriptorType type;
+
+        // Only the one matching the type is read.
+        VkDescriptorBufferInfo bufferInfo;
+        VkDescriptorImageInfo imageInfo;
+    };
+
+    class DescriptorAllocator {
+        struct TransientPools {
+            std::vector<VkDescriptorPool> pools = {};
+
+            // Pool sets are currently taken from; the ones before it are full.
+            size_t current = 0;
+        };
+
+        std::vector<VkDescriptorPool> pools = {};
+        std::vector<TransientPools> transientPools;
+
+        struct CachedSet {
+            VkDescriptorSet set;
+            VkDescriptorSetLayout layout;
+
+            // Distinct views written to the set.
+            std::vector<VkImageView> imageViews;
+        };
+
+        std::unordered_map<Hash128, CachedSet> cachedSets = {};
+
+        // Keys of the cached sets written with each image view, for evict().
+        std::unordered_map<uint64_t, std::vector<Hash128>> imageViewKeys = {};
+
+        // Evicted sets, by layout; reused before anything is allocated.
+        std::unordered_map<uint64_t, std::vector<VkDescriptorSet>> freeSets = {};
+
+        // Sets the next pool is created for; doubles with every pool, up to DESCRIPTOR_POOL_MAX_SET_COUNT.
+        uint32_t nextPoolSetCount;
+
+        [[nodiscard]] VkDescriptorPool buildPool(const VkDevice& device);
+
+        [[nodiscard]] static Hash128 getKey(VkDescriptorSetLayout layout, std::span<const DescriptorWrite> writes);
+
+    public:
+        explicit DescriptorAllocator(uint32_t frameCount);
+
+        DescriptorAllocator(const DescriptorAllocator& other) = delete;
+
+        DescriptorAllocator(DescriptorAllocator&& other) noexcept = delete;
+
+        DescriptorAllocator& operator=(const DescriptorAllocator& other) = delete;
+
+        DescriptorAllocator& operator=(DescriptorAllocator&& other) = delete;
+
+        ~DescriptorAllocator() = default;
+
+        // Allocates a set that lives until the allocator is destroyed.
+        VkResult allocate(const VkDevice& device, VkDescriptorSetLayout layout, VkDescriptorSet& set);
+
+        // Allocates a set that lives until resetTransient is called for the same frame.
+        VkResult allocateTransient(const VkDevice& device, uint32_t frame, VkDescriptorSetLayout layout, VkDescriptorSet& set);
+
+        // Frees every transient set of a frame at once; its fence must have passed.
+        void resetTransient(const VkDevice& device, uint32_t frame);
+
+        // Returns the set of the layout holding exactly the given writes, writing a new one on first use.
+        VkResult getCached(const VkDevice& device, VkDescriptorSetLayout layout, std::span<const DescriptorWrite> writes, VkDescriptorSet& set);
+
+        // Drops every cached set written with an image view, which is about to be destroyed; no frame may still use them.
+        void evict(VkImageView imageView);
+
+        void destroy(const VkDevice& device);
+
+        [[nodiscard]] size_t getPoolCount() const;
+        [[nodiscard]] size_t getCachedSetCount() const;
+    };
+}
+
+#endif
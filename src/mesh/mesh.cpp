@@ -13,6 +13,21 @@ vox::Material &vox::Mesh::getMaterial() {
     return material;
 }
 
+vox::MeshBounds vox::Mesh::getBounds() const {
+    if (vertices.empty()) {
+        return { glm::vec3(0.0f), glm::vec3(0.0f) };
+    }
+
+    MeshBounds bounds = { vertices.front().pos, vertices.front().pos };
+
+    for (const auto& vertex : vertices) {
+        bounds.min = glm::min(bounds.min, vertex.pos);
+        bounds.max = glm::max(bounds.max, vertex.pos);
+    }
+
+    return bounds;
+}
+
 void vox::Mesh::setMaterial(vox::Material material) {
     this->material = std::move(material);
 }
@@ -8,6 +8,12 @@
 #include "../material/material.h"
 
 namespace vox {
+    // Axis-aligned bounding box, in model space.
+    struct MeshBounds {
+        glm::vec3 min;
+        glm::vec3 max;
+    };
+
     class Mesh {
         std::vector<Vertex> vertices;
         std::vector<uint32_t> indices;
@@ -28,6 +34,8 @@ namespace vox {
 
         [[nodiscard]] Material& getMaterial();
 
+        [[nodiscard]] MeshBounds getBounds() const;
+
         void setMaterial(Material material);
     };
 }
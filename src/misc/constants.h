@@ -7,9 +7,82 @@
 #include <cstdint>
 
 
-constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+// Frames the CPU may record ahead of the GPU, unless VOX_FRAMES_IN_FLIGHT says otherwise.
+constexpr uint32_t DEFAULT_FRAMES_IN_FLIGHT = 2;
+
+// Upper bound of VOX_FRAMES_IN_FLIGHT; every frame in flight has its own command buffer, uniforms and sets.
+constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 4;
 
 constexpr auto DEFAULT_WIDTH = 800;
 constexpr auto DEFAULT_HEIGHT = 600;
 
+// Gutter left around every texture packed into an atlas.
+constexpr uint32_t ATLAS_PADDING = 2;
+
+// Atlas cells are aligned to 2^(ATLAS_MIP_LEVELS - 1) texels, so that
+// this many mip levels can be generated without textures bleeding.
+constexpr uint32_t ATLAS_MIP_LEVELS = 5;
+
+// Atlas pages are repacked in the background once this much of their
+// free space lies outside their largest free rectangle.
+constexpr float ATLAS_COMPACTION_THRESHOLD = 0.5f;
+
+// Directory of the content-addressed texture cache.
+constexpr auto TEXTURE_CACHE_DIRECTORY = "cache/textures";
+
+// Bump whenever cached payloads change (encoder, mip filter, container),
+// which invalidates every entry written by earlier versions.
+constexpr uint64_t TEXTURE_CACHE_VERSION = 1;
+
+// File the driver's pipeline cache is kept in between launches.
+constexpr auto PIPELINE_CACHE_PATH = "cache/pipelines.bin";
+
+// Bump whenever the pipeline cache file header changes.
+constexpr uint32_t PIPELINE_CACHE_VERSION = 1;
+
+// Upper bound of VOX_PIPELINE_COPIES; every copy holds a pipeline until all of them are built.
+constexpr uint32_t MAX_PIPELINE_COPIES = 256;
+
+// Upper bound of VOX_BENCHMARK_FRAMES, the frames a benchmark run draws before it exits.
+constexpr uint32_t MAX_BENCHMARK_FRAMES = 100000;
+
+// Frames a benchmark run draws before those it measures, past the hitches of the first ones.
+constexpr uint32_t BENCHMARK_WARMUP_FRAMES = 60;
+
+// GPU memory textures may use before their least recently used levels are evicted.
+constexpr uint64_t TEXTURE_RESIDENCY_BUDGET = 64ull * 1024 * 1024;
+
+// Residency ids of atlas textures are their texture ids with this bit set, apart from the texture table indices of standalone textures.
+constexpr uint32_t TEXTURE_RESIDENCY_ATLAS_BIT = 1u << 31;
+
+// Residency events kept for the overlay.
+constexpr uint32_t TEXTURE_RESIDENCY_EVENT_COUNT = 32;
+
+// Uniform block each shader owns, and fills through setUniform.
+constexpr auto SHADER_UNIFORM_BLOCK = "Extras";
+
+// Slots in the bindless texture table, clamped to what the device supports.
+constexpr uint32_t TEXTURE_TABLE_CAPACITY = 1024;
+
+// Sets the first descriptor pool is created for; every pool added after it doubles that.
+constexpr uint32_t DESCRIPTOR_POOL_SET_COUNT = 32;
+
+// Sets no single descriptor pool is created for more than.
+constexpr uint32_t DESCRIPTOR_POOL_MAX_SET_COUNT = 1024;
+
+// Milliseconds between scans of the shader directories for edited files.
+constexpr uint32_t SHADER_WATCH_INTERVAL = 250;
+
+// Descriptor sets a draw in the render queue binds at most.
+constexpr uint32_t RENDER_QUEUE_MAX_DESCRIPTOR_SETS = 4;
+
+// Draws below which recording stays on fewer workers, since every extra secondary starts with a full set of binds.
+constexpr uint32_t RENDER_QUEUE_MIN_DRAWS_PER_THREAD = 128;
+
+// Upper bound of VOX_DRAW_COUNT, the copies of the scene drawn to measure recording.
+constexpr uint32_t MAX_DRAW_COUNT = 65536;
+
+// Distance between neighbouring copies of the scene, laid out in a grid.
+constexpr float DRAW_GRID_SPACING = 2.5f;
+
 #endif //CONSTANTS_H
@@ -0,0 +1,292 @@
+#ifndef VOX_GLM_TYPE_H
+#define VOX_GLM_TYPE_H
+
+/**
+ * Compile-time registry of the GLM/GLSL types shaders share with the CPU.
+ *
+ * Every type is an enum value indexing a constexpr table of its Vulkan
+ * format, size and std140 alignment. Names from shader metadata are
+ * parsed once, through a perfect hash whose seed is searched for at
+ * compile time, so a name is only compared against its one candidate;
+ * C++ types (toVkFormat) and SPIR-V types (reflection) are resolved by
+ * their shape, which indexes a second table directly.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#define GLM_FORCE_DEFAULT_ALIGNED_GENTYPES
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/glm.hpp>
+
+#include <vulkan/vulkan_core.h>
+
+namespace vox {
+    enum class GLMType : uint8_t {
+        Float, Double, Int, Uint,
+        Vec2, Vec3, Vec4,
+        IVec2, IVec3, IVec4,
+        UVec2, UVec3, UVec4,
+        DVec2, DVec3, DVec4,
+        Bool, BVec2, BVec3, BVec4,
+        Mat2, Mat3, Mat4,
+        DMat2, DMat3, DMat4,
+        // The camera's UniformBufferObject, as named in shader metadata.
+        Ubo
+    };
+
+    enum class GLMComponent : uint8_t {
+        Float,
+        Double,
+        Int,
+        Uint,
+        Bool,
+        None
+    };
+
+    struct UniformBufferObject {
+        alignas(16) glm::mat4 model;
+        alignas(16) glm::mat4 view;
+        alignas(16) glm::mat4 proj;
+    };
+
+    struct GLMTypeInfo {
+        GLMType type;
+        std::string_view name;
+
+        // VK_FORMAT_UNDEFINED for types that cannot be a vertex attribute.
+        VkFormat format;
+
+        size_t size;
+
+        // std140 base alignment, 0 for types that cannot be a uniform block member.
+        size_t alignment;
+
+        GLMComponent component;
+        uint32_t rows;
+        uint32_t columns;
+    };
+
+    constexpr std::array GLM_TYPES = {
+        GLMTypeInfo { GLMType::Float, "float", VK_FORMAT_R32_SFLOAT, sizeof(float), 4, GLMComponent::Float, 1, 1 },
+        GLMTypeInfo { GLMType::Double, "double", VK_FORMAT_R64_SFLOAT, sizeof(double), 8, GLMComponent::Double, 1, 1 },
+        GLMTypeInfo { GLMType::Int, "int", VK_FORMAT_R32_SINT, sizeof(int32_t), 4, GLMComponent::Int, 1, 1 },
+        GLMTypeInfo { GLMType::Uint, "uint", VK_FORMAT_R32_UINT, sizeof(uint32_t), 4, GLMComponent::Uint, 1, 1 },
+
+        GLMTypeInfo { GLMType::Vec2, "vec2", VK_FORMAT_R32G32_SFLOAT, sizeof(glm::vec2), 8, GLMComponent::Float, 2, 1 },
+        GLMTypeInfo { GLMType::Vec3, "vec3", VK_FORMAT_R32G32B32_SFLOAT, sizeof(glm::vec3), 16, GLMComponent::Float, 3, 1 },
+        GLMTypeInfo { GLMType::Vec4, "vec4", VK_FORMAT_R32G32B32A32_SFLOAT, sizeof(glm::vec4), 16, GLMComponent::Float, 4, 1 },
+
+        GLMTypeInfo { GLMType::IVec2, "ivec2", VK_FORMAT_R32G32_SINT, sizeof(glm::ivec2), 8, GLMComponent::Int, 2, 1 },
+        GLMTypeInfo { GLMType::IVec3, "ivec3", VK_FORMAT_R32G32B32_SINT, sizeof(glm::ivec3), 16, GLMComponent::Int, 3, 1 },
+        GLMTypeInfo { GLMType::IVec4, "ivec4", VK_FORMAT_R32G32B32A32_SINT, sizeof(glm::ivec4), 16, GLMComponent::Int, 4, 1 },
+
+        GLMTypeInfo { GLMType::UVec2, "uvec2", VK_FORMAT_R32G32_UINT, sizeof(glm::uvec2), 8, GLMComponent::Uint, 2, 1 },
+        GLMTypeInfo { GLMType::UVec3, "uvec3", VK_FORMAT_R32G32B32_UINT, sizeof(glm::uvec3), 16, GLMComponent::Uint, 3, 1 },
+        GLMTypeInfo { GLMType::UVec4, "uvec4", VK_FORMAT_R32G32B32A32_UINT, sizeof(glm::uvec4), 16, GLMComponent::Uint, 4, 1 },
+
+        GLMTypeInfo { GLMType::DVec2, "dvec2", VK_FORMAT_R64G64_SFLOAT, sizeof(glm::dvec2), 16, GLMComponent::Double, 2, 1 },
+        GLMTypeInfo { GLMType::DVec3, "dvec3", VK_FORMAT_R64G64B64_SFLOAT, sizeof(glm::dvec3), 32, GLMComponent::Double, 3, 1 },
+        GLMTypeInfo { GLMType::DVec4, "dvec4", VK_FORMAT_R64G64B64A64_SFLOAT, sizeof(glm::dvec4), 32, GLMComponent::Double, 4, 1 },
+
+        // Booleans are often represented as uints; in blocks, a bool takes the 4 bytes of one.
+        GLMTypeInfo { GLMType::Bool, "bool", VK_FORMAT_R8_UINT, sizeof(bool), 4, GLMComponent::Bool, 1, 1 },
+        GLMTypeInfo { GLMType::BVec2, "bvec2", VK_FORMAT_R8G8_UINT, sizeof(glm::bvec2), 8, GLMComponent::Bool, 2, 1 },
+        GLMTypeInfo { GLMType::BVec3, "bvec3", VK_FORMAT_R8G8B8_UINT, sizeof(glm::bvec3), 16, GLMComponent::Bool, 3, 1 },
+        GLMTypeInfo { GLMType::BVec4, "bvec4", VK_FORMAT_R8G8B8A8_UINT, sizeof(glm::bvec4), 16, GLMComponent::Bool, 4, 1 },
+
+        // Matrices are not directly supported by Vulkan as attributes.
+        GLMTypeInfo { GLMType::Mat2, "mat2", VK_FORMAT_UNDEFINED, sizeof(glm::mat2), 16, GLMComponent::Float, 2, 2 },
+        GLMTypeInfo { GLMType::Mat3, "mat3", VK_FORMAT_UNDEFINED, sizeof(glm::mat3), 16, GLMComponent::Float, 3, 3 },
+        GLMTypeInfo { GLMType::Mat4, "mat4", VK_FORMAT_UNDEFINED, sizeof(glm::mat4), 16, GLMComponent::Float, 4, 4 },
+        GLMTypeInfo { GLMType::DMat2, "dmat2", VK_FORMAT_UNDEFINED, sizeof(glm::dmat2), 16, GLMComponent::Double, 2, 2 },
+        GLMTypeInfo { GLMType::DMat3, "dmat3", VK_FORMAT_UNDEFINED, sizeof(glm::dmat3), 32, GLMComponent::Double, 3, 3 },
+        GLMTypeInfo { GLMType::DMat4, "dmat4", VK_FORMAT_UNDEFINED, sizeof(glm::dmat4), 32, GLMComponent::Double, 4, 4 },
+
+        GLMTypeInfo { GLMType::Ubo, "ubo", VK_FORMAT_UNDEFINED, sizeof(UniformBufferObject), 0, GLMComponent::None, 0, 0 }
+    };
+
+    static_assert([] {
+        for (size_t i = 0; i < GLM_TYPES.size(); ++i) {
+            if (static_cast<size_t>(GLM_TYPES[i].type) != i) return false;
+        }
+
+        return true;
+    }(), "GLM_TYPES must list every GLMType, in order.");
+
+    constexpr const GLMTypeInfo& getGLMTypeInfo(const GLMType type) {
+        return GLM_TYPES[static_cast<size_t>(type)];
+    }
+
+    // Slots of the name lookup table, a power of two well above the number of types.
+    constexpr uint32_t GLM_TYPE_LOOKUP_SIZE = 64;
+
+    constexpr uint32_t hashGLMTypeName(const std::string_view name, const uint32_t seed) {
+        uint32_t hash = seed;
+
+        for (const auto c : name) {
+            hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+        }
+
+        // FNV-1a alone leaves its low bits depending only on the low bits of the input.
+        hash ^= hash >> 15;
+        hash *= 0x2C1B3C6Du;
+        hash ^= hash >> 12;
+
+        return hash & (GLM_TYPE_LOOKUP_SIZE - 1);
+    }
+
+    // First seed for which every type name hashes to a slot of its own.
+    constexpr uint32_t findGLMTypeHashSeed() {
+        for (uint32_t seed = 0; seed < 1u << 16; ++seed) {
+            std::array<bool, GLM_TYPE_LOOKUP_SIZE> used = {};
+
+            bool perfect = true;
+
+            for (const auto& info : GLM_TYPES) {
+                auto& slot = used[hashGLMTypeName(info.name, seed)];
+
+                perfect = perfect && !slot;
+                slot = true;
+            }
+
+            if (perfect) return seed;
+        }
+
+        throw std::logic_error("No perfect hash seed for the GLM type names!");
+    }
+
+    constexpr uint32_t GLM_TYPE_HASH_SEED = findGLMTypeHashSeed();
+
+    // Marks the slots of the lookup table no name hashes to.
+    constexpr uint8_t GLM_TYPE_LOOKUP_EMPTY = 0xFF;
+
+    constexpr std::array<uint8_t, GLM_TYPE_LOOKUP_SIZE> GLM_TYPE_LOOKUP = [] {
+        std::array<uint8_t, GLM_TYPE_LOOKUP_SIZE> lookup = {};
+        lookup.fill(GLM_TYPE_LOOKUP_EMPTY);
+
+        for (const auto& info : GLM_TYPES) {
+            lookup[hashGLMTypeName(info.name, GLM_TYPE_HASH_SEED)] = static_cast<uint8_t>(info.type);
+        }
+
+        return lookup;
+    }();
+
+    constexpr std::optional<GLMType> findGLMType(const std::string_view name) {
+        const auto index = GLM_TYPE_LOOKUP[hashGLMTypeName(name, GLM_TYPE_HASH_SEED)];
+
+        if (index != GLM_TYPE_LOOKUP_EMPTY && GLM_TYPES[index].name == name) {
+            return GLM_TYPES[index].type;
+        }
+
+        return std::nullopt;
+    }
+
+    // Shapes are at most 4 rows by 4 columns; the lookup table has a slot for each, per component.
+    constexpr uint32_t GLM_TYPE_MAX_DIMENSION = 4;
+
+    constexpr uint32_t GLM_TYPE_SHAPE_COUNT = static_cast<uint32_t>(GLMComponent::None) * GLM_TYPE_MAX_DIMENSION * GLM_TYPE_MAX_DIMENSION;
+
+    constexpr uint32_t getGLMTypeShapeIndex(const GLMComponent component, const uint32_t rows, const uint32_t columns) {
+        return (static_cast<uint32_t>(component) * GLM_TYPE_MAX_DIMENSION + rows - 1) * GLM_TYPE_MAX_DIMENSION + columns - 1;
+    }
+
+    constexpr std::array<uint8_t, GLM_TYPE_SHAPE_COUNT> GLM_TYPE_SHAPE_LOOKUP = [] {
+        std::array<uint8_t, GLM_TYPE_SHAPE_COUNT> lookup = {};
+        lookup.fill(GLM_TYPE_LOOKUP_EMPTY);
+
+        for (const auto& info : GLM_TYPES) {
+            if (info.component != GLMComponent::None) {
+                lookup[getGLMTypeShapeIndex(info.component, info.rows, info.columns)] = static_cast<uint8_t>(info.type);
+            }
+        }
+
+        return lookup;
+    }();
+
+    // Finds the type with the given component, rows per column and columns.
+    constexpr std::optional<GLMType> findGLMType(const GLMComponent component, const uint32_t rows, const uint32_t columns) {
+        if (component == GLMComponent::None || rows == 0 || rows > GLM_TYPE_MAX_DIMENSION || columns == 0 || columns > GLM_TYPE_MAX_DIMENSION) {
+            return std::nullopt;
+        }
+
+        if (const auto index = GLM_TYPE_SHAPE_LOOKUP[getGLMTypeShapeIndex(component, rows, columns)]; index != GLM_TYPE_LOOKUP_EMPTY) {
+            return GLM_TYPES[index].type;
+        }
+
+        return std::nullopt;
+    }
+
+    inline GLMType parseGLMType(const std::string_view name) {
+        if (const auto type = findGLMType(name); type.has_value()) {
+            return type.value();
+        }
+
+        throw std::runtime_error("Unsupported GLM type: " + std::string(name));
+    }
+
+    constexpr VkFormat GLMTypeToVkFormat(const GLMType type) {
+        if (const auto format = getGLMTypeInfo(type).format; format != VK_FORMAT_UNDEFINED) {
+            return format;
+        }
+
+        throw std::runtime_error("Unsupported GLM type for formats: " + std::string(getGLMTypeInfo(type).name));
+    }
+
+    constexpr size_t GLMTypeSize(const GLMType type) {
+        return getGLMTypeInfo(type).size;
+    }
+
+    constexpr size_t GLMTypeAlignment(const GLMType type) {
+        if (const auto alignment = getGLMTypeInfo(type).alignment; alignment != 0) {
+            return alignment;
+        }
+
+        throw std::runtime_error("Unsupported GLM type for alignment: " + std::string(getGLMTypeInfo(type).name));
+    }
+
+    template<typename T>
+    struct GLMShape {
+        static constexpr GLMComponent component =
+            std::is_same_v<T, float> ? GLMComponent::Float :
+            std::is_same_v<T, double> ? GLMComponent::Double :
+            std::is_same_v<T, int32_t> ? GLMComponent::Int :
+            std::is_same_v<T, uint32_t> ? GLMComponent::Uint :
+            std::is_same_v<T, bool> ? GLMComponent::Bool : GLMComponent::None;
+
+        static constexpr uint32_t rows = 1;
+        static constexpr uint32_t columns = 1;
+    };
+
+    template<glm::length_t L, typename T, glm::qualifier Q>
+    struct GLMShape<glm::vec<L, T, Q>> {
+        static constexpr GLMComponent component = GLMShape<T>::component;
+        static constexpr uint32_t rows = L;
+        static constexpr uint32_t columns = 1;
+    };
+
+    template<glm::length_t C, glm::length_t R, typename T, glm::qualifier Q>
+    struct GLMShape<glm::mat<C, R, T, Q>> {
+        static constexpr GLMComponent component = GLMShape<T>::component;
+        static constexpr uint32_t rows = R;
+        static constexpr uint32_t columns = C;
+    };
+
+    template<typename T>
+    constexpr GLMType GLMTypeOf = findGLMType(GLMShape<T>::component, GLMShape<T>::rows, GLMShape<T>::columns).value();
+
+    template<typename T>
+    constexpr VkFormat toVkFormat() {
+        return GLMTypeToVkFormat(GLMTypeOf<T>);
+    }
+}
+
+#endif
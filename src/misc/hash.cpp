@@ -0,0 +1,111 @@
+#include "hash.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    uint64_t rotateLeft(const uint64_t value, const int shift) {
+        return value << shift | value >> (64 - shift);
+    }
+
+    uint64_t finalizeMix(uint64_t value) {
+        value ^= value >> 33;
+        value *= 0xFF51AFD7ED558CCDull;
+        value ^= value >> 33;
+        value *= 0xC4CEB9FE1A85EC53ull;
+        value ^= value >> 33;
+
+        return value;
+    }
+}
+
+std::string vox::Hash128::toString() const {
+    constexpr char digits[] = "0123456789abcdef";
+
+    std::string result(32, '0');
+
+    for (int i = 0; i < 16; ++i) {
+        result[15 - i] = digits[high >> (i * 4) & 0xF];
+        result[31 - i] = digits[low >> (i * 4) & 0xF];
+    }
+
+    return result;
+}
+
+vox::Hash128 vox::hash128(const std::span<const uint8_t> data, const uint64_t seed) {
+    constexpr uint64_t c1 = 0x87C37B91114253D5ull;
+    constexpr uint64_t c2 = 0x4CF5AD432745937Full;
+
+    const auto blockCount = data.size() / 16;
+
+    auto h1 = seed;
+    auto h2 = seed;
+
+    for (size_t i = 0; i < blockCount; ++i) {
+        uint64_t k1;
+        uint64_t k2;
+
+        memcpy(&k1, data.data() + i * 16, 8);
+        memcpy(&k2, data.data() + i * 16 + 8, 8);
+
+        k1 *= c1;
+        k1 = rotateLeft(k1, 31);
+        k1 *= c2;
+        h1 ^= k1;
+
+        h1 = rotateLeft(h1, 27);
+        h1 += h2;
+        h1 = h1 * 5 + 0x52DCE729;
+
+        k2 *= c2;
+        k2 = rotateLeft(k2, 33);
+        k2 *= c1;
+        h2 ^= k2;
+
+        h2 = rotateLeft(h2, 31);
+        h2 += h1;
+        h2 = h2 * 5 + 0x38495AB5;
+    }
+
+    const auto* tail = data.data() + blockCount * 16;
+    const auto tailSize = data.size() & 15;
+
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+
+    for (auto i = tailSize; i > 8; --i) {
+        k2 ^= static_cast<uint64_t>(tail[i - 1]) << ((i - 9) * 8);
+    }
+
+    if (tailSize > 8) {
+        k2 *= c2;
+        k2 = rotateLeft(k2, 33);
+        k2 *= c1;
+        h2 ^= k2;
+    }
+
+    for (auto i = std::min<size_t>(tailSize, 8); i > 0; --i) {
+        k1 ^= static_cast<uint64_t>(tail[i - 1]) << ((i - 1) * 8);
+    }
+
+    if (tailSize > 0) {
+        k1 *= c1;
+        k1 = rotateLeft(k1, 31);
+        k1 *= c2;
+        h1 ^= k1;
+    }
+
+    h1 ^= data.size();
+    h2 ^= data.size();
+
+    h1 += h2;
+    h2 += h1;
+
+    h1 = finalizeMix(h1);
+    h2 = finalizeMix(h2);
+
+    h1 += h2;
+    h2 += h1;
+
+    return { h1, h2 };
+}
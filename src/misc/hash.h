@@ -0,0 +1,39 @@
+#ifndef VOX_HASH_H
+#define VOX_HASH_H
+
+/**
+ * 128-bit content hash (MurmurHash3, x64 variant).
+ *
+ * Used to key on-disk caches by the content of their source, so
+ * that renaming or touching a file never invalidates its entry and
+ * editing it always does. It is not a cryptographic hash.
+ */
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+
+namespace vox {
+    struct Hash128 {
+        uint64_t low = 0;
+        uint64_t high = 0;
+
+        // 32 lowercase hexadecimal digits, high half first.
+        [[nodiscard]] std::string toString() const;
+
+        bool operator==(const Hash128& other) const = default;
+    };
+
+    [[nodiscard]] Hash128 hash128(std::span<const uint8_t> data, uint64_t seed = 0);
+}
+
+// Both halves are already well mixed, so either one makes a good bucket hash.
+template<>
+struct std::hash<vox::Hash128> {
+    size_t operator()(const vox::Hash128& hash) const noexcept {
+        return static_cast<size_t>(hash.low);
+    }
+};
+
+#endif
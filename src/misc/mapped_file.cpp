@@ -0,0 +1,153 @@
+#include "mapped_file.h"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+vox::MappedFile::MappedFile(const std::string& path) {
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        fileHandle = nullptr;
+        throw std::runtime_error("[IO] Failed to open file: " + path + "\n");
+    }
+
+    LARGE_INTEGER fileSize;
+
+    if (!GetFileSizeEx(fileHandle, &fileSize)) {
+        release();
+        throw std::runtime_error("[IO] Failed to query file size: " + path + "\n");
+    }
+
+    size = static_cast<size_t>(fileSize.QuadPart);
+
+    // Empty files cannot be mapped, and do not need to be.
+    if (size == 0) {
+        return;
+    }
+
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (mappingHandle == nullptr) {
+        release();
+        throw std::runtime_error("[IO] Failed to map file: " + path + "\n");
+    }
+
+    data = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+
+    if (data == nullptr) {
+        release();
+        throw std::runtime_error("[IO] Failed to map file: " + path + "\n");
+    }
+}
+
+void vox::MappedFile::release() {
+    if (data != nullptr) {
+        UnmapViewOfFile(data);
+    }
+
+    if (mappingHandle != nullptr) {
+        CloseHandle(mappingHandle);
+    }
+
+    if (fileHandle != nullptr) {
+        CloseHandle(fileHandle);
+    }
+
+    data = nullptr;
+    size = 0;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+}
+#else
+vox::MappedFile::MappedFile(const std::string& path) {
+    const auto descriptor = open(path.c_str(), O_RDONLY);
+
+    if (descriptor < 0) {
+        throw std::runtime_error("[IO] Failed to open file: " + path + "\n");
+    }
+
+    struct stat status = {};
+
+    if (fstat(descriptor, &status) != 0) {
+        close(descriptor);
+        throw std::runtime_error("[IO] Failed to query file size: " + path + "\n");
+    }
+
+    size = static_cast<size_t>(status.st_size);
+
+    // Empty files cannot be mapped, and do not need to be.
+    if (size > 0) {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+        if (mapping == MAP_FAILED) {
+            close(descriptor);
+            throw std::runtime_error("[IO] Failed to map file: " + path + "\n");
+        }
+
+        // Mapped files are read front to back, once.
+        madvise(mapping, size, MADV_SEQUENTIAL);
+
+        data = static_cast<const uint8_t*>(mapping);
+    }
+
+    // The mapping keeps its own reference to the file.
+    close(descriptor);
+}
+
+void vox::MappedFile::release() {
+    if (data != nullptr) {
+        munmap(const_cast<uint8_t*>(data), size);
+    }
+
+    data = nullptr;
+    size = 0;
+}
+#endif
+
+vox::MappedFile::MappedFile(MappedFile&& other) noexcept
+        : data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0))
+#ifdef _WIN32
+        , fileHandle(std::exchange(other.fileHandle, nullptr)), mappingHandle(std::exchange(other.mappingHandle, nullptr))
+#endif
+{
+}
+
+vox::MappedFile& vox::MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+
+        data = std::exchange(other.data, nullptr);
+        size = std::exchange(other.size, 0);
+
+#ifdef _WIN32
+        fileHandle = std::exchange(other.fileHandle, nullptr);
+        mappingHandle = std::exchange(other.mappingHandle, nullptr);
+#endif
+    }
+
+    return *this;
+}
+
+vox::MappedFile::~MappedFile() {
+    release();
+}
+
+std::span<const uint8_t> vox::MappedFile::getBytes() const {
+    return { data, size };
+}
+
+size_t vox::MappedFile::getSize() const {
+    return size;
+}
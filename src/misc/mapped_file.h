@@ -0,0 +1,51 @@
+#ifndef VOX_MAPPED_FILE_H
+#define VOX_MAPPED_FILE_H
+
+/**
+ * Read-only memory mapping of a whole file.
+ *
+ * Pages are faulted in by the OS on first access, so reading a
+ * mapped file into a staging buffer costs one copy instead of a
+ * read into a temporary buffer followed by another copy.
+ *
+ * The mapping is released when the object is destroyed.
+ */
+
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace vox {
+    class MappedFile {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+
+#ifdef _WIN32
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+#endif
+
+        void release();
+
+    public:
+        MappedFile() = delete;
+
+        explicit MappedFile(const std::string& path);
+
+        MappedFile(const MappedFile& other) = delete;
+
+        MappedFile(MappedFile&& other) noexcept;
+
+        MappedFile& operator=(const MappedFile& other) = delete;
+
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        ~MappedFile();
+
+        [[nodiscard]] std::span<const uint8_t> getBytes() const;
+
+        [[nodiscard]] size_t getSize() const;
+    };
+}
+
+#endif
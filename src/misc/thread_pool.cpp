@@ -0,0 +1,79 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+
+vox::ThreadPool::ThreadPool(const uint32_t threadCount) {
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+vox::ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+
+    condition.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void vox::ThreadPool::work() {
+    while (true) {
+        std::function<void()> task;
+
+        {
+            std::unique_lock lock(mutex);
+            condition.wait(lock, [this] { return stopping || !tasks.empty(); });
+
+            if (stopping && tasks.empty()) {
+                return;
+            }
+
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+
+        task();
+    }
+}
+
+void vox::ThreadPool::parallelFor(const size_t count, const std::function<void(size_t)>& function, const uint32_t maxThreadCount) {
+    if (count == 0) {
+        return;
+    }
+
+    // Workers pull indices from a shared counter, so uneven
+    // task costs balance out without any up-front partitioning.
+    std::atomic<size_t> nextIndex = 0;
+
+    const auto runnerCount = std::min<size_t>({ count, workers.size(), std::max(1u, maxThreadCount) });
+
+    std::vector<std::future<void>> runners;
+    runners.reserve(runnerCount);
+
+    for (size_t i = 0; i < runnerCount; ++i) {
+        runners.push_back(submit([&nextIndex, &function, count] {
+            for (auto index = nextIndex++; index < count; index = nextIndex++) {
+                function(index);
+            }
+        }));
+    }
+
+    // Wait for every runner before rethrowing, since they reference this frame.
+    for (auto& runner : runners) {
+        runner.wait();
+    }
+
+    for (auto& runner : runners) {
+        runner.get();
+    }
+}
+
+uint32_t vox::ThreadPool::getThreadCount() const {
+    return static_cast<uint32_t>(workers.size());
+}
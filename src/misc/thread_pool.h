@@ -0,0 +1,79 @@
+#ifndef VOX_THREAD_POOL_H
+#define VOX_THREAD_POOL_H
+
+/**
+ * A fixed-size pool of worker threads, created once during
+ * start-up and shared by every subsystem that fans work out
+ * (texture decoding, pipeline creation, etc.).
+ *
+ * Tasks are executed in submission order, but may complete in
+ * any order; callers that need deterministic results should
+ * write them into pre-sized, index-addressed storage.
+ */
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace vox {
+    class ThreadPool {
+        std::vector<std::thread> workers = {};
+
+        std::queue<std::function<void()>> tasks = {};
+
+        std::mutex mutex;
+        std::condition_variable condition;
+
+        bool stopping = false;
+
+        void work();
+
+    public:
+        explicit ThreadPool(uint32_t threadCount = std::max(1u, std::thread::hardware_concurrency()));
+
+        ThreadPool(const ThreadPool& other) = delete;
+
+        ThreadPool(ThreadPool&& other) noexcept = delete;
+
+        ThreadPool& operator=(const ThreadPool& other) = delete;
+
+        ThreadPool& operator=(ThreadPool&& other) = delete;
+
+        ~ThreadPool();
+
+        template<typename F>
+        std::future<std::invoke_result_t<F>> submit(F&& function);
+
+        // Runs function(i) for every i in [0, count) across at most maxThreadCount
+        // workers, and blocks until all of them finished, rethrowing the first exception.
+        void parallelFor(size_t count, const std::function<void(size_t)>& function, uint32_t maxThreadCount = UINT32_MAX);
+
+        [[nodiscard]] uint32_t getThreadCount() const;
+    };
+
+    template<typename F>
+    std::future<std::invoke_result_t<F>> ThreadPool::submit(F&& function) {
+        // std::function must be copyable, so the task is shared.
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(function));
+        auto future = task->get_future();
+
+        {
+            std::lock_guard lock(mutex);
+            tasks.emplace([task] { (*task)(); });
+        }
+
+        condition.notify_one();
+
+        return future;
+    }
+}
+
+#endif
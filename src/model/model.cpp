@@ -65,6 +65,23 @@ namespace vox {
         return textures;
     }
 
+    MeshBounds Model::getBounds() const {
+        if (meshes.empty()) {
+            return { glm::vec3(0.0f), glm::vec3(0.0f) };
+        }
+
+        auto bounds = meshes.front().getBounds();
+
+        for (const auto& mesh : meshes) {
+            const auto meshBounds = mesh.getBounds();
+
+            bounds.min = glm::min(bounds.min, meshBounds.min);
+            bounds.max = glm::max(bounds.max, meshBounds.max);
+        }
+
+        return bounds;
+    }
+
     void Model::addMesh(Mesh &&mesh) {
         meshes.push_back(std::move(mesh));
     }
@@ -38,6 +38,9 @@ namespace vox {
 
         [[nodiscard]] const std::vector<Texture>& getTextures() const;
 
+        // Bounds of every mesh together, in model space.
+        [[nodiscard]] MeshBounds getBounds() const;
+
     private:
         void addMesh(Mesh&& mesh);
         void addMesh(const Mesh& mesh);
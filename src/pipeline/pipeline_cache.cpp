@@ -0,0 +1,211 @@
+#include "pipeline_cache.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+#include "../misc/constants.h"
+#include "../misc/mapped_file.h"
+
+namespace {
+    // "VXPC", version, vendor, device, driver version, UUID, reserved, blob size, blob hash.
+    constexpr uint32_t PIPELINE_CACHE_MAGIC = 0x43505856;
+    constexpr size_t PIPELINE_CACHE_HEADER_SIZE = 64;
+
+    uint32_t readU32(const std::span<const uint8_t> bytes, const size_t offset) {
+        uint32_t value;
+        memcpy(&value, bytes.data() + offset, 4);
+        return value;
+    }
+
+    uint64_t readU64(const std::span<const uint8_t> bytes, const size_t offset) {
+        uint64_t value;
+        memcpy(&value, bytes.data() + offset, 8);
+        return value;
+    }
+}
+
+std::vector<uint8_t> vox::PipelineCache::read() const {
+    // Like a failed save, an unreadable cache only costs compile time.
+    const auto ignore = [&](const std::string& reason) {
+        std::cerr << "[Pipeline] Ignoring unreadable pipeline cache " << path.string() << ": " << reason << "\n" << std::flush;
+        return std::vector<uint8_t>();
+    };
+
+    std::error_code error;
+
+    if (!std::filesystem::exists(path, error)) {
+        return error ? ignore(error.message()) : std::vector<uint8_t>();
+    }
+
+    if (const auto size = std::filesystem::file_size(path, error); error) {
+        return ignore(error.message());
+    } else if (size < PIPELINE_CACHE_HEADER_SIZE) {
+        return {};
+    }
+
+    std::optional<MappedFile> file = std::nullopt;
+
+    try {
+        file.emplace(path.string());
+    } catch (const std::runtime_error& exception) {
+        return ignore(exception.what());
+    }
+
+    const auto bytes = file->getBytes();
+
+    const auto discard = [&](const std::string& reason) {
+        std::cout << "[Pipeline] Discarding pipeline cache " << path.string() << ": " << reason << ".\n" << std::flush;
+        return std::vector<uint8_t>();
+    };
+
+    if (readU32(bytes, 0) != PIPELINE_CACHE_MAGIC || readU32(bytes, 4) != PIPELINE_CACHE_VERSION) {
+        return discard("unknown format");
+    }
+
+    if (readU32(bytes, 8) != properties.vendorID || readU32(bytes, 12) != properties.deviceID) {
+        return discard("written by another device");
+    }
+
+    if (readU32(bytes, 16) != properties.driverVersion) {
+        return discard("written by another driver version");
+    }
+
+    if (memcmp(bytes.data() + 20, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+        return discard("pipeline cache UUID changed");
+    }
+
+    const auto data = bytes.subspan(PIPELINE_CACHE_HEADER_SIZE);
+
+    if (readU64(bytes, 40) != data.size()) {
+        return discard("truncated");
+    }
+
+    if (hash128(data) != Hash128 { readU64(bytes, 48), readU64(bytes, 56) }) {
+        return discard("corrupt");
+    }
+
+    return { data.begin(), data.end() };
+}
+
+void vox::PipelineCache::build(const VkDevice& device, const VkPhysicalDeviceProperties& properties) {
+    this->properties = properties;
+
+    const auto data = read();
+
+    savedHash = data.empty() ? Hash128 {} : hash128(data);
+
+    VkPipelineCacheCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.initialDataSize = data.size();
+    createInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+    if (VK_SUCCESS != vkCreatePipelineCache(device, &createInfo, nullptr, &pipelineCache)) {
+        throw std::runtime_error("[Pipeline] Failed to create pipeline cache!");
+    }
+
+    std::cout << "[Pipeline] Loaded " << data.size() / 1024 << " KiB of cached pipelines.\n" << std::flush;
+}
+
+void vox::PipelineCache::save(const VkDevice& device) {
+    if (pipelineCache == VK_NULL_HANDLE) {
+        return;
+    }
+
+    size_t dataSize = 0;
+
+    if (VK_SUCCESS != vkGetPipelineCacheData(device, pipelineCache, &dataSize, nullptr)) {
+        throw std::runtime_error("[Pipeline] Failed to query pipeline cache size!");
+    }
+
+    std::vector<uint8_t> bytes(PIPELINE_CACHE_HEADER_SIZE + dataSize);
+
+    if (VK_SUCCESS != vkGetPipelineCacheData(device, pipelineCache, &dataSize, bytes.data() + PIPELINE_CACHE_HEADER_SIZE)) {
+        throw std::runtime_error("[Pipeline] Failed to read pipeline cache data!");
+    }
+
+    bytes.resize(PIPELINE_CACHE_HEADER_SIZE + dataSize);
+
+    const auto dataHash = hash128(std::span(bytes).subspan(PIPELINE_CACHE_HEADER_SIZE));
+
+    if (dataHash == savedHash) {
+        return;
+    }
+
+    const auto writeU32 = [&](const size_t offset, const uint32_t value) {
+        memcpy(bytes.data() + offset, &value, 4);
+    };
+
+    const auto writeU64 = [&](const size_t offset, const uint64_t value) {
+        memcpy(bytes.data() + offset, &value, 8);
+    };
+
+    writeU32(0, PIPELINE_CACHE_MAGIC);
+    writeU32(4, PIPELINE_CACHE_VERSION);
+    writeU32(8, properties.vendorID);
+    writeU32(12, properties.deviceID);
+    writeU32(16, properties.driverVersion);
+    memcpy(bytes.data() + 20, properties.pipelineCacheUUID, VK_UUID_SIZE);
+    writeU32(36, 0);
+    writeU64(40, dataSize);
+    writeU64(48, dataHash.low);
+    writeU64(56, dataHash.high);
+
+    // The cache only saves compile time, so failing to write it is logged rather than fatal.
+    const auto fail = [&](const std::string& reason) {
+        std::cerr << "[Pipeline] Failed to save pipeline cache " << path.string() << ": " << reason << "\n" << std::flush;
+    };
+
+    std::error_code error;
+
+    if (path.has_parent_path()) {
+        if (std::filesystem::create_directories(path.parent_path(), error); error) {
+            return fail(error.message());
+        }
+    }
+
+    // Written next to the file and renamed over it, so a crash never leaves a partial cache.
+    auto temporaryPath = path;
+    temporaryPath += ".tmp";
+
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+
+        if (!file.is_open()) {
+            return fail("could not create " + temporaryPath.string());
+        }
+
+        if (!file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+            file.close();
+            std::filesystem::remove(temporaryPath, error);
+
+            return fail("could not write " + temporaryPath.string());
+        }
+    }
+
+    if (std::filesystem::rename(temporaryPath, path, error); error) {
+        const auto reason = error.message();
+
+        std::filesystem::remove(temporaryPath, error);
+
+        return fail(reason);
+    }
+
+    savedHash = dataHash;
+
+    std::cout << "[Pipeline] Saved " << dataSize / 1024 << " KiB of cached pipelines.\n" << std::flush;
+}
+
+void vox::PipelineCache::destroy(const VkDevice& device) {
+    vkDestroyPipelineCache(device, pipelineCache, nullptr);
+
+    pipelineCache = VK_NULL_HANDLE;
+}
+
+VkPipelineCache vox::PipelineCache::get() const {
+    return pipelineCache;
+}
@@ -0,0 +1,70 @@
+#ifndef VOX_PIPELINE_CACHE_H
+#define VOX_PIPELINE_CACHE_H
+
+/**
+ * Persistent pipeline cache.
+ *
+ * The driver's pipeline cache blob is saved to disk after pipelines are
+ * created and on shutdown, and fed back on the next launch, so pipelines
+ * already compiled once are not compiled from SPIR-V again.
+ *
+ * The blob is only valid for the device and driver that wrote it. It is
+ * stored behind a header recording the vendor, device, driver version and
+ * pipeline cache UUID, plus a hash of the blob. A file that does not match
+ * the current device, or is truncated or corrupt, is discarded, and the
+ * cache starts out empty.
+ */
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include <vulkan/vulkan_core.h>
+
+#include "../misc/hash.h"
+
+namespace vox {
+    class PipelineCache {
+        std::filesystem::path path;
+
+        VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+
+        VkPhysicalDeviceProperties properties = {};
+
+        // Hash of the blob on disk, to skip saving when nothing changed.
+        Hash128 savedHash = {};
+
+        // Returns the cached blob, or an empty one when the file is missing or invalid.
+        [[nodiscard]] std::vector<uint8_t> read() const;
+
+    public:
+        PipelineCache() = delete;
+
+        explicit PipelineCache(std::filesystem::path path)
+                : path(std::move(path)) {
+        }
+
+        PipelineCache(const PipelineCache& other) = delete;
+
+        PipelineCache(PipelineCache&& other) noexcept = delete;
+
+        PipelineCache& operator=(const PipelineCache& other) = delete;
+
+        PipelineCache& operator=(PipelineCache&& other) = delete;
+
+        ~PipelineCache() = default;
+
+        // Creates the cache, seeded from disk when the file matches this device.
+        void build(const VkDevice& device, const VkPhysicalDeviceProperties& properties);
+
+        // Writes the cache to disk, unless it is unchanged since it was loaded or last saved,
+        // or was never built.
+        void save(const VkDevice& device);
+
+        void destroy(const VkDevice& device);
+
+        [[nodiscard]] VkPipelineCache get() const;
+    };
+}
+
+#endif
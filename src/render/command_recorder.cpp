@@ -0,0 +1,127 @@
+#include "command_recorder.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+vox::CommandRecorder::CommandRecorder(const uint32_t frameCount, const uint32_t workerCount)
+        : workerCount(workerCount),
+          slots(frameCount, std::vector<Slot>(workerCount + 1)) {
+}
+
+VkResult vox::CommandRecorder::build(const VkDevice& device, const uint32_t queueFamilyIndex) {
+    // Buffers are never reset one by one, only their whole pool.
+    VkCommandPoolCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    createInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    createInfo.queueFamilyIndex = queueFamilyIndex;
+
+    for (auto& frameSlots : slots) {
+        for (auto& slot : frameSlots) {
+            if (const auto result = vkCreateCommandPool(device, &createInfo, nullptr, &slot.pool); result != VK_SUCCESS) {
+                return result;
+            }
+        }
+    }
+
+    return VK_SUCCESS;
+}
+
+void vox::CommandRecorder::destroy(const VkDevice& device) {
+    for (auto& frameSlots : slots) {
+        for (auto& slot : frameSlots) {
+            // Destroying a pool frees its command buffers.
+            vkDestroyCommandPool(device, slot.pool, nullptr);
+
+            slot = {};
+        }
+    }
+}
+
+VkResult vox::CommandRecorder::reset(const VkDevice& device, const uint32_t frame) {
+    for (auto& slot : slots.at(frame)) {
+        if (slot.used == 0) continue;
+
+        if (const auto result = vkResetCommandPool(device, slot.pool, 0); result != VK_SUCCESS) {
+            return result;
+        }
+
+        slot.used = 0;
+    }
+
+    return VK_SUCCESS;
+}
+
+VkCommandBuffer vox::CommandRecorder::begin(const VkDevice& device, const uint32_t frame, const uint32_t slotIndex, const VkCommandBufferInheritanceInfo& inheritanceInfo) {
+    auto& slot = slots.at(frame).at(slotIndex);
+
+    if (slot.used == slot.commandBuffers.size()) {
+        VkCommandBufferAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.commandPool = slot.pool;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocateInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer;
+
+        if (VK_SUCCESS != vkAllocateCommandBuffers(device, &allocateInfo, &commandBuffer)) {
+            throw std::runtime_error("[Vulkan] Failed to allocate secondary command buffer!");
+        }
+
+        slot.commandBuffers.push_back(commandBuffer);
+    }
+
+    const auto commandBuffer = slot.commandBuffers[slot.used++];
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+    if (VK_SUCCESS != vkBeginCommandBuffer(commandBuffer, &beginInfo)) {
+        throw std::runtime_error("[Vulkan] Failed to begin recording secondary command buffer!");
+    }
+
+    return commandBuffer;
+}
+
+std::span<const VkCommandBuffer> vox::CommandRecorder::record(
+    const VkDevice& device,
+    ThreadPool& threadPool,
+    const uint32_t frame,
+    const VkCommandBufferInheritanceInfo& inheritanceInfo,
+    const size_t count,
+    const size_t minChunkSize,
+    const uint32_t maxThreadCount,
+    const std::function<void(VkCommandBuffer, size_t, size_t, size_t)>& function
+) {
+    recorded.clear();
+
+    if (count == 0) {
+        return recorded;
+    }
+
+    // Small workloads stay on fewer workers, as every chunk costs a command buffer and its rebinds.
+    const auto chunkCount = std::clamp<size_t>(count / std::max<size_t>(minChunkSize, 1), 1, std::min(workerCount, std::max(maxThreadCount, 1u)));
+    const auto chunkSize = (count + chunkCount - 1) / chunkCount;
+
+    recorded.resize(chunkCount);
+
+    // Chunk i is recorded from slot i, by whichever worker picks it up.
+    threadPool.parallelFor(chunkCount, [&](const size_t chunk) {
+        const auto commandBuffer = begin(device, frame, static_cast<uint32_t>(chunk), inheritanceInfo);
+
+        function(commandBuffer, chunk, chunk * chunkSize, std::min(count, (chunk + 1) * chunkSize));
+
+        if (VK_SUCCESS != vkEndCommandBuffer(commandBuffer)) {
+            throw std::runtime_error("[Vulkan] Failed to record secondary command buffer!");
+        }
+
+        recorded[chunk] = commandBuffer;
+    }, static_cast<uint32_t>(chunkCount));
+
+    return recorded;
+}
+
+uint32_t vox::CommandRecorder::getMainSlot() const {
+    return workerCount;
+}
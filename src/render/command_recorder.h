@@ -0,0 +1,87 @@
+#ifndef VOX_COMMAND_RECORDER_H
+#define VOX_COMMAND_RECORDER_H
+
+/**
+ * Secondary command buffer recorder, spreading work across the thread pool.
+ *
+ * Command pools may only be used by one thread at a time, so every frame in
+ * flight gets one pool per slot: one per worker, plus one for the thread
+ * calling record, e.g. for the UI. Work is split into contiguous chunks, one
+ * per slot, so a pool is never touched by two threads at once without any
+ * locking.
+ *
+ * Pools are reset wholesale once their frame finished, and the command
+ * buffers allocated from them are reused by the next frame in the same slot.
+ */
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include <vulkan/vulkan_core.h>
+
+#include "../misc/thread_pool.h"
+
+namespace vox {
+    class CommandRecorder {
+        struct Slot {
+            VkCommandPool pool = VK_NULL_HANDLE;
+
+            // Allocated on first use; the first `used` were handed out this frame.
+            std::vector<VkCommandBuffer> commandBuffers = {};
+            size_t used = 0;
+        };
+
+        uint32_t workerCount;
+
+        // By frame, then by slot; the last slot of a frame belongs to the recording thread.
+        std::vector<std::vector<Slot>> slots;
+
+        // Secondaries handed out by the last call to record, in execution order.
+        std::vector<VkCommandBuffer> recorded = {};
+
+    public:
+        CommandRecorder(uint32_t frameCount, uint32_t workerCount);
+
+        CommandRecorder(const CommandRecorder& other) = delete;
+
+        CommandRecorder(CommandRecorder&& other) noexcept = delete;
+
+        CommandRecorder& operator=(const CommandRecorder& other) = delete;
+
+        CommandRecorder& operator=(CommandRecorder&& other) = delete;
+
+        ~CommandRecorder() = default;
+
+        VkResult build(const VkDevice& device, uint32_t queueFamilyIndex);
+
+        void destroy(const VkDevice& device);
+
+        // Makes every command buffer of a frame recordable again; its last submission must have finished.
+        VkResult reset(const VkDevice& device, uint32_t frame);
+
+        // Begins a secondary command buffer continuing the inherited render pass, from a slot's pool.
+        // Only one thread may use a slot at a time.
+        [[nodiscard]] VkCommandBuffer begin(const VkDevice& device, uint32_t frame, uint32_t slot, const VkCommandBufferInheritanceInfo& inheritanceInfo);
+
+        // Splits [0, count) into contiguous chunks of at least minChunkSize items, on at most maxThreadCount
+        // workers, and calls function(commandBuffer, chunk, begin, end) for each, with commandBuffer begun.
+        // Returns the ended secondaries, to be executed in order.
+        [[nodiscard]] std::span<const VkCommandBuffer> record(
+            const VkDevice& device,
+            ThreadPool& threadPool,
+            uint32_t frame,
+            const VkCommandBufferInheritanceInfo& inheritanceInfo,
+            size_t count,
+            size_t minChunkSize,
+            uint32_t maxThreadCount,
+            const std::function<void(VkCommandBuffer, size_t, size_t, size_t)>& function
+        );
+
+        // Slot of the thread calling record, for the command buffers it begins itself.
+        [[nodiscard]] uint32_t getMainSlot() const;
+    };
+}
+
+#endif
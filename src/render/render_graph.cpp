@@ -0,0 +1,686 @@
+#include "render_graph.h"
+
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    VkImageUsageFlags getImageUsage(const VkImageLayout layout) {
+        switch (layout) {
+            case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+                return VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+            case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+                return VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+            case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
+                return VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+            case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+                return VK_IMAGE_USAGE_SAMPLED_BIT;
+            case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+                return VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+            case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+                return VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+            case VK_IMAGE_LAYOUT_GENERAL:
+                return VK_IMAGE_USAGE_STORAGE_BIT;
+            default:
+                return 0;
+        }
+    }
+
+    std::optional<uint32_t> findMemoryType(const VkPhysicalDeviceMemoryProperties& properties, const uint32_t typeBits, const VkMemoryPropertyFlags propertyFlags) {
+        for (uint32_t i = 0; i < properties.memoryTypeCount; ++i) {
+            if ((typeBits & (1u << i)) != 0 && (properties.memoryTypes[i].propertyFlags & propertyFlags) == propertyFlags) {
+                return i;
+            }
+        }
+
+        return std::nullopt;
+    }
+}
+
+vox::RenderGraphBuilder::RenderGraphBuilder(RenderGraph& graph, const RenderGraphPass pass) : graph(graph), pass(pass) {
+}
+
+void vox::RenderGraphBuilder::writeColor(const RenderGraphResource resource, const VkAttachmentLoadOp loadOp, const VkClearColorValue clearValue) {
+    graph.addUse(pass, { resource, getImageState(VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL), loadOp == VK_ATTACHMENT_LOAD_OP_LOAD, true });
+
+    VkClearValue value = {};
+    value.color = clearValue;
+
+    graph.passes[pass].colorAttachments.push_back({ resource, loadOp, VK_ATTACHMENT_STORE_OP_STORE, value });
+}
+
+void vox::RenderGraphBuilder::writeDepth(const RenderGraphResource resource, const VkAttachmentLoadOp loadOp, const VkClearDepthStencilValue clearValue) {
+    if (graph.passes[pass].depthAttachment.has_value()) {
+        throw std::runtime_error("[RenderGraph] Pass " + graph.passes[pass].name + " has two depth attachments!");
+    }
+
+    graph.addUse(pass, { resource, getImageState(VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL), loadOp == VK_ATTACHMENT_LOAD_OP_LOAD, true });
+
+    VkClearValue value = {};
+    value.depthStencil = clearValue;
+
+    graph.passes[pass].depthAttachment = { resource, loadOp, VK_ATTACHMENT_STORE_OP_STORE, value };
+}
+
+void vox::RenderGraphBuilder::read(const RenderGraphResource resource, const VkImageLayout layout) {
+    graph.addUse(pass, { resource, getImageState(layout), true, false });
+}
+
+void vox::RenderGraphBuilder::write(const RenderGraphResource resource, const VkImageLayout layout) {
+    graph.addUse(pass, { resource, getImageState(layout), false, true });
+}
+
+void vox::RenderGraphBuilder::setContents(const VkSubpassContents contents) {
+    graph.passes[pass].contents = contents;
+}
+
+void vox::RenderGraphBuilder::keep() {
+    graph.passes[pass].kept = true;
+}
+
+void vox::RenderGraph::addUse(const RenderGraphPass pass, const Use& use) {
+    if (use.resource >= images.size()) {
+        throw std::runtime_error("[RenderGraph] Pass " + passes[pass].name + " uses an unknown image!");
+    }
+
+    if (std::ranges::any_of(passes[pass].uses, [&](const Use& other) { return other.resource == use.resource; })) {
+        throw std::runtime_error("[RenderGraph] Pass " + passes[pass].name + " uses " + images[use.resource].name + " twice!");
+    }
+
+    passes[pass].uses.push_back(use);
+}
+
+vox::RenderGraphResource vox::RenderGraph::importImage(const std::string& name, const RenderGraphImageInfo& info, const ImageState& initialState, const VkImageLayout finalLayout) {
+    if (compiled) {
+        throw std::runtime_error("[RenderGraph] Cannot import " + name + " into a compiled graph!");
+    }
+
+    images.push_back({ .name = name, .info = info, .imported = true, .initialState = initialState, .finalLayout = finalLayout });
+
+    return static_cast<RenderGraphResource>(images.size() - 1);
+}
+
+vox::RenderGraphResource vox::RenderGraph::createImage(const std::string& name, const RenderGraphImageInfo& info) {
+    if (compiled) {
+        throw std::runtime_error("[RenderGraph] Cannot create " + name + " in a compiled graph!");
+    }
+
+    images.push_back({ .name = name, .info = info, .imported = false, .initialState = getImageState(VK_IMAGE_LAYOUT_UNDEFINED), .finalLayout = VK_IMAGE_LAYOUT_UNDEFINED });
+
+    return static_cast<RenderGraphResource>(images.size() - 1);
+}
+
+vox::RenderGraphPass vox::RenderGraph::addPass(const std::string& name, const std::function<void(RenderGraphBuilder&)>& setup, std::function<void(const RenderGraphContext&)> execute) {
+    if (compiled) {
+        throw std::runtime_error("[RenderGraph] Cannot add " + name + " to a compiled graph!");
+    }
+
+    const auto pass = static_cast<RenderGraphPass>(passes.size());
+
+    passes.push_back({ .name = name, .execute = std::move(execute) });
+
+    RenderGraphBuilder builder(*this, pass);
+    setup(builder);
+
+    return pass;
+}
+
+void vox::RenderGraph::cull() {
+    // Walking backwards, an image is needed while a live pass after this point reads what was last written to it.
+    std::vector<bool> needed(images.size());
+
+    for (size_t i = 0; i < images.size(); ++i) {
+        needed[i] = images[i].imported;
+    }
+
+    for (auto p = passes.size(); p-- > 0;) {
+        auto& pass = passes[p];
+
+        pass.culled = !pass.kept && std::ranges::none_of(pass.uses, [&](const Use& use) {
+            return use.writes && needed[use.resource];
+        });
+
+        if (pass.culled) {
+            continue;
+        }
+
+        // A write that does not read makes whatever earlier passes wrote unneeded.
+        for (const auto& use : pass.uses) {
+            if (use.writes && !use.reads) {
+                needed[use.resource] = images[use.resource].imported;
+            }
+        }
+
+        for (const auto& use : pass.uses) {
+            if (use.reads) {
+                needed[use.resource] = true;
+            }
+        }
+    }
+}
+
+void vox::RenderGraph::computeLifetimes() {
+    for (uint32_t p = 0; p < passes.size(); ++p) {
+        if (passes[p].culled) continue;
+
+        for (const auto& use : passes[p].uses) {
+            auto& image = images[use.resource];
+
+            image.usage |= getImageUsage(use.state.layout);
+
+            if (!image.firstPass.has_value()) {
+                image.firstPass = p;
+            }
+
+            image.lastPass = p;
+        }
+    }
+
+    // An attachment is only stored when the next live pass using it reads it, or it outlives the frame.
+    const auto isReadAfter = [&](const RenderGraphResource resource, const uint32_t pass) {
+        for (auto p = pass + 1; p < passes.size(); ++p) {
+            if (passes[p].culled) continue;
+
+            for (const auto& use : passes[p].uses) {
+                if (use.resource == resource) {
+                    return use.reads;
+                }
+            }
+        }
+
+        return images[resource].imported;
+    };
+
+    for (uint32_t p = 0; p < passes.size(); ++p) {
+        auto& pass = passes[p];
+
+        for (auto& attachment : pass.colorAttachments) {
+            attachment.storeOp = isReadAfter(attachment.resource, p) ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        }
+
+        if (pass.depthAttachment.has_value()) {
+            pass.depthAttachment->storeOp = isReadAfter(pass.depthAttachment->resource, p) ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        }
+    }
+}
+
+std::vector<vox::ImageState> vox::RenderGraph::computeStates(const std::vector<ImageState>& initialStates, const bool recordBarriers) {
+    auto states = initialStates;
+
+    for (auto& pass : passes) {
+        if (pass.culled) continue;
+
+        if (recordBarriers) {
+            pass.barrier = {};
+        }
+
+        for (const auto& use : pass.uses) {
+            auto& state = states[use.resource];
+
+            if (!needsImageBarrier(state, use.state)) {
+                // Reads in the same layout share a state, which the next barrier waits on as a whole.
+                state.stage |= use.state.stage;
+                state.access |= use.state.access;
+
+                continue;
+            }
+
+            if (recordBarriers) {
+                pass.barrier.transitions.push_back({ use.resource, state, use.state });
+                pass.barrier.sourceStage |= state.stage;
+                pass.barrier.destinationStage |= use.state.stage;
+            }
+
+            state = use.state;
+        }
+    }
+
+    if (recordBarriers) {
+        finalBarrier = {};
+
+        for (RenderGraphResource i = 0; i < images.size(); ++i) {
+            if (!images[i].imported || images[i].finalLayout == VK_IMAGE_LAYOUT_UNDEFINED) continue;
+
+            const auto finalState = getImageState(images[i].finalLayout);
+
+            if (!needsImageBarrier(states[i], finalState)) continue;
+
+            finalBarrier.transitions.push_back({ i, states[i], finalState });
+            finalBarrier.sourceStage |= states[i].stage;
+            finalBarrier.destinationStage |= finalState.stage;
+        }
+    }
+
+    return states;
+}
+
+VkResult vox::RenderGraph::allocateTransientImages(const VkPhysicalDevice& physicalDevice, const VkDevice& device) {
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+    std::vector<RenderGraphResource> transients;
+
+    for (RenderGraphResource i = 0; i < images.size(); ++i) {
+        auto& image = images[i];
+
+        // Images no live pass uses are never created.
+        if (image.imported || !image.firstPass.has_value()) continue;
+
+        VkImageCreateInfo createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        createInfo.imageType = VK_IMAGE_TYPE_2D;
+        createInfo.format = image.info.format;
+        createInfo.extent = { image.info.extent.width, image.info.extent.height, 1 };
+        createInfo.mipLevels = 1;
+        createInfo.arrayLayers = 1;
+        createInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        createInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        createInfo.usage = image.info.usage | image.usage;
+        createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        createInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        if (const auto result = vkCreateImage(device, &createInfo, nullptr, &image.image); result != VK_SUCCESS) {
+            return result;
+        }
+
+        vkGetImageMemoryRequirements(device, image.image, &image.memoryRequirements);
+
+        stats.unaliasedSize += image.memoryRequirements.size;
+
+        transients.push_back(i);
+    }
+
+    // Largest first, so smaller images fill the blocks those open.
+    std::ranges::stable_sort(transients, std::greater {}, [&](const RenderGraphResource i) {
+        return images[i].memoryRequirements.size;
+    });
+
+    const auto overlaps = [&](const RenderGraphResource a, const RenderGraphResource b) {
+        return images[a].firstPass.value() <= images[b].lastPass && images[b].firstPass.value() <= images[a].lastPass;
+    };
+
+    for (const auto i : transients) {
+        const auto& requirements = images[i].memoryRequirements;
+
+        auto block = std::ranges::find_if(blocks, [&](const Block& candidate) {
+            return findMemoryType(memoryProperties, candidate.memoryTypeBits & requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT).has_value()
+                && std::ranges::none_of(candidate.images, [&](const RenderGraphResource other) { return overlaps(i, other); });
+        });
+
+        if (block == blocks.end()) {
+            blocks.emplace_back();
+            block = std::prev(blocks.end());
+        }
+
+        block->size = std::max(block->size, requirements.size);
+        block->memoryTypeBits &= requirements.memoryTypeBits;
+        block->images.push_back(i);
+    }
+
+    for (auto& block : blocks) {
+        std::ranges::sort(block.images, {}, [&](const RenderGraphResource i) {
+            return images[i].firstPass.value();
+        });
+
+        const auto memoryType = findMemoryType(memoryProperties, block.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        if (!memoryType.has_value()) {
+            throw std::runtime_error("[RenderGraph] Failed to find a memory type for " + images[block.images.front()].name + "!");
+        }
+
+        VkMemoryAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = block.size;
+        allocateInfo.memoryTypeIndex = memoryType.value();
+
+        if (const auto result = vkAllocateMemory(device, &allocateInfo, nullptr, &block.memory); result != VK_SUCCESS) {
+            return result;
+        }
+
+        stats.transientSize += block.size;
+
+        for (const auto i : block.images) {
+            auto& image = images[i];
+
+            // Every image of a block starts at offset 0, which satisfies any alignment.
+            if (const auto result = vkBindImageMemory(device, image.image, block.memory, 0); result != VK_SUCCESS) {
+                return result;
+            }
+
+            VkImageViewCreateInfo viewCreateInfo = {};
+            viewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            viewCreateInfo.image = image.image;
+            viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewCreateInfo.format = image.info.format;
+            viewCreateInfo.subresourceRange = { getImageAspect(image.info.format), 0, 1, 0, 1 };
+
+            if (const auto result = vkCreateImageView(device, &viewCreateInfo, nullptr, &image.imageView); result != VK_SUCCESS) {
+                return result;
+            }
+        }
+    }
+
+    stats.transientImages = static_cast<uint32_t>(transients.size());
+
+    return VK_SUCCESS;
+}
+
+VkResult vox::RenderGraph::buildRenderPass(const VkDevice& device, Pass& pass) {
+    std::vector<std::pair<const Attachment*, VkImageLayout>> attachments;
+
+    for (const auto& attachment : pass.colorAttachments) {
+        attachments.emplace_back(&attachment, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    }
+
+    if (pass.depthAttachment.has_value()) {
+        attachments.emplace_back(&pass.depthAttachment.value(), VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+    }
+
+    if (attachments.empty()) {
+        return VK_SUCCESS;
+    }
+
+    pass.extent = images[attachments.front().first->resource].info.extent;
+
+    std::vector<VkAttachmentDescription> descriptions;
+    std::vector<uint32_t> key = { static_cast<uint32_t>(pass.colorAttachments.size()) };
+
+    for (const auto& [attachment, layout] : attachments) {
+        const auto& image = images[attachment->resource];
+
+        if (image.info.extent.width != pass.extent.width || image.info.extent.height != pass.extent.height) {
+            throw std::runtime_error("[RenderGraph] Attachments of pass " + pass.name + " differ in extent!");
+        }
+
+        const auto hasStencil = (getImageAspect(image.info.format) & VK_IMAGE_ASPECT_STENCIL_BIT) != 0;
+
+        // Layouts are left to the graph's barriers, so the render pass transitions nothing.
+        VkAttachmentDescription description = {};
+        description.format = image.info.format;
+        description.samples = VK_SAMPLE_COUNT_1_BIT;
+        description.loadOp = attachment->loadOp;
+        description.storeOp = attachment->storeOp;
+        description.stencilLoadOp = hasStencil ? attachment->loadOp : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        description.stencilStoreOp = hasStencil ? attachment->storeOp : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        description.initialLayout = layout;
+        description.finalLayout = layout;
+
+        descriptions.push_back(description);
+
+        key.insert(key.end(), {
+            static_cast<uint32_t>(description.format),
+            static_cast<uint32_t>(description.loadOp),
+            static_cast<uint32_t>(description.storeOp),
+            static_cast<uint32_t>(description.stencilLoadOp),
+            static_cast<uint32_t>(description.stencilStoreOp),
+            static_cast<uint32_t>(layout)
+        });
+    }
+
+    if (const auto cached = renderPasses.find(key); cached != renderPasses.end()) {
+        pass.renderPass = cached->second;
+
+        return VK_SUCCESS;
+    }
+
+    std::vector<VkAttachmentReference> colorReferences;
+
+    for (uint32_t i = 0; i < pass.colorAttachments.size(); ++i) {
+        colorReferences.push_back({ i, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL });
+    }
+
+    const VkAttachmentReference depthReference = { static_cast<uint32_t>(pass.colorAttachments.size()), VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+
+    VkSubpassDescription subpass = {};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = static_cast<uint32_t>(colorReferences.size());
+    subpass.pColorAttachments = colorReferences.data();
+    subpass.pDepthStencilAttachment = pass.depthAttachment.has_value() ? &depthReference : nullptr;
+
+    VkRenderPassCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    createInfo.attachmentCount = static_cast<uint32_t>(descriptions.size());
+    createInfo.pAttachments = descriptions.data();
+    createInfo.subpassCount = 1;
+    createInfo.pSubpasses = &subpass;
+
+    if (const auto result = vkCreateRenderPass(device, &createInfo, nullptr, &pass.renderPass); result != VK_SUCCESS) {
+        return result;
+    }
+
+    renderPasses.emplace(std::move(key), pass.renderPass);
+
+    return VK_SUCCESS;
+}
+
+VkResult vox::RenderGraph::compile(const VkPhysicalDevice& physicalDevice, const VkDevice& device) {
+    if (compiled) {
+        throw std::runtime_error("[RenderGraph] Graph is already compiled!");
+    }
+
+    stats = {};
+
+    cull();
+    computeLifetimes();
+
+    if (const auto result = allocateTransientImages(physicalDevice, device); result != VK_SUCCESS) {
+        return result;
+    }
+
+    std::vector<ImageState> initialStates;
+
+    for (const auto& image : images) {
+        initialStates.push_back(image.initialState);
+    }
+
+    // A transient image takes over its memory from the image using it last, in the previous frame if it is the first.
+    const auto finalStates = computeStates(initialStates, false);
+
+    for (const auto& block : blocks) {
+        for (size_t k = 0; k < block.images.size(); ++k) {
+            const auto previous = block.images[(k + block.images.size() - 1) % block.images.size()];
+
+            initialStates[block.images[k]] = { VK_IMAGE_LAYOUT_UNDEFINED, finalStates[previous].stage, finalStates[previous].access };
+        }
+    }
+
+    static_cast<void>(computeStates(initialStates, true));
+
+    for (auto& pass : passes) {
+        if (pass.culled) {
+            ++stats.culledPasses;
+
+            continue;
+        }
+
+        if (const auto result = buildRenderPass(device, pass); result != VK_SUCCESS) {
+            return result;
+        }
+
+        ++stats.passes;
+        stats.barriers += pass.barrier.transitions.empty() ? 0 : 1;
+    }
+
+    stats.barriers += finalBarrier.transitions.empty() ? 0 : 1;
+
+    compiled = true;
+
+    return VK_SUCCESS;
+}
+
+void vox::RenderGraph::setImage(const RenderGraphResource resource, VkImage image, VkImageView imageView) {
+    auto& graphImage = images.at(resource);
+
+    if (!graphImage.imported) {
+        throw std::runtime_error("[RenderGraph] Cannot set " + graphImage.name + ", which the graph owns!");
+    }
+
+    graphImage.image = image;
+    graphImage.imageView = imageView;
+}
+
+VkResult vox::RenderGraph::getFramebuffer(const VkDevice& device, const Pass& pass, VkFramebuffer& framebuffer) {
+    std::vector<VkImageView> views;
+
+    for (const auto& attachment : pass.colorAttachments) {
+        views.push_back(images[attachment.resource].imageView);
+    }
+
+    if (pass.depthAttachment.has_value()) {
+        views.push_back(images[pass.depthAttachment->resource].imageView);
+    }
+
+    if (std::ranges::find(views, VK_NULL_HANDLE) != views.end()) {
+        throw std::runtime_error("[RenderGraph] Pass " + pass.name + " uses an imported image that was never set!");
+    }
+
+    auto key = std::make_pair(pass.renderPass, std::move(views));
+
+    if (const auto cached = framebuffers.find(key); cached != framebuffers.end()) {
+        framebuffer = cached->second;
+
+        return VK_SUCCESS;
+    }
+
+    VkFramebufferCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    createInfo.renderPass = pass.renderPass;
+    createInfo.attachmentCount = static_cast<uint32_t>(key.second.size());
+    createInfo.pAttachments = key.second.data();
+    createInfo.width = pass.extent.width;
+    createInfo.height = pass.extent.height;
+    createInfo.layers = 1;
+
+    if (const auto result = vkCreateFramebuffer(device, &createInfo, nullptr, &framebuffer); result != VK_SUCCESS) {
+        return result;
+    }
+
+    framebuffers.emplace(std::move(key), framebuffer);
+
+    return VK_SUCCESS;
+}
+
+void vox::RenderGraph::recordBarrier(VkCommandBuffer commandBuffer, const Barrier& barrier) {
+    if (barrier.transitions.empty()) {
+        return;
+    }
+
+    imageBarriers.clear();
+
+    for (const auto& [resource, from, to] : barrier.transitions) {
+        const auto& image = images[resource];
+
+        if (image.image == VK_NULL_HANDLE) {
+            throw std::runtime_error("[RenderGraph] Imported image " + image.name + " was never set!");
+        }
+
+        const VkImageSubresourceRange range = { getImageAspect(image.info.format), 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+
+        imageBarriers.push_back(buildImageBarrier(image.image, range, from, to));
+    }
+
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        barrier.sourceStage, barrier.destinationStage,
+        0,
+        0, nullptr,
+        0, nullptr,
+        static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data()
+    );
+}
+
+void vox::RenderGraph::execute(const VkDevice& device, VkCommandBuffer commandBuffer) {
+    if (!compiled) {
+        throw std::runtime_error("[RenderGraph] Graph must be compiled before it is executed!");
+    }
+
+    for (const auto& pass : passes) {
+        if (pass.culled) continue;
+
+        recordBarrier(commandBuffer, pass.barrier);
+
+        RenderGraphContext context = { commandBuffer, pass.renderPass, VK_NULL_HANDLE, pass.extent };
+
+        if (pass.renderPass == VK_NULL_HANDLE) {
+            pass.execute(context);
+
+            continue;
+        }
+
+        if (VK_SUCCESS != getFramebuffer(device, pass, context.framebuffer)) {
+            throw std::runtime_error("[RenderGraph] Failed to create framebuffer for pass " + pass.name + "!");
+        }
+
+        clearValues.clear();
+
+        for (const auto& attachment : pass.colorAttachments) {
+            clearValues.push_back(attachment.clearValue);
+        }
+
+        if (pass.depthAttachment.has_value()) {
+            clearValues.push_back(pass.depthAttachment->clearValue);
+        }
+
+        VkRenderPassBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        beginInfo.renderPass = pass.renderPass;
+        beginInfo.framebuffer = context.framebuffer;
+        beginInfo.renderArea = { { 0, 0 }, pass.extent };
+        beginInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+        beginInfo.pClearValues = clearValues.data();
+
+        vkCmdBeginRenderPass(commandBuffer, &beginInfo, pass.contents);
+
+        pass.execute(context);
+
+        vkCmdEndRenderPass(commandBuffer);
+    }
+
+    recordBarrier(commandBuffer, finalBarrier);
+}
+
+VkRenderPass vox::RenderGraph::getRenderPass(const RenderGraphPass pass) const {
+    return passes.at(pass).renderPass;
+}
+
+const vox::RenderGraphStats& vox::RenderGraph::getStats() const {
+    return stats;
+}
+
+void vox::RenderGraph::reset(const VkDevice& device) {
+    for (const auto framebuffer : framebuffers | std::views::values) {
+        vkDestroyFramebuffer(device, framebuffer, nullptr);
+    }
+
+    for (const auto& image : images) {
+        if (image.imported) continue;
+
+        vkDestroyImageView(device, image.imageView, nullptr);
+        vkDestroyImage(device, image.image, nullptr);
+    }
+
+    for (const auto& block : blocks) {
+        vkFreeMemory(device, block.memory, nullptr);
+    }
+
+    framebuffers.clear();
+    images.clear();
+    passes.clear();
+    blocks.clear();
+
+    finalBarrier = {};
+    stats = {};
+    compiled = false;
+}
+
+void vox::RenderGraph::destroy(const VkDevice& device) {
+    reset(device);
+
+    for (const auto renderPass : renderPasses | std::views::values) {
+        vkDestroyRenderPass(device, renderPass, nullptr);
+    }
+
+    renderPasses.clear();
+}
@@ -0,0 +1,241 @@
+#ifndef VOX_RENDER_GRAPH_H
+#define VOX_RENDER_GRAPH_H
+
+/**
+ * Render graph, deriving render passes, barriers and transient memory from
+ * the images each pass declares it reads and writes.
+ *
+ * Passes are declared in execution order. Compiling the graph:
+ * - culls the passes nothing depends on: those whose writes are neither
+ *   read by a later pass nor imported, unless kept for their side effects;
+ * - creates a render pass per pass with attachments, storing only the
+ *   attachments something reads afterwards;
+ * - derives the barriers before every pass from the state each image was
+ *   left in, batching them into one vkCmdPipelineBarrier per pass, and
+ *   skipping those between reads in the same layout;
+ * - places transient images whose lifetimes don't overlap in the same
+ *   memory, which their first barrier of a frame discards.
+ *
+ * Imported images, e.g. swapchain images, are owned elsewhere; their handle
+ * is set before every execution, and they are left in their final layout.
+ * Render passes survive reset, so pipelines built against them stay valid
+ * when the graph is rebuilt, e.g. for a new swapchain extent.
+ */
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan_core.h>
+
+#include "../sync/image_barrier.h"
+
+namespace vox {
+    using RenderGraphResource = uint32_t;
+    using RenderGraphPass = uint32_t;
+
+    struct RenderGraphImageInfo {
+        VkFormat format;
+        VkExtent2D extent;
+
+        // Usage on top of the one implied by the passes using the image.
+        VkImageUsageFlags usage;
+    };
+
+    // Handed to a pass when it runs; a pass with attachments runs inside its render pass.
+    struct RenderGraphContext {
+        VkCommandBuffer commandBuffer;
+        VkRenderPass renderPass;
+        VkFramebuffer framebuffer;
+        VkExtent2D extent;
+    };
+
+    struct RenderGraphStats {
+        uint32_t passes;
+        uint32_t culledPasses;
+        uint32_t barriers;
+        uint32_t transientImages;
+
+        // Memory of the transient images, and what it would take without aliasing.
+        VkDeviceSize transientSize;
+        VkDeviceSize unaliasedSize;
+    };
+
+    class RenderGraph;
+
+    // Declares what a pass uses, while it is being added; every image may be used once per pass.
+    class RenderGraphBuilder {
+        RenderGraph& graph;
+        RenderGraphPass pass;
+
+    public:
+        RenderGraphBuilder(RenderGraph& graph, RenderGraphPass pass);
+
+        void writeColor(RenderGraphResource resource, VkAttachmentLoadOp loadOp, VkClearColorValue clearValue = {});
+
+        void writeDepth(RenderGraphResource resource, VkAttachmentLoadOp loadOp, VkClearDepthStencilValue clearValue = { 1.0f, 0 });
+
+        // Uses outside of attachments, e.g. sampling or copies.
+        void read(RenderGraphResource resource, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+        void write(RenderGraphResource resource, VkImageLayout layout);
+
+        void setContents(VkSubpassContents contents);
+
+        // Never culls the pass, for passes with effects the graph does not see.
+        void keep();
+    };
+
+    class RenderGraph {
+        friend class RenderGraphBuilder;
+
+        struct Image {
+            std::string name;
+            RenderGraphImageInfo info;
+
+            bool imported;
+            ImageState initialState;
+            VkImageLayout finalLayout;
+
+            VkImage image = VK_NULL_HANDLE;
+            VkImageView imageView = VK_NULL_HANDLE;
+
+            // Of transient images, once compiled; lifetimes are in live passes.
+            VkImageUsageFlags usage = 0;
+            VkMemoryRequirements memoryRequirements = {};
+            std::optional<uint32_t> firstPass = std::nullopt;
+            uint32_t lastPass = 0;
+        };
+
+        struct Use {
+            RenderGraphResource resource;
+            ImageState state;
+            bool reads;
+            bool writes;
+        };
+
+        struct Attachment {
+            RenderGraphResource resource;
+            VkAttachmentLoadOp loadOp;
+            VkAttachmentStoreOp storeOp;
+            VkClearValue clearValue;
+        };
+
+        struct Transition {
+            RenderGraphResource resource;
+            ImageState from;
+            ImageState to;
+        };
+
+        struct Barrier {
+            std::vector<Transition> transitions = {};
+            VkPipelineStageFlags sourceStage = 0;
+            VkPipelineStageFlags destinationStage = 0;
+        };
+
+        struct Pass {
+            std::string name;
+            std::function<void(const RenderGraphContext&)> execute;
+
+            std::vector<Use> uses = {};
+            std::vector<Attachment> colorAttachments = {};
+            std::optional<Attachment> depthAttachment = std::nullopt;
+
+            VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE;
+            bool kept = false;
+
+            // Once compiled.
+            bool culled = false;
+            Barrier barrier = {};
+            VkRenderPass renderPass = VK_NULL_HANDLE;
+            VkExtent2D extent = {};
+        };
+
+        // Memory shared by transient images with disjoint lifetimes, ordered by first pass.
+        struct Block {
+            VkDeviceMemory memory = VK_NULL_HANDLE;
+            VkDeviceSize size = 0;
+            uint32_t memoryTypeBits = ~0u;
+            std::vector<RenderGraphResource> images = {};
+        };
+
+        std::vector<Image> images = {};
+        std::vector<Pass> passes = {};
+        std::vector<Block> blocks = {};
+
+        // Transitions of imported images into their final layout, after the last pass.
+        Barrier finalBarrier = {};
+
+        // Kept across reset; keyed by attachment descriptions.
+        std::map<std::vector<uint32_t>, VkRenderPass> renderPasses = {};
+
+        // By render pass and views; rebuilt on reset.
+        std::map<std::pair<VkRenderPass, std::vector<VkImageView>>, VkFramebuffer> framebuffers = {};
+
+        RenderGraphStats stats = {};
+        bool compiled = false;
+
+        // Scratch of execute, kept between frames.
+        std::vector<VkImageMemoryBarrier> imageBarriers = {};
+        std::vector<VkClearValue> clearValues = {};
+
+        void cull();
+
+        void computeLifetimes();
+
+        [[nodiscard]] std::vector<ImageState> computeStates(const std::vector<ImageState>& initialStates, bool recordBarriers);
+
+        VkResult allocateTransientImages(const VkPhysicalDevice& physicalDevice, const VkDevice& device);
+
+        VkResult buildRenderPass(const VkDevice& device, Pass& pass);
+
+        VkResult getFramebuffer(const VkDevice& device, const Pass& pass, VkFramebuffer& framebuffer);
+
+        void recordBarrier(VkCommandBuffer commandBuffer, const Barrier& barrier);
+
+        void addUse(RenderGraphPass pass, const Use& use);
+
+    public:
+        RenderGraph() = default;
+
+        RenderGraph(const RenderGraph& other) = delete;
+
+        RenderGraph(RenderGraph&& other) noexcept = delete;
+
+        RenderGraph& operator=(const RenderGraph& other) = delete;
+
+        RenderGraph& operator=(RenderGraph&& other) = delete;
+
+        ~RenderGraph() = default;
+
+        // An image owned elsewhere, in initialState before every execution and left in finalLayout after.
+        [[nodiscard]] RenderGraphResource importImage(const std::string& name, const RenderGraphImageInfo& info, const ImageState& initialState, VkImageLayout finalLayout);
+
+        // An image created by the graph, whose contents do not outlive a frame.
+        [[nodiscard]] RenderGraphResource createImage(const std::string& name, const RenderGraphImageInfo& info);
+
+        RenderGraphPass addPass(const std::string& name, const std::function<void(RenderGraphBuilder&)>& setup, std::function<void(const RenderGraphContext&)> execute);
+
+        VkResult compile(const VkPhysicalDevice& physicalDevice, const VkDevice& device);
+
+        // Sets the handles of an imported image for the next executions.
+        void setImage(RenderGraphResource resource, VkImage image, VkImageView imageView);
+
+        // Records every live pass into a primary command buffer.
+        void execute(const VkDevice& device, VkCommandBuffer commandBuffer);
+
+        [[nodiscard]] VkRenderPass getRenderPass(RenderGraphPass pass) const;
+
+        [[nodiscard]] const RenderGraphStats& getStats() const;
+
+        // Drops every pass and image, and the memory and framebuffers of the last compilation; the device must be idle.
+        void reset(const VkDevice& device);
+
+        void destroy(const VkDevice& device);
+    };
+}
+
+#endif
@@ -0,0 +1,183 @@
+#include "render_queue.h"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+    constexpr uint32_t PASS_BITS = 4;
+    constexpr uint32_t PIPELINE_BITS = 20;
+    constexpr uint32_t MATERIAL_BITS = 16;
+    constexpr uint32_t DEPTH_BITS = 24;
+
+    static_assert(PASS_BITS + PIPELINE_BITS + MATERIAL_BITS + DEPTH_BITS == 64);
+
+    constexpr uint32_t DEPTH_SHIFT = 0;
+    constexpr uint32_t MATERIAL_SHIFT = DEPTH_SHIFT + DEPTH_BITS;
+    constexpr uint32_t PIPELINE_SHIFT = MATERIAL_SHIFT + MATERIAL_BITS;
+    constexpr uint32_t PASS_SHIFT = PIPELINE_SHIFT + PIPELINE_BITS;
+
+    constexpr uint64_t getMask(const uint32_t bits) {
+        return (1ull << bits) - 1;
+    }
+
+    // Non-negative floats order like their bit patterns; the top bits keep that order.
+    uint64_t getDepthBits(const float depth) {
+        const auto bits = std::bit_cast<uint32_t>(std::max(depth, 0.0f));
+
+        return bits >> (32 - DEPTH_BITS);
+    }
+}
+
+uint64_t vox::RenderQueue::getKey(const RenderQueuePass pass, const RenderDraw& draw, const float depth) {
+    const auto pipelineIndex = pipelineIndices.try_emplace(draw.pipeline, static_cast<uint32_t>(pipelineIndices.size())).first->second;
+    const auto materialIndex = materialIndices.try_emplace(draw.material, static_cast<uint32_t>(materialIndices.size())).first->second;
+
+    if (pipelineIndex > getMask(PIPELINE_BITS)) {
+        throw std::runtime_error("[RenderQueue] Too many pipelines in one frame: " + std::to_string(pipelineIndex + 1));
+    }
+
+    if (materialIndex > getMask(MATERIAL_BITS)) {
+        throw std::runtime_error("[RenderQueue] Too many materials in one frame: " + std::to_string(materialIndex + 1));
+    }
+
+    auto depthBits = getDepthBits(depth);
+
+    // Transparent draws blend over what is behind them, so they are drawn back to front.
+    if (pass == RenderQueuePass::Transparent) {
+        depthBits = ~depthBits & getMask(DEPTH_BITS);
+    }
+
+    return static_cast<uint64_t>(pass) << PASS_SHIFT
+         | static_cast<uint64_t>(pipelineIndex) << PIPELINE_SHIFT
+         | static_cast<uint64_t>(materialIndex) << MATERIAL_SHIFT
+         | depthBits << DEPTH_SHIFT;
+}
+
+void vox::RenderQueue::clear() {
+    items.clear();
+    entries.clear();
+
+    pushConstantBytes.clear();
+    pushConstantUpdates.clear();
+
+    // Indices only need to be stable within a frame.
+    pipelineIndices.clear();
+    materialIndices.clear();
+}
+
+void vox::RenderQueue::submit(const RenderQueuePass pass, const RenderDraw& draw, const float depth, const std::span<const char> pushConstants, const std::span<const VkPushConstantRange> pushConstantRanges) {
+    const auto item = static_cast<uint32_t>(items.size());
+
+    items.push_back({
+        draw,
+        static_cast<uint32_t>(pushConstantBytes.size()),
+        static_cast<uint32_t>(pushConstantUpdates.size()),
+        static_cast<uint32_t>(pushConstantRanges.size())
+    });
+
+    pushConstantBytes.insert(pushConstantBytes.end(), pushConstants.begin(), pushConstants.end());
+    pushConstantUpdates.insert(pushConstantUpdates.end(), pushConstantRanges.begin(), pushConstantRanges.end());
+
+    entries.push_back({ getKey(pass, draw, depth), item });
+}
+
+void vox::RenderQueue::sort() {
+    sortBuffer.resize(entries.size());
+
+    // Least significant byte first; every pass is stable, so earlier bytes break ties.
+    for (uint32_t shift = 0; shift < 64; shift += 8) {
+        std::array<uint32_t, 256> counts = {};
+
+        for (const auto& entry : entries) {
+            ++counts[entry.key >> shift & 0xFF];
+        }
+
+        // Bytes shared by every key, e.g. the pass in a frame without transparency, leave the order as is.
+        if (std::ranges::find(counts, static_cast<uint32_t>(entries.size())) != counts.end()) {
+            continue;
+        }
+
+        uint32_t offset = 0;
+
+        for (auto& count : counts) {
+            offset += std::exchange(count, offset);
+        }
+
+        for (const auto& entry : entries) {
+            sortBuffer[counts[entry.key >> shift & 0xFF]++] = entry;
+        }
+
+        entries.swap(sortBuffer);
+    }
+}
+
+vox::RenderQueueStats vox::RenderQueue::record(const VkCommandBuffer commandBuffer, const size_t begin, const size_t end) const {
+    RenderQueueStats stats = {};
+
+    VkPipeline boundPipeline = VK_NULL_HANDLE;
+    VkPipelineLayout boundPipelineLayout = VK_NULL_HANDLE;
+    RenderMaterial boundMaterial = {};
+    VkBuffer boundVertexBuffer = VK_NULL_HANDLE;
+    VkBuffer boundIndexBuffer = VK_NULL_HANDLE;
+
+    for (const auto& entry : std::span(entries).subspan(begin, end - begin)) {
+        const auto& [draw, pushConstantOffset, pushConstantUpdateOffset, pushConstantUpdateCount] = items[entry.item];
+
+        if (draw.pipeline != boundPipeline) {
+            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, draw.pipeline);
+            boundPipeline = draw.pipeline;
+
+            ++stats.pipelineBinds;
+        }
+
+        // Sets bound with another layout may be disturbed by it, so a new layout rebinds them all.
+        if (draw.pipelineLayout != boundPipelineLayout || draw.material != boundMaterial) {
+            const auto setCount = static_cast<uint32_t>(std::ranges::find(draw.material, VK_NULL_HANDLE) - draw.material.begin());
+
+            if (setCount != 0) {
+                vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, draw.pipelineLayout, 0, setCount, draw.material.data(), 0, nullptr);
+            }
+
+            boundPipelineLayout = draw.pipelineLayout;
+            boundMaterial = draw.material;
+
+            ++stats.descriptorSetBinds;
+        }
+
+        if (draw.vertexBuffer != boundVertexBuffer) {
+            constexpr VkDeviceSize offset = 0;
+
+            vkCmdBindVertexBuffers(commandBuffer, 0, 1, &draw.vertexBuffer, &offset);
+            boundVertexBuffer = draw.vertexBuffer;
+
+            ++stats.bufferBinds;
+        }
+
+        if (draw.indexBuffer != boundIndexBuffer) {
+            vkCmdBindIndexBuffer(commandBuffer, draw.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+            boundIndexBuffer = draw.indexBuffer;
+
+            ++stats.bufferBinds;
+        }
+
+        // Push constants are per draw, so they are always recorded.
+        for (uint32_t i = 0; i < pushConstantUpdateCount; ++i) {
+            const auto& update = pushConstantUpdates[pushConstantUpdateOffset + i];
+
+            vkCmdPushConstants(commandBuffer, draw.pipelineLayout, update.stageFlags, update.offset, update.size, pushConstantBytes.data() + pushConstantOffset + update.offset);
+        }
+
+        vkCmdDrawIndexed(commandBuffer, draw.indexCount, 1, draw.firstIndex, draw.vertexOffset, 0);
+
+        ++stats.draws;
+    }
+
+    return stats;
+}
+
+size_t vox::RenderQueue::getSize() const {
+    return items.size();
+}
@@ -0,0 +1,129 @@
+#ifndef VOX_RENDER_QUEUE_H
+#define VOX_RENDER_QUEUE_H
+
+/**
+ * Render queue, recording draws in the order of a 64-bit sort key.
+ *
+ * From the most significant bits down, a key holds:
+ * - the pass (4 bits), so opaque draws come before transparent ones;
+ * - the pipeline (20 bits), interned per frame;
+ * - the material (16 bits), i.e. the descriptor sets, interned per frame;
+ * - the depth (24 bits), front to back, or back to front for transparent draws.
+ *
+ * Keys are radix-sorted, skipping the bytes every key shares, and recording
+ * only binds what changed since the previous draw. State changes then scale
+ * with the distinct pipelines and materials drawn, not with the draw count.
+ *
+ * Buffers are kept between frames, so a steady workload allocates nothing.
+ * Once sorted, ranges of the queue can be recorded from several threads at
+ * once, each into its own command buffer.
+ */
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan_core.h>
+
+#include "../misc/constants.h"
+
+namespace vox {
+    enum class RenderQueuePass : uint8_t {
+        Opaque,
+        Transparent
+    };
+
+    // Descriptor sets bound from set 0; unused trailing ones are VK_NULL_HANDLE.
+    using RenderMaterial = std::array<VkDescriptorSet, RENDER_QUEUE_MAX_DESCRIPTOR_SETS>;
+
+    struct RenderDraw {
+        VkPipeline pipeline;
+        VkPipelineLayout pipelineLayout;
+        RenderMaterial material;
+
+        VkBuffer vertexBuffer;
+        VkBuffer indexBuffer;
+
+        uint32_t indexCount;
+        uint32_t firstIndex;
+        int32_t vertexOffset;
+    };
+
+    // Binds recorded into a command buffer.
+    struct RenderQueueStats {
+        uint32_t draws;
+        uint32_t pipelineBinds;
+        uint32_t descriptorSetBinds;
+        uint32_t bufferBinds;
+
+        RenderQueueStats& operator+=(const RenderQueueStats& other) {
+            draws += other.draws;
+            pipelineBinds += other.pipelineBinds;
+            descriptorSetBinds += other.descriptorSetBinds;
+            bufferBinds += other.bufferBinds;
+
+            return *this;
+        }
+    };
+
+    class RenderQueue {
+        struct Item {
+            RenderDraw draw;
+
+            // Slices of pushConstantBytes and pushConstantUpdates.
+            uint32_t pushConstantOffset;
+            uint32_t pushConstantUpdateOffset;
+            uint32_t pushConstantUpdateCount;
+        };
+
+        struct Entry {
+            uint64_t key;
+            uint32_t item;
+        };
+
+        std::vector<Item> items = {};
+        std::vector<Entry> entries = {};
+        std::vector<Entry> sortBuffer = {};
+
+        std::vector<char> pushConstantBytes = {};
+        std::vector<VkPushConstantRange> pushConstantUpdates = {};
+
+        std::unordered_map<VkPipeline, uint32_t> pipelineIndices = {};
+        std::map<RenderMaterial, uint32_t> materialIndices = {};
+
+        [[nodiscard]] uint64_t getKey(RenderQueuePass pass, const RenderDraw& draw, float depth);
+
+    public:
+        RenderQueue() = default;
+
+        RenderQueue(const RenderQueue& other) = delete;
+
+        RenderQueue(RenderQueue&& other) noexcept = delete;
+
+        RenderQueue& operator=(const RenderQueue& other) = delete;
+
+        RenderQueue& operator=(RenderQueue&& other) = delete;
+
+        ~RenderQueue() = default;
+
+        // Drops the draws of the previous frame, keeping their memory.
+        void clear();
+
+        // Queues a draw; depth is its non-negative distance to the camera. The push constant
+        // bytes are copied, and pushed in the given pieces (see ShaderReflection::getPushConstantUpdates).
+        void submit(RenderQueuePass pass, const RenderDraw& draw, float depth, std::span<const char> pushConstants, std::span<const VkPushConstantRange> pushConstantRanges);
+
+        void sort();
+
+        // Records the queued draws in [begin, end) of key order; sort must have been called since the last submit.
+        // Nothing is assumed bound beforehand, so disjoint ranges may be recorded concurrently.
+        RenderQueueStats record(VkCommandBuffer commandBuffer, size_t begin, size_t end) const;
+
+        [[nodiscard]] size_t getSize() const;
+    };
+}
+
+#endif
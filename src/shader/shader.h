@@ -1,11 +1,15 @@
 #ifndef SHADERS_H
 #define SHADERS_H
 
+#include <algorithm>
+#include <bit>
 #include <filesystem>
 #include <functional>
 #include <iostream>
 #include <map>
 #include <optional>
+#include <ranges>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
@@ -13,13 +17,25 @@
 #include <nlohmann/json.hpp>
 #include <vulkan/vulkan_core.h>
 
+#include "shader_reflection.h"
+#include "../descriptor/descriptor_allocator.h"
+#include "../misc/constants.h"
 #include "../misc/util.h"
 #include "../vertex/vertex.h"
 
 namespace vox {
+    // Type names are parsed into GLMTypes once, when the metadata is loaded.
+    inline void from_json(const nlohmann::json& json, GLMType& type) {
+        type = parseGLMType(json.get<std::string>());
+    }
+
+    inline void to_json(nlohmann::json& json, const GLMType& type) {
+        json = std::string(getGLMTypeInfo(type).name);
+    }
+
     struct ShaderMetadataAttribute {
         std::string name;
-        std::string type;
+        GLMType type;
     };
 
     struct ShaderMetadataSampler {
@@ -29,13 +45,26 @@ namespace vox {
 
     struct ShaderMetadataUniform {
         std::string name;
-        std::string type;
+        GLMType type;
 
         [[nodiscard]] VkFormat format() const {
             return GLMTypeToVkFormat(type);
         }
     };
 
+    struct ShaderMetadataSpecialization {
+        std::string name;
+
+        // The constant_id the code declares it with.
+        uint32_t id;
+
+        // One of bool, int, uint or float.
+        GLMType type;
+
+        // Used by every variant that does not override it.
+        double value;
+    };
+
     struct ShaderMetadata {
         std::string vertex;
         std::string fragment;
@@ -43,12 +72,56 @@ namespace vox {
         std::vector<ShaderMetadataAttribute> attributes;
         std::vector<ShaderMetadataSampler> samplers;
         std::vector<ShaderMetadataUniform> uniforms;
+
+        // Small, per-draw values, written with setPushConstant.
+        std::vector<ShaderMetadataUniform> pushConstants;
+
+        std::vector<ShaderMetadataSpecialization> specializations;
+
+        // Named variants, by the specializations they override, e.g. { "cutout": { "alphaTest": 1 } }.
+        std::map<std::string, std::map<std::string, double>> variants;
+    };
+
+    // Specialization constants of one variant, as pointed to by a VkSpecializationInfo.
+    struct ShaderSpecialization {
+        std::vector<VkSpecializationMapEntry> entries;
+        std::vector<uint32_t> data;
+
+        [[nodiscard]] VkSpecializationInfo getInfo() const {
+            return { static_cast<uint32_t>(entries.size()), entries.data(), data.size() * sizeof(uint32_t), data.data() };
+        }
     };
 
     NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(ShaderMetadataAttribute, name, type);
     NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(ShaderMetadataSampler, name, type);
     NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(ShaderMetadataUniform, name, type);
-    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(ShaderMetadata, vertex, fragment, attributes, samplers, uniforms);
+    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(ShaderMetadataSpecialization, name, id, type, value);
+
+    inline void to_json(nlohmann::json& json, const ShaderMetadata& metadata) {
+        json = {
+            { "vertex", metadata.vertex },
+            { "fragment", metadata.fragment },
+            { "attributes", metadata.attributes },
+            { "samplers", metadata.samplers },
+            { "uniforms", metadata.uniforms },
+            { "pushConstants", metadata.pushConstants },
+            { "specializations", metadata.specializations },
+            { "variants", metadata.variants }
+        };
+    }
+
+    // Push constants, specializations and variants are optional, and empty when left out.
+    inline void from_json(const nlohmann::json& json, ShaderMetadata& metadata) {
+        json.at("vertex").get_to(metadata.vertex);
+        json.at("fragment").get_to(metadata.fragment);
+        json.at("attributes").get_to(metadata.attributes);
+        json.at("samplers").get_to(metadata.samplers);
+        json.at("uniforms").get_to(metadata.uniforms);
+
+        metadata.pushConstants = json.value("pushConstants", std::vector<ShaderMetadataUniform>{});
+        metadata.specializations = json.value("specializations", std::vector<ShaderMetadataSpecialization>{});
+        metadata.variants = json.value("variants", std::map<std::string, std::map<std::string, double>>{});
+    }
 
     struct ShaderBoundBufferInfo {
         std::vector<VkBuffer*> buffers;
@@ -89,6 +162,12 @@ namespace vox {
               fragmentShaderCode(std::move(other.fragmentShaderCode)),
               vertexShaderModule(std::move(other.vertexShaderModule)),
               fragmentShaderModule(std::move(other.fragmentShaderModule)),
+              reflection(std::move(other.reflection)),
+              uniformBinding(other.uniformBinding),
+              pushConstantBytes(std::move(other.pushConstantBytes)),
+              pushConstantOffsets(std::move(other.pushConstantOffsets)),
+              pushConstantSizes(std::move(other.pushConstantSizes)),
+              pushConstantUpdates(std::move(other.pushConstantUpdates)),
               descriptorSetLayout(std::move(other.descriptorSetLayout)),
               descriptorSets(std::move(other.descriptorSets)),
               boundBuffers(std::move(other.boundBuffers)),
@@ -104,6 +183,12 @@ namespace vox {
                 fragmentShaderCode = std::move(other.fragmentShaderCode);
                 vertexShaderModule = std::move(other.vertexShaderModule);
                 fragmentShaderModule = std::move(other.fragmentShaderModule);
+                reflection = std::move(other.reflection);
+                uniformBinding = other.uniformBinding;
+                pushConstantBytes = std::move(other.pushConstantBytes);
+                pushConstantOffsets = std::move(other.pushConstantOffsets);
+                pushConstantSizes = std::move(other.pushConstantSizes);
+                pushConstantUpdates = std::move(other.pushConstantUpdates);
                 descriptorSetLayout = std::move(other.descriptorSetLayout);
                 descriptorSets = std::move(other.descriptorSets);
                 boundBuffers = std::move(other.boundBuffers);
@@ -122,6 +207,7 @@ namespace vox {
 
         std::vector<char> uniformBytes;
         std::map<std::string, size_t> uniformOffsets;
+        std::map<std::string, size_t> uniformSizes;
 
         std::vector<std::unique_ptr<VkBuffer>> uniformBuffers;
         std::vector<std::unique_ptr<VkDeviceMemory>> uniformBufferMemories;
@@ -132,6 +218,17 @@ namespace vox {
         std::optional<VkShaderModule> vertexShaderModule;
         std::optional<VkShaderModule> fragmentShaderModule;
 
+        ShaderReflection reflection;
+
+        // Binding of the SHADER_UNIFORM_BLOCK block, if the code declares one.
+        std::optional<uint32_t> uniformBinding;
+
+        // Push constants are recorded straight into the command buffer, so they need no buffers.
+        std::vector<char> pushConstantBytes;
+        std::map<std::string, size_t> pushConstantOffsets;
+        std::map<std::string, size_t> pushConstantSizes;
+        std::vector<VkPushConstantRange> pushConstantUpdates;
+
         std::optional<VkDescriptorSetLayout> descriptorSetLayout;
 
         std::vector<VkDescriptorSet> descriptorSets;
@@ -140,20 +237,30 @@ namespace vox {
         std::map<uint32_t, std::optional<ShaderBoundImageInfo>> boundImages;
 
     public:
+        // Reflects the vertex and fragment code, and reserves every binding of
+        // set 0 they declare. Must be called before anything is bound.
+        void reflect();
+
         void initUniformBytesAndOffsets();
 
         VkVertexInputBindingDescription getBindingDescription();
         std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions();
 
         void buildDescriptorSetLayout(const VkDevice& device);
-        void buildDescriptorSets(const VkDevice& device, const VkDescriptorPool& descriptorPool, uint32_t amount);
+        void buildDescriptorSets(const VkDevice& device, DescriptorAllocator& descriptorAllocator, uint32_t amount);
+
+        // Points every descriptor set at the bound buffers and images, e.g. again
+        // after a bound image view was replaced. Sets already in use are never
+        // rewritten; other contents get other sets, cached by the allocator.
+        void writeDescriptorSets(const VkDevice& device, DescriptorAllocator& descriptorAllocator);
 
-        void buildBuffers(const std::function<VkResult(VkBuffer*, VkDeviceMemory*, VkDeviceSize)> &buildBuffer);
+        // Builds one uniform buffer per frame in flight.
+        void buildBuffers(const std::function<VkResult(VkBuffer*, VkDeviceMemory*, VkDeviceSize)> &buildBuffer, uint32_t amount);
 
-        void reserveBuffer();
         void reserveBuffer(uint32_t binding);
         void reserveSampler(uint32_t binding);
 
+        // Bindings the code does not declare are ignored.
         void bindBuffer(uint32_t binding, const std::vector<VkBuffer*> &buffers, VkDeviceSize offset, VkDeviceSize range, const std::vector<VkDeviceMemory*> &memories, const std::vector<void *> &mapped);
         void bindSampler(uint32_t binding, VkImageView *imageView, VkSampler *sampler, VkImageLayout imageLayout);
 
@@ -167,6 +274,16 @@ namespace vox {
         template<class T>
         void setUniform(const std::string &name, const T &value);
 
+        // Push constants the code does not declare are ignored.
+        template<class T>
+        void setPushConstant(const std::string &name, const T &value);
+
+        // Records the current push constant values, for the draws that follow.
+        void pushConstants(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout) const;
+
+        // Specialization constants of a variant named in the metadata; the empty name is the defaults.
+        [[nodiscard]] ShaderSpecialization getSpecialization(const std::string& variant) const;
+
         [[nodiscard]] std::string getId() const;
         [[nodiscard]] ShaderMetadata getMetadata() const;
         [[nodiscard]] std::vector<char> getUniformBytes() const;
@@ -179,6 +296,12 @@ namespace vox {
         [[nodiscard]] std::vector<VkDescriptorSet> getDescriptorSets() const;
         [[nodiscard]] std::map<uint32_t, std::optional<ShaderBoundBufferInfo>> getBoundBuffers() const;
         [[nodiscard]] std::map<uint32_t, std::optional<ShaderBoundImageInfo>> getBoundImages() const;
+        [[nodiscard]] const ShaderReflection& getReflection() const;
+        [[nodiscard]] std::vector<VkPushConstantRange> getPushConstantRanges() const;
+
+        // Current push constant values, and the pieces pushConstants records them in.
+        [[nodiscard]] std::span<const char> getPushConstantBytes() const;
+        [[nodiscard]] std::span<const VkPushConstantRange> getPushConstantUpdates() const;
 
         void setId(const std::string &id);
         void setMetadata(const ShaderMetadata &metadata);
@@ -195,20 +318,94 @@ namespace vox {
     };
 
     template<typename V>
-    void Shader<V>::initUniformBytesAndOffsets() {
-        size_t currentOffset = 0;
+    void Shader<V>::reflect() {
+        if (!vertexShaderCode.has_value() || vertexShaderCode->empty() || !fragmentShaderCode.has_value() || fragmentShaderCode->empty()) {
+            throw std::runtime_error("[Shader] Code not present in shader: " + id);
+        }
+
+        reflection = ShaderReflection::parse(vertexShaderCode.value());
+        reflection.merge(ShaderReflection::parse(fragmentShaderCode.value()));
 
+        // Set 0 belongs to the shader; other sets are shared, like the texture table.
+        for (const auto& binding : reflection.bindings) {
+            if (binding.set != 0) continue;
+
+            if (binding.type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || binding.type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) {
+                reserveBuffer(binding.binding);
+            } else {
+                reserveSampler(binding.binding);
+            }
+        }
+
+        const auto block = reflection.findBlock(SHADER_UNIFORM_BLOCK);
+
+        if (block != nullptr && block->set == 0) {
+            uniformBinding = block->binding;
+        }
+
+        // The metadata no longer drives the layout; only report where it drifted from the code.
         for (const auto& [name, type] : metadata.uniforms) {
-            if (name == "ubo") continue;
+            if (type == GLMType::Ubo) continue;
+
+            const auto member = block != nullptr ? block->findMember(name) : nullptr;
+
+            if (member == nullptr) {
+                std::cerr << "[Shader] Uniform '" << name << "' of shader " << id << " is not declared by its code.\n";
+            } else if (member->type != type) {
+                std::cerr << "[Shader] Uniform '" << name << "' of shader " << id << " is a " << getGLMTypeInfo(type).name << " in its metadata, but not in its code.\n";
+            }
+        }
+
+        for (const auto& [name, type] : metadata.pushConstants) {
+            const auto member = reflection.findPushConstant(name);
+
+            if (member == nullptr) {
+                std::cerr << "[Shader] Push constant '" << name << "' of shader " << id << " is not declared by its code.\n";
+            } else if (member->type != type) {
+                std::cerr << "[Shader] Push constant '" << name << "' of shader " << id << " is a " << getGLMTypeInfo(type).name << " in its metadata, but not in its code.\n";
+            }
+        }
+
+        for (const auto& specialization : metadata.specializations) {
+            const auto constant = reflection.findSpecialization(specialization.id);
+
+            if (constant == nullptr) {
+                std::cerr << "[Shader] Specialization '" << specialization.name << "' of shader " << id << " has no constant " << specialization.id << " in its code.\n";
+            } else if (constant->type != specialization.type) {
+                std::cerr << "[Shader] Specialization '" << specialization.name << "' of shader " << id << " is a " << getGLMTypeInfo(specialization.type).name << " in its metadata, but not in its code.\n";
+            }
+        }
 
-            const size_t alignment = GLMTypeAlignment(type);
-            currentOffset = GLMTypeAlignUp(currentOffset, alignment);
+        pushConstantOffsets.clear();
+        pushConstantSizes.clear();
 
-            uniformOffsets[name] = currentOffset;
-            currentOffset += GLMTypeAlignment(type);
+        for (const auto& member : reflection.pushConstants) {
+            pushConstantOffsets[member.name] = member.offset;
+            pushConstantSizes[member.name] = member.size;
         }
 
-        uniformBytes.resize(currentOffset);
+        pushConstantUpdates = reflection.getPushConstantUpdates();
+        pushConstantBytes.assign(pushConstantUpdates.empty() ? 0 : pushConstantUpdates.back().offset + pushConstantUpdates.back().size, 0);
+    }
+
+    template<typename V>
+    void Shader<V>::initUniformBytesAndOffsets() {
+        uniformOffsets.clear();
+        uniformSizes.clear();
+
+        if (!uniformBinding.has_value()) {
+            uniformBytes.clear();
+            return;
+        }
+
+        const auto block = reflection.findBinding(0, uniformBinding.value());
+
+        for (const auto& member : block->members) {
+            uniformOffsets[member.name] = member.offset;
+            uniformSizes[member.name] = member.size;
+        }
+
+        uniformBytes.resize(block->size);
     }
 
     template<typename V>
@@ -218,29 +415,52 @@ namespace vox {
 
     template<typename V>
     std::vector<VkVertexInputAttributeDescription> Shader<V>::getAttributeDescriptions() {
-        return V::getAttributeDescriptions();
+        auto descriptions = V::getAttributeDescriptions();
+
+        if (reflection.stages == 0) {
+            return descriptions;
+        }
+
+        // Attributes the vertex stage does not read are left out of the pipeline.
+        std::erase_if(descriptions, [&](const auto& description) {
+            return std::ranges::none_of(reflection.inputs, [&](const auto& input) { return input.location == description.location; });
+        });
+
+        for (const auto& input : reflection.inputs) {
+            const auto description = std::ranges::find(descriptions, input.location, &VkVertexInputAttributeDescription::location);
+
+            if (description == descriptions.end()) {
+                throw std::runtime_error("[Shader] Vertex input '" + input.name + "' of shader " + id + " has no vertex attribute at location " + std::to_string(input.location) + "!");
+            }
+
+            if (description->format != input.format) {
+                std::cerr << "[Shader] Vertex input '" << input.name << "' of shader " << id << " has format " << input.format << ", but its attribute has format " << description->format << ".\n";
+            }
+        }
+
+        return descriptions;
     }
 
     template<typename V>
     void Shader<V>::buildDescriptorSetLayout(const VkDevice &device) {
+        if (reflection.stages == 0) {
+            throw std::runtime_error("[Shader] Shader was not reflected before building its descriptor set layout: " + id);
+        }
+
         std::vector<VkDescriptorSetLayoutBinding> bindings;
 
-        for (const auto &binding: boundBuffers | std::views::keys) {
-            bindings.push_back({
-                .binding = binding,
-                .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                .descriptorCount = 1,
-                .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
-                .pImmutableSamplers = nullptr
-            });
-        }
+        for (const auto& binding : reflection.bindings) {
+            if (binding.set != 0) continue;
+
+            if (binding.count == 0) {
+                throw std::runtime_error("[Shader] Runtime array at binding " + std::to_string(binding.binding) + " of shader " + id + " must be in a shared set!");
+            }
 
-        for (const auto &binding: boundImages | std::views::keys) {
             bindings.push_back({
-                .binding = binding,
-                .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                .descriptorCount = 1,
-                .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
+                .binding = binding.binding,
+                .descriptorType = binding.type,
+                .descriptorCount = binding.count,
+                .stageFlags = binding.stages,
                 .pImmutableSamplers = nullptr
             });
         }
@@ -259,88 +479,70 @@ namespace vox {
     }
 
     template<typename V>
-    void Shader<V>::buildDescriptorSets(const VkDevice &device, const VkDescriptorPool &descriptorPool, uint32_t amount) {
-        VkDescriptorSetAllocateInfo allocInfo = {};
-        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocInfo.descriptorPool = descriptorPool;
-        allocInfo.descriptorSetCount = amount;
-
-        const auto descriptorSetLayouts = std::vector(amount, descriptorSetLayout.value());
-
-        if (this->descriptorSetLayout.has_value()) {
-            allocInfo.pSetLayouts = descriptorSetLayouts.data();
-        } else {
+    void Shader<V>::buildDescriptorSets(const VkDevice &device, DescriptorAllocator &descriptorAllocator, const uint32_t amount) {
+        if (!descriptorSetLayout.has_value()) {
             throw std::runtime_error("[Shader] Descriptor set layout not present in shader: " + id);
         }
 
         descriptorSets.resize(amount);
 
-        if (VK_SUCCESS != vkAllocateDescriptorSets(device, &allocInfo, descriptorSets.data())) {
-            throw std::runtime_error("[Shader] Failed to allocate descriptor sets for shader: " + id);
-        }
+        writeDescriptorSets(device, descriptorAllocator);
+    }
 
-        for (auto i = 0; i < amount; ++i) {
-            // We need to save the values in these maps
-            // because otherwise they go out of scope
-            // in the loops and pointer to nowhere.
-            std::map<uint32_t, VkDescriptorBufferInfo> bufferInfos;
-            std::map<uint32_t, VkDescriptorImageInfo> imageInfos;
+    template<typename V>
+    void Shader<V>::writeDescriptorSets(const VkDevice &device, DescriptorAllocator &descriptorAllocator) {
+        std::vector<DescriptorWrite> descriptorWrites;
+        descriptorWrites.reserve(boundBuffers.size() + boundImages.size());
 
-            std::vector<VkWriteDescriptorSet> descriptorWrites;
+        for (auto i = 0; i < descriptorSets.size(); ++i) {
+            descriptorWrites.clear();
 
             for (const auto& [binding, buffer] : boundBuffers) {
-                bufferInfos[binding] = { *buffer->buffers[i], buffer->offset, buffer->range };
-
-                VkWriteDescriptorSet writeDescriptorSet;
-                writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                writeDescriptorSet.dstSet = descriptorSets[i];
-                writeDescriptorSet.dstBinding = binding;
-                writeDescriptorSet.dstArrayElement = 0;
-                writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-                writeDescriptorSet.descriptorCount = 1;
-                writeDescriptorSet.pBufferInfo = &bufferInfos[binding];
-                writeDescriptorSet.pNext = nullptr;
-
-                descriptorWrites.push_back(writeDescriptorSet);
+                if (!buffer.has_value()) {
+                    throw std::runtime_error("[Shader] Nothing bound to binding " + std::to_string(binding) + " of shader: " + id);
+                }
+
+                descriptorWrites.push_back({
+                    .binding = binding,
+                    .type = reflection.findBinding(0, binding)->type,
+                    .bufferInfo = { *buffer->buffers[i], buffer->offset, buffer->range },
+                    .imageInfo = {}
+                });
             }
 
             for (const auto& [binding, image] : boundImages) {
-                imageInfos[i] = { *image->sampler, *image->imageView, image->imageLayout };
-
-                VkWriteDescriptorSet writeDescriptorSet = {};
-                writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                writeDescriptorSet.dstSet = descriptorSets[i];
-                writeDescriptorSet.dstBinding = binding;
-                writeDescriptorSet.dstArrayElement = 0;
-                writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-                writeDescriptorSet.descriptorCount = 1;
-                writeDescriptorSet.pImageInfo = &imageInfos[i];
-                writeDescriptorSet.pNext = nullptr;
-
-                descriptorWrites.push_back(writeDescriptorSet);
+                if (!image.has_value()) {
+                    throw std::runtime_error("[Shader] Nothing bound to binding " + std::to_string(binding) + " of shader: " + id);
+                }
+
+                descriptorWrites.push_back({
+                    .binding = binding,
+                    .type = reflection.findBinding(0, binding)->type,
+                    .bufferInfo = {},
+                    .imageInfo = { *image->sampler, *image->imageView, image->imageLayout }
+                });
             }
 
-            if (!descriptorWrites.empty()) {
-                vkUpdateDescriptorSets(device, descriptorWrites.size(), descriptorWrites.data(), 0, nullptr);
+            if (VK_SUCCESS != descriptorAllocator.getCached(device, descriptorSetLayout.value(), descriptorWrites, descriptorSets[i])) {
+                throw std::runtime_error("[Shader] Failed to allocate descriptor sets for shader: " + id);
             }
         }
     }
 
     template<typename V>
-    void Shader<V>::reserveBuffer() {
-        reserveBuffer(2); // "Extras" uniform block.
-    }
-
-    template<typename V>
-    void Shader<V>::buildBuffers(const std::function<VkResult(VkBuffer*, VkDeviceMemory*, VkDeviceSize)> &buildBuffer) {
+    void Shader<V>::buildBuffers(const std::function<VkResult(VkBuffer*, VkDeviceMemory*, VkDeviceSize)> &buildBuffer, const uint32_t amount) {
         initUniformBytesAndOffsets();
 
-        auto buffers = std::vector<VkBuffer*>(3);
-        auto bufferMemories = std::vector<VkDeviceMemory*>(3);
+        if (!uniformBinding.has_value()) {
+            return;
+        }
 
-        const auto buffersMapped = std::vector<void*>(3);
+        auto buffers = std::vector<VkBuffer*>(amount);
+        auto bufferMemories = std::vector<VkDeviceMemory*>(amount);
 
-        for (auto i = 0; i < 3; ++i) {
+        const auto buffersMapped = std::vector<void*>(amount);
+
+        for (uint32_t i = 0; i < amount; ++i) {
             VkBuffer buffer;
             VkDeviceMemory bufferMemory;
 
@@ -355,7 +557,7 @@ namespace vox {
             bufferMemories[i] = uniformBufferMemories[i].get();
         }
 
-        boundBuffers[2] = { buffers, 0, uniformBytes.size(), bufferMemories, buffersMapped };
+        boundBuffers[uniformBinding.value()] = { buffers, 0, uniformBytes.size(), bufferMemories, buffersMapped };
     }
 
     template<typename V>
@@ -370,11 +572,23 @@ namespace vox {
 
     template<typename V>
     void Shader<V>::bindBuffer(const uint32_t binding, const std::vector<VkBuffer*>& buffers, const VkDeviceSize offset, const VkDeviceSize range, const std::vector<VkDeviceMemory*>& memories, const std::vector<void*>& mapped) {
+        if (!boundBuffers.contains(binding)) {
+            return;
+        }
+
+        if (const auto block = reflection.findBinding(0, binding); block != nullptr && range < block->size) {
+            throw std::runtime_error("[Shader] Buffer bound to binding " + std::to_string(binding) + " of shader " + id + " is smaller than its block (" + std::to_string(range) + " < " + std::to_string(block->size) + " bytes)!");
+        }
+
         boundBuffers[binding] = { buffers, offset, range, memories, mapped };
     }
 
     template<typename V>
     void Shader<V>::bindSampler(const uint32_t binding, VkImageView* imageView, VkSampler* sampler, const VkImageLayout imageLayout) {
+        if (!boundImages.contains(binding)) {
+            return;
+        }
+
         boundImages[binding] = { imageView, sampler, imageLayout };
     }
 
@@ -401,22 +615,93 @@ namespace vox {
 
     template<typename V>
     void Shader<V>::uploadUniforms(const VkDevice& device, uint32_t currentImage) {
+        if (!uniformBinding.has_value()) {
+            return;
+        }
+
+        const auto memory = *boundBuffers[uniformBinding.value()]->memories[currentImage];
+
         void* data;
-        vkMapMemory(device, *boundBuffers[2]->memories[currentImage], 0, uniformBytes.size(), 0, &data);
+        vkMapMemory(device, memory, 0, uniformBytes.size(), 0, &data);
         memcpy(data, uniformBytes.data(), uniformBytes.size());
-        vkUnmapMemory(device, *boundBuffers[2]->memories[currentImage]);
+        vkUnmapMemory(device, memory);
     }
 
     template<typename V>
     template<typename T>
     void Shader<V>::setUniform(const std::string& name, const T& value) {
         if (const auto offset = uniformOffsets.find(name); offset != uniformOffsets.end()) {
-            memcpy(uniformBytes.data() + offset->second, &value, sizeof(T));
+            // Never write past the member, e.g. for aligned 16-byte vec3s into 12-byte members.
+            memcpy(uniformBytes.data() + offset->second, &value, std::min(sizeof(T), uniformSizes[name]));
         } else {
             std::cerr << "[Vulkan] Uniform name '" << name << "' not found.\n";
         }
     }
 
+    template<typename V>
+    template<class T>
+    void Shader<V>::setPushConstant(const std::string& name, const T& value) {
+        if (const auto offset = pushConstantOffsets.find(name); offset != pushConstantOffsets.end()) {
+            memcpy(pushConstantBytes.data() + offset->second, &value, std::min(sizeof(T), pushConstantSizes[name]));
+        }
+    }
+
+    template<typename V>
+    void Shader<V>::pushConstants(const VkCommandBuffer commandBuffer, const VkPipelineLayout pipelineLayout) const {
+        for (const auto& update : pushConstantUpdates) {
+            vkCmdPushConstants(commandBuffer, pipelineLayout, update.stageFlags, update.offset, update.size, pushConstantBytes.data() + update.offset);
+        }
+    }
+
+    template<typename V>
+    ShaderSpecialization Shader<V>::getSpecialization(const std::string& variant) const {
+        const std::map<std::string, double>* overrides = nullptr;
+
+        if (!variant.empty()) {
+            const auto found = metadata.variants.find(variant);
+
+            if (found == metadata.variants.end()) {
+                throw std::runtime_error("[Shader] Unknown variant '" + variant + "' of shader: " + id);
+            }
+
+            overrides = &found->second;
+
+            for (const auto& name : *overrides | std::views::keys) {
+                if (std::ranges::none_of(metadata.specializations, [&](const auto& s) { return s.name == name; })) {
+                    throw std::runtime_error("[Shader] Variant '" + variant + "' of shader " + id + " overrides unknown specialization: " + name);
+                }
+            }
+        }
+
+        ShaderSpecialization specialization;
+
+        for (const auto& [name, constantId, type, defaultValue] : metadata.specializations) {
+            auto value = defaultValue;
+
+            if (overrides != nullptr) {
+                if (const auto override = overrides->find(name); override != overrides->end()) {
+                    value = override->second;
+                }
+            }
+
+            // Every supported type is 4 bytes wide, bools included (VkBool32).
+            uint32_t word;
+
+            switch (type) {
+                case GLMType::Bool: word = value != 0.0 ? VK_TRUE : VK_FALSE; break;
+                case GLMType::Int: word = std::bit_cast<uint32_t>(static_cast<int32_t>(value)); break;
+                case GLMType::Uint: word = static_cast<uint32_t>(value); break;
+                case GLMType::Float: word = std::bit_cast<uint32_t>(static_cast<float>(value)); break;
+                default: throw std::runtime_error("[Shader] Unsupported type for specialization '" + name + "' of shader: " + id);
+            }
+
+            specialization.entries.push_back({ constantId, static_cast<uint32_t>(specialization.data.size() * sizeof(uint32_t)), sizeof(uint32_t) });
+            specialization.data.push_back(word);
+        }
+
+        return specialization;
+    }
+
     template<typename V>
     std::string Shader<V>::getId() const { return id; }
 
@@ -453,6 +738,18 @@ namespace vox {
     template<typename V>
     std::map<uint32_t, std::optional<ShaderBoundImageInfo>> Shader<V>::getBoundImages() const { return boundImages; }
 
+    template<typename V>
+    const ShaderReflection& Shader<V>::getReflection() const { return reflection; }
+
+    template<typename V>
+    std::vector<VkPushConstantRange> Shader<V>::getPushConstantRanges() const { return reflection.pushConstantRanges; }
+
+    template<typename V>
+    std::span<const char> Shader<V>::getPushConstantBytes() const { return pushConstantBytes; }
+
+    template<typename V>
+    std::span<const VkPushConstantRange> Shader<V>::getPushConstantUpdates() const { return pushConstantUpdates; }
+
     template<typename V>
     void Shader<V>::setId(const std::string &id) { this->id = id; }
 
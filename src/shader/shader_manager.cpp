@@ -17,6 +17,63 @@ std::unordered_map<std::string, vox::Shader<>> &vox::ShaderManager::getAll() {
     return shaders;
 }
 
+std::vector<char> vox::ShaderManager::readCode(const std::filesystem::path& path) {
+    std::ifstream shaderFile(path, std::ios::ate | std::ios::binary);
+
+    if (!shaderFile.is_open()) {
+        throw std::runtime_error("[Vulkan] Failed to load shader file: " + path.filename().string() + "\n");
+    }
+
+    std::vector<char> buffer(static_cast<size_t>(shaderFile.tellg()));
+    shaderFile.seekg(0);
+    shaderFile.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    shaderFile.close();
+
+    return buffer;
+}
+
+vox::ShaderMetadata vox::ShaderManager::readMetadata(const std::filesystem::path& path) {
+    std::ifstream metadataFile(path);
+
+    if (!metadataFile.is_open()) {
+        throw std::runtime_error("[Vulkan] Failed to load shader metadata file: " + path.filename().string() + "\n");
+    }
+
+    nlohmann::json metadata;
+    metadataFile >> metadata;
+    metadataFile.close();
+
+    return metadata.get<ShaderMetadata>();
+}
+
+vox::Shader<> vox::ShaderManager::load(const std::string& id) {
+    const auto metadata = readMetadata(std::filesystem::path("shaders/metadata") / (id + ".json"));
+
+    auto vertexCode = readCode(std::filesystem::path("shaders/spirv") / (metadata.vertex + ".vert"));
+    auto fragmentCode = readCode(std::filesystem::path("shaders/spirv") / (metadata.fragment + ".frag"));
+
+    return Shader<>(id, metadata, std::move(vertexCode), std::move(fragmentCode));
+}
+
+std::vector<std::string> vox::ShaderManager::getDependents(const std::filesystem::path& file) const {
+    const auto extension = file.extension();
+    const auto stem = file.stem().string();
+
+    std::vector<std::string> dependents;
+
+    for (const auto& [id, shader] : shaders) {
+        const auto& metadata = shader.getMetadata();
+
+        if ((extension == ".json" && id == stem) ||
+            (extension == ".vert" && metadata.vertex == stem) ||
+            (extension == ".frag" && metadata.fragment == stem)) {
+            dependents.push_back(id);
+        }
+    }
+
+    return dependents;
+}
+
 void vox::ShaderManager::loadAll() {
     std::map<std::string, ShaderMetadata> shaderMetadata;
 
@@ -27,23 +84,12 @@ void vox::ShaderManager::loadAll() {
 
     for (const auto& shaderEntry : shaderCodeIterator) {
         if (shaderEntry.path().extension() == ".vert" || shaderEntry.path().extension() == ".frag") {
-            std::ifstream shaderFile(shaderEntry.path(), std::ios::ate | std::ios::binary);
-
-            if (!shaderFile.is_open()) {
-                throw std::runtime_error("[Vulkan] Failed to load shader file: " + shaderEntry.path().filename().string() + "\n");
-            }
-
-            std::vector<char> buffer(shaderEntry.file_size());
-            shaderFile.seekg(0);
-            shaderFile.read(buffer.data(), shaderEntry.file_size());
-            shaderFile.close();
-
             std::string id = shaderEntry.path().stem().string();
 
             if (shaderEntry.path().extension() == ".vert") {
-                shaderVertexCode[id] = buffer;
+                shaderVertexCode[id] = readCode(shaderEntry.path());
             } else if (shaderEntry.path().extension() == ".frag") {
-                shaderFragmentCode[id] = buffer;
+                shaderFragmentCode[id] = readCode(shaderEntry.path());
             }
 
             std::cout << "[Vulkan] Loaded shader file: " << shaderEntry.path().filename().string() << "\n" << std::flush;
@@ -54,18 +100,8 @@ void vox::ShaderManager::loadAll() {
 
     for (const auto& metadataEntry : shaderMetadataIterator) {
         if (metadataEntry.path().extension() == ".json") {
-            std::ifstream metadataFile(metadataEntry.path());
-
-            if (!metadataFile.is_open()) {
-                throw std::runtime_error("[Vulkan] Failed to load shader metadata file: " + metadataEntry.path().filename().string() + "\n");
-            }
-
-            nlohmann::json metadata;
-            metadataFile >> metadata;
-            metadataFile.close();
-
             std::string id = metadataEntry.path().stem().string();
-            shaderMetadata[id] = metadata.get<ShaderMetadata>();
+            shaderMetadata[id] = readMetadata(metadataEntry.path());
 
             std::cout << "[Vulkan] Loaded shader metadata file: " << id << ".json\n" << std::flush;
         }
@@ -3,14 +3,19 @@
 
 #include "shader.h"
 
+#include <filesystem>
 #include <unordered_map>
 #include <string>
+#include <vector>
 
 namespace vox {
     class ShaderManager {
     private:
         std::unordered_map<std::string, Shader<>> shaders = {};
 
+        static std::vector<char> readCode(const std::filesystem::path& path);
+        static ShaderMetadata readMetadata(const std::filesystem::path& path);
+
     public:
         ShaderManager() = default;
 
@@ -33,6 +38,13 @@ namespace vox {
         void remove(const std::string &name);
 
         void loadAll();
+
+        // Reads a shader's metadata and code again, without touching the loaded one.
+        // Safe to call from worker threads.
+        [[nodiscard]] static Shader<> load(const std::string& id);
+
+        // Ids of the loaded shaders built from a file in shaders/spirv or shaders/metadata.
+        [[nodiscard]] std::vector<std::string> getDependents(const std::filesystem::path& file) const;
     };
 }
 
@@ -0,0 +1,741 @@
+#include "shader_reflection.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+    constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+
+    // Words before the first instruction: magic, version, generator, bound, schema.
+    constexpr size_t SPIRV_HEADER_SIZE = 5;
+
+    // Opcodes, decorations and enumerants used below, from the SPIR-V specification.
+    enum Op : uint32_t {
+        OpName = 5,
+        OpMemberName = 6,
+        OpEntryPoint = 15,
+        OpTypeBool = 20,
+        OpTypeInt = 21,
+        OpTypeFloat = 22,
+        OpTypeVector = 23,
+        OpTypeMatrix = 24,
+        OpTypeImage = 25,
+        OpTypeSampler = 26,
+        OpTypeSampledImage = 27,
+        OpTypeArray = 28,
+        OpTypeRuntimeArray = 29,
+        OpTypeStruct = 30,
+        OpTypePointer = 32,
+        OpConstant = 43,
+        OpSpecConstantTrue = 48,
+        OpSpecConstantFalse = 49,
+        OpSpecConstant = 50,
+        OpVariable = 59,
+        OpDecorate = 71,
+        OpMemberDecorate = 72
+    };
+
+    enum Decoration : uint32_t {
+        SpecId = 1,
+        Block = 2,
+        BufferBlock = 3,
+        RowMajor = 4,
+        ArrayStride = 6,
+        MatrixStride = 7,
+        BuiltIn = 11,
+        Location = 30,
+        Binding = 33,
+        DescriptorSet = 34,
+        Offset = 35
+    };
+
+    enum StorageClass : uint32_t {
+        UniformConstant = 0,
+        Input = 1,
+        Uniform = 2,
+        PushConstant = 9,
+        StorageBuffer = 12
+    };
+
+    enum Dim : uint32_t {
+        DimBuffer = 5,
+        DimSubpassData = 6
+    };
+
+    // Image operand telling storage images (2) from sampled ones (1).
+    constexpr uint32_t IMAGE_SAMPLED_STORAGE = 2;
+
+    struct Decorations {
+        std::optional<uint32_t> binding = std::nullopt;
+        std::optional<uint32_t> set = std::nullopt;
+        std::optional<uint32_t> location = std::nullopt;
+        std::optional<uint32_t> offset = std::nullopt;
+        std::optional<uint32_t> arrayStride = std::nullopt;
+        std::optional<uint32_t> matrixStride = std::nullopt;
+        std::optional<uint32_t> specId = std::nullopt;
+
+        bool builtIn = false;
+        bool block = false;
+        bool bufferBlock = false;
+        bool rowMajor = false;
+    };
+
+    struct Variable {
+        uint32_t id;
+        uint32_t pointerType;
+        uint32_t storageClass;
+    };
+
+    struct SpecConstant {
+        uint32_t id;
+        uint32_t type;
+    };
+
+    struct Module {
+        std::unordered_map<uint32_t, std::string> names = {};
+        std::unordered_map<uint64_t, std::string> memberNames = {};
+
+        std::unordered_map<uint32_t, Decorations> decorations = {};
+        std::unordered_map<uint64_t, Decorations> memberDecorations = {};
+
+        // Opcode, followed by the operands after the result id.
+        std::unordered_map<uint32_t, std::vector<uint32_t>> types = {};
+
+        std::unordered_map<uint32_t, uint32_t> constants = {};
+
+        std::vector<Variable> variables = {};
+        std::vector<SpecConstant> specConstants = {};
+
+        VkShaderStageFlags stage = 0;
+    };
+
+    uint64_t getMemberKey(const uint32_t type, const uint32_t member) {
+        return static_cast<uint64_t>(type) << 32 | member;
+    }
+
+    std::string readString(const std::span<const uint32_t> words) {
+        const auto bytes = reinterpret_cast<const char*>(words.data());
+
+        return { bytes, strnlen(bytes, words.size_bytes()) };
+    }
+
+    void decorate(Decorations& decorations, const uint32_t decoration, const std::span<const uint32_t> literals) {
+        const auto literal = literals.empty() ? std::nullopt : std::optional(literals[0]);
+
+        switch (decoration) {
+            case Block: decorations.block = true; break;
+            case BufferBlock: decorations.bufferBlock = true; break;
+            case RowMajor: decorations.rowMajor = true; break;
+            case ArrayStride: decorations.arrayStride = literal; break;
+            case MatrixStride: decorations.matrixStride = literal; break;
+            case BuiltIn: decorations.builtIn = true; break;
+            case Location: decorations.location = literal; break;
+            case Binding: decorations.binding = literal; break;
+            case DescriptorSet: decorations.set = literal; break;
+            case Offset: decorations.offset = literal; break;
+            case SpecId: decorations.specId = literal; break;
+            default: break;
+        }
+    }
+
+    // Words an instruction needs, opcode included, for every operand read below to exist.
+    uint32_t getMinimumWordCount(const uint32_t opcode) {
+        switch (opcode) {
+            case OpTypeBool:
+            case OpTypeSampler:
+            case OpTypeStruct:
+                return 2;
+            case OpName:
+            case OpTypeFloat:
+            case OpTypeSampledImage:
+            case OpTypeRuntimeArray:
+            case OpSpecConstantTrue:
+            case OpSpecConstantFalse:
+            case OpDecorate:
+                return 3;
+            case OpMemberName:
+            case OpEntryPoint:
+            case OpTypeInt:
+            case OpTypeVector:
+            case OpTypeMatrix:
+            case OpTypeArray:
+            case OpTypePointer:
+            case OpConstant:
+            case OpSpecConstant:
+            case OpVariable:
+            case OpMemberDecorate:
+                return 4;
+            case OpTypeImage:
+                return 9;
+            default:
+                return 1;
+        }
+    }
+
+    VkShaderStageFlags getStage(const uint32_t executionModel) {
+        switch (executionModel) {
+            case 0: return VK_SHADER_STAGE_VERTEX_BIT;
+            case 1: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+            case 2: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+            case 3: return VK_SHADER_STAGE_GEOMETRY_BIT;
+            case 4: return VK_SHADER_STAGE_FRAGMENT_BIT;
+            case 5: return VK_SHADER_STAGE_COMPUTE_BIT;
+            default: throw std::runtime_error("[Shader] Unsupported SPIR-V execution model: " + std::to_string(executionModel));
+        }
+    }
+
+    Module parseModule(const std::span<const char> code) {
+        if (code.size() % sizeof(uint32_t) != 0 || code.size() < SPIRV_HEADER_SIZE * sizeof(uint32_t)) {
+            throw std::runtime_error("[Shader] Invalid SPIR-V: size is not a whole number of words!");
+        }
+
+        // Shader code is read as bytes, which need not be aligned for words.
+        std::vector<uint32_t> words(code.size() / sizeof(uint32_t));
+        memcpy(words.data(), code.data(), code.size());
+
+        if (words[0] != SPIRV_MAGIC) {
+            throw std::runtime_error("[Shader] Invalid SPIR-V: bad magic number!");
+        }
+
+        Module module = {};
+
+        for (size_t i = SPIRV_HEADER_SIZE; i < words.size();) {
+            const auto wordCount = words[i] >> 16;
+            const auto opcode = words[i] & 0xFFFF;
+
+            if (wordCount == 0 || i + wordCount > words.size()) {
+                throw std::runtime_error("[Shader] Invalid SPIR-V: truncated instruction at word " + std::to_string(i) + "!");
+            }
+
+            if (wordCount < getMinimumWordCount(opcode)) {
+                throw std::runtime_error("[Shader] Invalid SPIR-V: opcode " + std::to_string(opcode) + " at word " + std::to_string(i) + " has " + std::to_string(wordCount) + " word(s), expected at least " + std::to_string(getMinimumWordCount(opcode)) + "!");
+            }
+
+            const auto operands = std::span<const uint32_t>(words).subspan(i + 1, wordCount - 1);
+
+            switch (opcode) {
+                case OpName:
+                    module.names[operands[0]] = readString(operands.subspan(1));
+                    break;
+                case OpMemberName:
+                    module.memberNames[getMemberKey(operands[0], operands[1])] = readString(operands.subspan(2));
+                    break;
+                case OpEntryPoint:
+                    // Modules with several entry points are reflected as their first one.
+                    if (module.stage == 0) {
+                        module.stage = getStage(operands[0]);
+                    }
+                    break;
+                case OpTypeBool:
+                case OpTypeInt:
+                case OpTypeFloat:
+                case OpTypeVector:
+                case OpTypeMatrix:
+                case OpTypeImage:
+                case OpTypeSampler:
+                case OpTypeSampledImage:
+                case OpTypeArray:
+                case OpTypeRuntimeArray:
+                case OpTypeStruct:
+                case OpTypePointer: {
+                    auto& type = module.types[operands[0]];
+                    type.push_back(opcode);
+                    type.insert(type.end(), operands.begin() + 1, operands.end());
+                    break;
+                }
+                case OpConstant:
+                    module.constants[operands[1]] = operands[2];
+                    break;
+                case OpSpecConstantTrue:
+                case OpSpecConstantFalse:
+                case OpSpecConstant:
+                    module.specConstants.push_back({ operands[1], operands[0] });
+                    break;
+                case OpVariable:
+                    module.variables.push_back({ operands[1], operands[0], operands[2] });
+                    break;
+                case OpDecorate:
+                    decorate(module.decorations[operands[0]], operands[1], operands.subspan(2));
+                    break;
+                case OpMemberDecorate:
+                    decorate(module.memberDecorations[getMemberKey(operands[0], operands[1])], operands[2], operands.subspan(3));
+                    break;
+                default:
+                    break;
+            }
+
+            i += wordCount;
+        }
+
+        if (module.stage == 0) {
+            throw std::runtime_error("[Shader] Invalid SPIR-V: no entry point!");
+        }
+
+        return module;
+    }
+
+    const std::vector<uint32_t>& getType(const Module& module, const uint32_t id) {
+        if (const auto type = module.types.find(id); type != module.types.end()) {
+            return type->second;
+        }
+
+        throw std::runtime_error("[Shader] Invalid SPIR-V: unknown type %" + std::to_string(id) + "!");
+    }
+
+    std::string getName(const Module& module, const uint32_t id) {
+        const auto name = module.names.find(id);
+
+        return name != module.names.end() ? name->second : std::string();
+    }
+
+    const Decorations& getDecorations(const Module& module, const uint32_t id) {
+        static const Decorations none = {};
+
+        const auto decorations = module.decorations.find(id);
+
+        return decorations != module.decorations.end() ? decorations->second : none;
+    }
+
+    const Decorations& getMemberDecorations(const Module& module, const uint32_t type, const uint32_t member) {
+        static const Decorations none = {};
+
+        const auto decorations = module.memberDecorations.find(getMemberKey(type, member));
+
+        return decorations != module.memberDecorations.end() ? decorations->second : none;
+    }
+
+    uint32_t getConstant(const Module& module, const uint32_t id) {
+        if (const auto constant = module.constants.find(id); constant != module.constants.end()) {
+            return constant->second;
+        }
+
+        throw std::runtime_error("[Shader] Unsupported SPIR-V: array length %" + std::to_string(id) + " is not a plain constant!");
+    }
+
+    // Size in bytes as laid out in a block, using the strides the compiler decorated it with.
+    uint32_t getSize(const Module& module, const uint32_t id, const Decorations& memberDecorations) {
+        const auto& type = getType(module, id);
+
+        switch (type[0]) {
+            case OpTypeBool:
+                return 4;
+            case OpTypeInt:
+            case OpTypeFloat:
+                return type[1] / 8;
+            case OpTypeVector:
+                return type[2] * getSize(module, type[1], {});
+            case OpTypeMatrix: {
+                if (!memberDecorations.matrixStride.has_value()) {
+                    return type[2] * getSize(module, type[1], {});
+                }
+
+                // Row-major matrices are strided by row, i.e. by the components of a column.
+                const auto vectorCount = memberDecorations.rowMajor ? getType(module, type[1])[2] : type[2];
+
+                return vectorCount * memberDecorations.matrixStride.value();
+            }
+            case OpTypeArray: {
+                const auto length = getConstant(module, type[2]);
+
+                if (const auto stride = getDecorations(module, id).arrayStride; stride.has_value()) {
+                    return length * stride.value();
+                }
+
+                return length * getSize(module, type[1], memberDecorations);
+            }
+            case OpTypeStruct: {
+                uint32_t size = 0;
+
+                for (uint32_t member = 0; member + 1 < type.size(); ++member) {
+                    const auto& decorations = getMemberDecorations(module, id, member);
+
+                    size = std::max(size, decorations.offset.value_or(size) + getSize(module, type[member + 1], decorations));
+                }
+
+                return size;
+            }
+            default:
+                return 0;
+        }
+    }
+
+    // The GLM type of a scalar, vector or matrix type.
+    std::optional<vox::GLMType> getGLMType(const Module& module, const uint32_t id) {
+        const auto* type = &getType(module, id);
+
+        uint32_t rows = 1;
+        uint32_t columns = 1;
+
+        if ((*type)[0] == OpTypeMatrix) {
+            columns = (*type)[2];
+            type = &getType(module, (*type)[1]);
+        }
+
+        if ((*type)[0] == OpTypeVector) {
+            rows = (*type)[2];
+            type = &getType(module, (*type)[1]);
+        }
+
+        const auto& component = *type;
+
+        switch (component[0]) {
+            case OpTypeBool:
+                return vox::findGLMType(vox::GLMComponent::Bool, rows, columns);
+            case OpTypeFloat:
+                if (component[1] == 32) return vox::findGLMType(vox::GLMComponent::Float, rows, columns);
+                if (component[1] == 64) return vox::findGLMType(vox::GLMComponent::Double, rows, columns);
+                return std::nullopt;
+            case OpTypeInt:
+                if (component[1] != 32) return std::nullopt;
+                return vox::findGLMType(component[2] ? vox::GLMComponent::Int : vox::GLMComponent::Uint, rows, columns);
+            default:
+                return std::nullopt;
+        }
+    }
+
+    std::vector<vox::ShaderReflectionMember> getMembers(const Module& module, const uint32_t id) {
+        const auto& type = getType(module, id);
+
+        std::vector<vox::ShaderReflectionMember> members;
+
+        for (uint32_t member = 0; member + 1 < type.size(); ++member) {
+            const auto& decorations = getMemberDecorations(module, id, member);
+
+            const auto name = module.memberNames.find(getMemberKey(id, member));
+
+            members.push_back({
+                name != module.memberNames.end() ? name->second : std::string(),
+                decorations.offset.value_or(0),
+                getSize(module, type[member + 1], decorations),
+                getGLMType(module, type[member + 1])
+            });
+        }
+
+        return members;
+    }
+
+    std::optional<VkDescriptorType> getImageDescriptorType(const std::vector<uint32_t>& image, const bool sampled) {
+        const auto dim = image[2];
+        const auto storage = image[6] == IMAGE_SAMPLED_STORAGE;
+
+        if (dim == DimSubpassData) {
+            return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        }
+
+        if (dim == DimBuffer) {
+            return storage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+        }
+
+        if (sampled) {
+            return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        }
+
+        return storage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    }
+
+    VkFormat getFormat(const Module& module, const uint32_t id) {
+        const auto type = getGLMType(module, id);
+
+        return type.has_value() ? vox::getGLMTypeInfo(type.value()).format : VK_FORMAT_UNDEFINED;
+    }
+
+    void addBinding(const Module& module, const Variable& variable, vox::ShaderReflection& reflection) {
+        const auto& decorations = getDecorations(module, variable.id);
+
+        if (!decorations.binding.has_value()) {
+            return;
+        }
+
+        auto typeId = getType(module, variable.pointerType)[2];
+        uint32_t count = 1;
+
+        // Arrays of resources become one binding with several descriptors.
+        for (auto type = &getType(module, typeId); (*type)[0] == OpTypeArray || (*type)[0] == OpTypeRuntimeArray; type = &getType(module, typeId)) {
+            count = (*type)[0] == OpTypeArray ? count * getConstant(module, (*type)[2]) : 0;
+            typeId = (*type)[1];
+        }
+
+        const auto& type = getType(module, typeId);
+
+        vox::ShaderReflectionBinding binding = {
+            .name = getName(module, variable.id),
+            .set = decorations.set.value_or(0),
+            .binding = decorations.binding.value(),
+            .type = VK_DESCRIPTOR_TYPE_MAX_ENUM,
+            .count = count,
+            .stages = module.stage,
+            .size = 0,
+            .members = {}
+        };
+
+        std::optional<VkDescriptorType> descriptorType = std::nullopt;
+
+        switch (type[0]) {
+            case OpTypeStruct: {
+                const auto& typeDecorations = getDecorations(module, typeId);
+
+                if (variable.storageClass == StorageBuffer || typeDecorations.bufferBlock) {
+                    descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                } else if (typeDecorations.block) {
+                    descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                }
+
+                binding.name = getName(module, typeId);
+                binding.size = getSize(module, typeId, {});
+                binding.members = getMembers(module, typeId);
+                break;
+            }
+            case OpTypeSampledImage:
+                descriptorType = getImageDescriptorType(getType(module, type[1]), true);
+                break;
+            case OpTypeImage:
+                descriptorType = getImageDescriptorType(type, false);
+                break;
+            case OpTypeSampler:
+                descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+                break;
+            default:
+                break;
+        }
+
+        if (!descriptorType.has_value()) {
+            throw std::runtime_error("[Shader] Unsupported SPIR-V: binding " + std::to_string(binding.binding) + " ('" + binding.name + "') has no known descriptor type!");
+        }
+
+        binding.type = descriptorType.value();
+
+        reflection.bindings.push_back(std::move(binding));
+    }
+
+    void addPushConstantRange(const Module& module, const Variable& variable, vox::ShaderReflection& reflection) {
+        const auto typeId = getType(module, variable.pointerType)[2];
+        const auto members = getMembers(module, typeId);
+
+        if (members.empty()) {
+            return;
+        }
+
+        const auto offset = std::ranges::min(members, {}, &vox::ShaderReflectionMember::offset).offset;
+
+        reflection.pushConstantRanges.push_back({
+            .stageFlags = module.stage,
+            .offset = offset,
+            .size = getSize(module, typeId, {}) - offset
+        });
+
+        reflection.pushConstants.insert(reflection.pushConstants.end(), members.begin(), members.end());
+    }
+
+    void addInput(const Module& module, const Variable& variable, vox::ShaderReflection& reflection) {
+        const auto& decorations = getDecorations(module, variable.id);
+
+        if (decorations.builtIn || !decorations.location.has_value()) {
+            return;
+        }
+
+        reflection.inputs.push_back({
+            getName(module, variable.id),
+            decorations.location.value(),
+            getFormat(module, getType(module, variable.pointerType)[2])
+        });
+    }
+
+    void addSpecialization(const Module& module, const SpecConstant& constant, vox::ShaderReflection& reflection) {
+        const auto& decorations = getDecorations(module, constant.id);
+
+        // Constants derived from others (OpSpecConstantOp) have no id of their own.
+        if (!decorations.specId.has_value()) {
+            return;
+        }
+
+        reflection.specializations.push_back({
+            getName(module, constant.id),
+            decorations.specId.value(),
+            getGLMType(module, constant.type)
+        });
+    }
+
+    void sort(vox::ShaderReflection& reflection) {
+        std::ranges::sort(reflection.bindings, {}, [](const auto& binding) { return std::pair(binding.set, binding.binding); });
+        std::ranges::sort(reflection.inputs, {}, &vox::ShaderReflectionInput::location);
+        std::ranges::sort(reflection.pushConstants, {}, &vox::ShaderReflectionMember::offset);
+        std::ranges::sort(reflection.specializations, {}, &vox::ShaderReflectionSpecialization::id);
+    }
+}
+
+vox::ShaderReflection vox::ShaderReflection::parse(const std::span<const char> code) {
+    const auto module = parseModule(code);
+
+    ShaderReflection reflection = {};
+    reflection.stages = module.stage;
+
+    for (const auto& variable : module.variables) {
+        switch (variable.storageClass) {
+            case UniformConstant:
+            case Uniform:
+            case StorageBuffer:
+                addBinding(module, variable, reflection);
+                break;
+            case PushConstant:
+                addPushConstantRange(module, variable, reflection);
+                break;
+            case Input:
+                // Only the inputs of the vertex stage are fed by vertex attributes.
+                if (module.stage == VK_SHADER_STAGE_VERTEX_BIT) {
+                    addInput(module, variable, reflection);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    for (const auto& constant : module.specConstants) {
+        addSpecialization(module, constant, reflection);
+    }
+
+    sort(reflection);
+
+    return reflection;
+}
+
+void vox::ShaderReflection::merge(const ShaderReflection& other) {
+    stages |= other.stages;
+
+    for (const auto& otherBinding : other.bindings) {
+        const auto binding = std::ranges::find_if(bindings, [&](const auto& b) {
+            return b.set == otherBinding.set && b.binding == otherBinding.binding;
+        });
+
+        if (binding == bindings.end()) {
+            bindings.push_back(otherBinding);
+            continue;
+        }
+
+        if (binding->type != otherBinding.type || binding->count != otherBinding.count || binding->size != otherBinding.size) {
+            throw std::runtime_error("[Shader] Set " + std::to_string(binding->set) + ", binding " + std::to_string(binding->binding) + " is declared differently by two stages!");
+        }
+
+        binding->stages |= otherBinding.stages;
+    }
+
+    for (const auto& otherRange : other.pushConstantRanges) {
+        const auto range = std::ranges::find_if(pushConstantRanges, [&](const auto& r) {
+            return r.offset == otherRange.offset && r.size == otherRange.size;
+        });
+
+        if (range != pushConstantRanges.end()) {
+            range->stageFlags |= otherRange.stageFlags;
+        } else {
+            pushConstantRanges.push_back(otherRange);
+        }
+    }
+
+    // Stages usually share one push constant block, so its members are only added once.
+    for (const auto& otherMember : other.pushConstants) {
+        const auto member = std::ranges::find(pushConstants, otherMember.name, &ShaderReflectionMember::name);
+
+        if (member == pushConstants.end()) {
+            pushConstants.push_back(otherMember);
+        } else if (*member != otherMember) {
+            throw std::runtime_error("[Shader] Push constant '" + member->name + "' is declared differently by two stages!");
+        }
+    }
+
+    for (const auto& otherSpecialization : other.specializations) {
+        const auto specialization = std::ranges::find(specializations, otherSpecialization.id, &ShaderReflectionSpecialization::id);
+
+        if (specialization == specializations.end()) {
+            specializations.push_back(otherSpecialization);
+        } else if (specialization->type != otherSpecialization.type) {
+            throw std::runtime_error("[Shader] Specialization constant " + std::to_string(specialization->id) + " is declared with different types by two stages!");
+        }
+    }
+
+    inputs.insert(inputs.end(), other.inputs.begin(), other.inputs.end());
+
+    sort(*this);
+}
+
+const vox::ShaderReflectionMember* vox::ShaderReflectionBinding::findMember(const std::string& name) const {
+    const auto found = std::ranges::find(members, name, &ShaderReflectionMember::name);
+
+    return found != members.end() ? &*found : nullptr;
+}
+
+const vox::ShaderReflectionBinding* vox::ShaderReflection::findBinding(const uint32_t set, const uint32_t binding) const {
+    const auto found = std::ranges::find_if(bindings, [&](const auto& b) {
+        return b.set == set && b.binding == binding;
+    });
+
+    return found != bindings.end() ? &*found : nullptr;
+}
+
+const vox::ShaderReflectionMember* vox::ShaderReflection::findPushConstant(const std::string& name) const {
+    const auto found = std::ranges::find(pushConstants, name, &ShaderReflectionMember::name);
+
+    return found != pushConstants.end() ? &*found : nullptr;
+}
+
+const vox::ShaderReflectionSpecialization* vox::ShaderReflection::findSpecialization(const uint32_t id) const {
+    const auto found = std::ranges::find(specializations, id, &ShaderReflectionSpecialization::id);
+
+    return found != specializations.end() ? &*found : nullptr;
+}
+
+std::vector<VkPushConstantRange> vox::ShaderReflection::getPushConstantUpdates() const {
+    std::vector<uint32_t> boundaries;
+
+    for (const auto& range : pushConstantRanges) {
+        boundaries.push_back(range.offset);
+        boundaries.push_back(range.offset + range.size);
+    }
+
+    std::ranges::sort(boundaries);
+    boundaries.erase(std::ranges::unique(boundaries).begin(), boundaries.end());
+
+    std::vector<VkPushConstantRange> updates;
+
+    for (size_t i = 1; i < boundaries.size(); ++i) {
+        VkShaderStageFlags stages = 0;
+
+        for (const auto& range : pushConstantRanges) {
+            if (range.offset <= boundaries[i - 1] && boundaries[i] <= range.offset + range.size) {
+                stages |= range.stageFlags;
+            }
+        }
+
+        if (stages == 0) continue;
+
+        // Neighbouring pieces used by the same stages are pushed together.
+        if (!updates.empty() && updates.back().stageFlags == stages && updates.back().offset + updates.back().size == boundaries[i - 1]) {
+            updates.back().size += boundaries[i] - boundaries[i - 1];
+        } else {
+            updates.push_back({ stages, boundaries[i - 1], boundaries[i] - boundaries[i - 1] });
+        }
+    }
+
+    return updates;
+}
+
+const vox::ShaderReflectionBinding* vox::ShaderReflection::findBlock(const std::string& name) const {
+    const auto found = std::ranges::find_if(bindings, [&](const auto& b) {
+        return !b.members.empty() && b.name == name;
+    });
+
+    return found != bindings.end() ? &*found : nullptr;
+}
+
+bool vox::ShaderReflection::isLayoutCompatible(const ShaderReflection& other) const {
+    if (bindings != other.bindings || pushConstants != other.pushConstants || pushConstantRanges.size() != other.pushConstantRanges.size()) {
+        return false;
+    }
+
+    return std::ranges::equal(pushConstantRanges, other.pushConstantRanges, [](const auto& a, const auto& b) {
+        return a.stageFlags == b.stageFlags && a.offset == b.offset && a.size == b.size;
+    });
+}
@@ -0,0 +1,119 @@
+#ifndef VOX_SHADER_REFLECTION_H
+#define VOX_SHADER_REFLECTION_H
+
+/**
+ * SPIR-V reflection, of what a shader declares.
+ *
+ * Reads the descriptor bindings, push constant blocks and vertex inputs
+ * straight out of a SPIR-V module, with the member offsets the compiler
+ * laid out (std140 for uniform blocks), so that descriptor set layouts
+ * and uniform buffers always match the code they are used with.
+ *
+ * Only the subset of SPIR-V needed for that is parsed: names, decorations,
+ * types, constants, specialization constants, variables and the entry point.
+ */
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan_core.h>
+
+#include "../misc/glm_type.h"
+
+namespace vox {
+    struct ShaderReflectionMember {
+        std::string name;
+
+        uint32_t offset;
+        uint32_t size;
+
+        // Empty for structs, arrays and types without a GLM counterpart.
+        std::optional<GLMType> type;
+
+        bool operator==(const ShaderReflectionMember& other) const = default;
+    };
+
+    struct ShaderReflectionBinding {
+        // Type name for blocks (e.g. "Extras"), variable name otherwise.
+        std::string name;
+
+        uint32_t set;
+        uint32_t binding;
+
+        VkDescriptorType type;
+
+        // Number of descriptors, 0 for runtime arrays.
+        uint32_t count;
+
+        VkShaderStageFlags stages;
+
+        // Size and members of buffer blocks; 0 and empty otherwise.
+        uint32_t size;
+        std::vector<ShaderReflectionMember> members;
+
+        [[nodiscard]] const ShaderReflectionMember* findMember(const std::string& name) const;
+
+        bool operator==(const ShaderReflectionBinding& other) const = default;
+    };
+
+    struct ShaderReflectionInput {
+        std::string name;
+
+        uint32_t location;
+
+        // VK_FORMAT_UNDEFINED for inputs that are not scalars or vectors.
+        VkFormat format;
+    };
+
+    struct ShaderReflectionSpecialization {
+        std::string name;
+
+        // The constant_id it is specialized by.
+        uint32_t id;
+
+        std::optional<GLMType> type;
+    };
+
+    struct ShaderReflection {
+        VkShaderStageFlags stages = 0;
+
+        std::vector<ShaderReflectionBinding> bindings = {};
+        std::vector<VkPushConstantRange> pushConstantRanges = {};
+
+        // Members of the push constant blocks of every stage, by offset.
+        std::vector<ShaderReflectionMember> pushConstants = {};
+
+        // Specialization constants of every stage, by id.
+        std::vector<ShaderReflectionSpecialization> specializations = {};
+
+        // Inputs of the vertex stage, i.e. the vertex attributes it consumes.
+        std::vector<ShaderReflectionInput> inputs = {};
+
+        [[nodiscard]] static ShaderReflection parse(std::span<const char> code);
+
+        // Combines the reflection of another stage of the same pipeline.
+        void merge(const ShaderReflection& other);
+
+        [[nodiscard]] const ShaderReflectionBinding* findBinding(uint32_t set, uint32_t binding) const;
+
+        // Finds a buffer block by its type name.
+        [[nodiscard]] const ShaderReflectionBinding* findBlock(const std::string& name) const;
+
+        [[nodiscard]] const ShaderReflectionMember* findPushConstant(const std::string& name) const;
+
+        [[nodiscard]] const ShaderReflectionSpecialization* findSpecialization(uint32_t id) const;
+
+        // Splits the push constant ranges into the pieces vkCmdPushConstants is called with:
+        // each one covers bytes used by exactly the same stages, and names all of them.
+        [[nodiscard]] std::vector<VkPushConstantRange> getPushConstantUpdates() const;
+
+        // Whether a pipeline of the other reflection can use the descriptor sets, uniform
+        // buffers and push constants laid out for this one.
+        [[nodiscard]] bool isLayoutCompatible(const ShaderReflection& other) const;
+    };
+}
+
+#endif
@@ -0,0 +1,52 @@
+#include "shader_watcher.h"
+
+vox::ShaderWatcher::ShaderWatcher(std::vector<std::filesystem::path> directories, const std::chrono::milliseconds interval)
+        : directories(std::move(directories)),
+          interval(interval),
+          lastPoll(std::chrono::steady_clock::now()) {
+    scan([&](const std::filesystem::path& path, const std::filesystem::file_time_type writeTime) {
+        writeTimes[path.string()] = writeTime;
+    });
+}
+
+void vox::ShaderWatcher::scan(const std::function<void(const std::filesystem::path&, std::filesystem::file_time_type)>& function) const {
+    for (const auto& directory : directories) {
+        // Directories may be missing, or files removed while iterating; neither is an error here.
+        std::error_code error;
+
+        for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+            if (!entry.is_regular_file(error)) continue;
+
+            const auto writeTime = entry.last_write_time(error);
+
+            if (!error) {
+                function(entry.path(), writeTime);
+            }
+        }
+    }
+}
+
+std::vector<std::filesystem::path> vox::ShaderWatcher::poll() {
+    const auto now = std::chrono::steady_clock::now();
+
+    if (now - lastPoll < interval) {
+        return {};
+    }
+
+    lastPoll = now;
+
+    std::vector<std::filesystem::path> changedFiles;
+
+    scan([&](const std::filesystem::path& path, const std::filesystem::file_time_type writeTime) {
+        const auto key = path.string();
+
+        if (const auto knownTime = writeTimes.find(key); knownTime == writeTimes.end() || knownTime->second != writeTime) {
+            writeTimes[key] = writeTime;
+            settlingFiles.insert(key);
+        } else if (settlingFiles.erase(key) != 0) {
+            changedFiles.push_back(path);
+        }
+    });
+
+    return changedFiles;
+}
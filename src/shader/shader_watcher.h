@@ -0,0 +1,57 @@
+#ifndef VOX_SHADER_WATCHER_H
+#define VOX_SHADER_WATCHER_H
+
+/**
+ * Shader file watcher, by polling modification times.
+ *
+ * Compilers write their output in several steps, so a file is only
+ * reported once its modification time stayed the same for a whole
+ * interval; files present when the watcher is created are not reported.
+ *
+ * Polling a handful of files a few times per second is cheap enough to
+ * be done on the main thread, and needs no platform-specific API.
+ */
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace vox {
+    class ShaderWatcher {
+        std::vector<std::filesystem::path> directories;
+
+        std::chrono::milliseconds interval;
+
+        std::chrono::steady_clock::time_point lastPoll;
+
+        std::unordered_map<std::string, std::filesystem::file_time_type> writeTimes = {};
+
+        // Files seen changing during the last poll, reported once they stop.
+        std::unordered_set<std::string> settlingFiles = {};
+
+        void scan(const std::function<void(const std::filesystem::path&, std::filesystem::file_time_type)>& function) const;
+
+    public:
+        ShaderWatcher(std::vector<std::filesystem::path> directories, std::chrono::milliseconds interval);
+
+        ShaderWatcher(const ShaderWatcher& other) = delete;
+
+        ShaderWatcher(ShaderWatcher&& other) noexcept = delete;
+
+        ShaderWatcher& operator=(const ShaderWatcher& other) = delete;
+
+        ShaderWatcher& operator=(ShaderWatcher&& other) = delete;
+
+        ~ShaderWatcher() = default;
+
+        // Returns the files that were written to and have since settled,
+        // scanning at most once per interval.
+        [[nodiscard]] std::vector<std::filesystem::path> poll();
+    };
+}
+
+#endif
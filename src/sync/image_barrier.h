@@ -0,0 +1,36 @@
+#ifndef VOX_IMAGE_BARRIER_H
+#define VOX_IMAGE_BARRIER_H
+
+/**
+ * Image states, and the barriers between them.
+ *
+ * An image state is a layout, along with the stages and accesses an image
+ * in that layout is used by. Barriers are derived from the state an image
+ * leaves and the one it enters, rather than written out per transition:
+ * only writes are made available, and an image read in the same layout
+ * twice needs no barrier at all.
+ */
+
+#include <vulkan/vulkan_core.h>
+
+namespace vox {
+    struct ImageState {
+        VkImageLayout layout;
+        VkPipelineStageFlags stage;
+        VkAccessFlags access;
+    };
+
+    // State of an image used in a layout, by the stages that typically use it so.
+    [[nodiscard]] ImageState getImageState(VkImageLayout layout);
+
+    [[nodiscard]] VkAccessFlags getWriteAccess(VkAccessFlags access);
+
+    // Whether moving from one state to the other needs a barrier: a layout change, or any write.
+    [[nodiscard]] bool needsImageBarrier(const ImageState& from, const ImageState& to);
+
+    [[nodiscard]] VkImageMemoryBarrier buildImageBarrier(VkImage image, const VkImageSubresourceRange& range, const ImageState& from, const ImageState& to);
+
+    [[nodiscard]] VkImageAspectFlags getImageAspect(VkFormat format);
+}
+
+#endif
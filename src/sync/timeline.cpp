@@ -0,0 +1,91 @@
+#include "timeline.h"
+
+#include <algorithm>
+#include <utility>
+
+VkResult vox::Timeline::build(const VkDevice& device) {
+    VkSemaphoreTypeCreateInfo typeCreateInfo = {};
+    typeCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeCreateInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    createInfo.pNext = &typeCreateInfo;
+
+    submittedValue = 0;
+    completedValue = 0;
+
+    return vkCreateSemaphore(device, &createInfo, nullptr, &semaphore);
+}
+
+void vox::Timeline::destroy(const VkDevice& device) {
+    for (const auto& [value, function] : deferred) {
+        function();
+    }
+
+    deferred.clear();
+
+    vkDestroySemaphore(device, semaphore, nullptr);
+    semaphore = VK_NULL_HANDLE;
+}
+
+VkSemaphore vox::Timeline::get() const {
+    return semaphore;
+}
+
+uint64_t vox::Timeline::next() {
+    return ++submittedValue;
+}
+
+uint64_t vox::Timeline::getSubmitted() const {
+    return submittedValue;
+}
+
+bool vox::Timeline::isCompleted(const VkDevice& device, const uint64_t value) {
+    if (value <= completedValue) {
+        return true;
+    }
+
+    uint64_t currentValue;
+
+    if (VK_SUCCESS == vkGetSemaphoreCounterValue(device, semaphore, &currentValue)) {
+        completedValue = std::max(completedValue, currentValue);
+    }
+
+    return value <= completedValue;
+}
+
+VkResult vox::Timeline::wait(const VkDevice& device, const uint64_t value) {
+    if (value <= completedValue) {
+        return VK_SUCCESS;
+    }
+
+    VkSemaphoreWaitInfo waitInfo = {};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &semaphore;
+    waitInfo.pValues = &value;
+
+    const auto result = vkWaitSemaphores(device, &waitInfo, UINT64_MAX);
+
+    if (result == VK_SUCCESS) {
+        completedValue = std::max(completedValue, value);
+    }
+
+    return result;
+}
+
+void vox::Timeline::defer(std::function<void()> destroy) {
+    deferred.push_back({ submittedValue, std::move(destroy) });
+}
+
+void vox::Timeline::collect(const VkDevice& device) {
+    while (!deferred.empty() && isCompleted(device, deferred.front().value)) {
+        // Popped first, so that a throwing destroy is not run again.
+        const auto function = std::move(deferred.front().destroy);
+        deferred.pop_front();
+
+        function();
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef VOX_TIMELINE_H
+#define VOX_TIMELINE_H
+
+/**
+ * Timeline semaphore of one queue, with the destruction deferred behind it.
+ *
+ * Every submission to the queue signals the next value of the timeline, so
+ * "has submission N finished" is a single counter comparison, and waiting
+ * for one submission never waits for the ones queued after it. Submissions
+ * to other queues can wait on a value of this one, instead of on a fence
+ * the CPU has to relay.
+ *
+ * Objects the GPU may still use are handed to defer, and destroyed by
+ * collect once every submission made until then has finished, instead of
+ * after waiting for the whole queue.
+ *
+ * Values must be handed out in the order their submissions are made, so a
+ * timeline is only used from the thread submitting to its queue.
+ */
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+#include <vulkan/vulkan_core.h>
+
+namespace vox {
+    class Timeline {
+        struct Deferred {
+            uint64_t value;
+            std::function<void()> destroy;
+        };
+
+        VkSemaphore semaphore = VK_NULL_HANDLE;
+
+        // Last value handed out to a submission.
+        uint64_t submittedValue = 0;
+
+        // Last value the semaphore was seen at, sparing a query for everything below it.
+        uint64_t completedValue = 0;
+
+        // In the order they were deferred, and so by value.
+        std::deque<Deferred> deferred = {};
+
+    public:
+        Timeline() = default;
+
+        Timeline(const Timeline& other) = delete;
+
+        Timeline(Timeline&& other) noexcept = delete;
+
+        Timeline& operator=(const Timeline& other) = delete;
+
+        Timeline& operator=(Timeline&& other) = delete;
+
+        ~Timeline() = default;
+
+        VkResult build(const VkDevice& device);
+
+        // Runs every deferred destruction; the device must be idle.
+        void destroy(const VkDevice& device);
+
+        [[nodiscard]] VkSemaphore get() const;
+
+        // Hands out the value the next submission signals.
+        [[nodiscard]] uint64_t next();
+
+        [[nodiscard]] uint64_t getSubmitted() const;
+
+        // Queries the semaphore, unless the value is already known to be reached.
+        [[nodiscard]] bool isCompleted(const VkDevice& device, uint64_t value);
+
+        VkResult wait(const VkDevice& device, uint64_t value);
+
+        // Runs destroy once every submission made so far has finished.
+        void defer(std::function<void()> destroy);
+
+        // Runs the deferred destructions whose submissions have finished.
+        void collect(const VkDevice& device);
+    };
+}
+
+#endif
@@ -0,0 +1,102 @@
+#include "image_view_cache.h"
+
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+
+#include "../misc/hash.h"
+
+size_t vox::ImageViewKeyHash::operator()(const ImageViewKey& key) const noexcept {
+    return std::hash<Hash128>()(hash128(std::span(reinterpret_cast<const uint8_t*>(key.words.data()), sizeof(key.words))));
+}
+
+uint64_t vox::ImageViewCache::getHandle(VkImage image) {
+    // Non-dispatchable handles are pointers on 64-bit platforms, and 64-bit integers elsewhere.
+    return reinterpret_cast<uint64_t>(image);
+}
+
+vox::ImageViewKey vox::ImageViewCache::getKey(const VkImageViewCreateInfo& createInfo) {
+    const auto handle = getHandle(createInfo.image);
+
+    return {{
+        static_cast<uint32_t>(handle),
+        static_cast<uint32_t>(handle >> 32),
+        createInfo.flags,
+        static_cast<uint32_t>(createInfo.viewType),
+        static_cast<uint32_t>(createInfo.format),
+        static_cast<uint32_t>(createInfo.components.r),
+        static_cast<uint32_t>(createInfo.components.g),
+        static_cast<uint32_t>(createInfo.components.b),
+        static_cast<uint32_t>(createInfo.components.a),
+        createInfo.subresourceRange.aspectMask,
+        createInfo.subresourceRange.baseMipLevel,
+        createInfo.subresourceRange.levelCount,
+        createInfo.subresourceRange.baseArrayLayer,
+        createInfo.subresourceRange.layerCount
+    }};
+}
+
+VkResult vox::ImageViewCache::get(const VkDevice& device, const VkImageViewCreateInfo& createInfo, VkImageView& imageView) {
+    if (createInfo.pNext != nullptr) {
+        throw std::runtime_error("[ImageView] Cached image views cannot have a pNext chain!");
+    }
+
+    const auto key = getKey(createInfo);
+
+    if (const auto cached = imageViews.find(key); cached != imageViews.end()) {
+        imageView = cached->second;
+
+        return VK_SUCCESS;
+    }
+
+    if (const auto result = vkCreateImageView(device, &createInfo, nullptr, &imageView);
+        result != VK_SUCCESS) {
+        return result;
+    }
+
+    imageViews.emplace(key, imageView);
+    imageKeys[getHandle(createInfo.image)].push_back(key);
+
+    return VK_SUCCESS;
+}
+
+std::vector<VkImageView> vox::ImageViewCache::getViews(VkImage image) const {
+    std::vector<VkImageView> views;
+
+    if (const auto keys = imageKeys.find(getHandle(image)); keys != imageKeys.end()) {
+        for (const auto& key : keys->second) {
+            views.push_back(imageViews.at(key));
+        }
+    }
+
+    return views;
+}
+
+void vox::ImageViewCache::release(const VkDevice& device, VkImage image) {
+    const auto keys = imageKeys.find(getHandle(image));
+
+    if (keys == imageKeys.end()) {
+        return;
+    }
+
+    for (const auto& key : keys->second) {
+        vkDestroyImageView(device, imageViews.at(key), nullptr);
+
+        imageViews.erase(key);
+    }
+
+    imageKeys.erase(keys);
+}
+
+void vox::ImageViewCache::destroy(const VkDevice& device) {
+    for (const auto& [key, imageView] : imageViews) {
+        vkDestroyImageView(device, imageView, nullptr);
+    }
+
+    imageViews.clear();
+    imageKeys.clear();
+}
+
+size_t vox::ImageViewCache::getCount() const {
+    return imageViews.size();
+}
@@ -0,0 +1,73 @@
+#ifndef VOX_IMAGE_VIEW_CACHE_H
+#define VOX_IMAGE_VIEW_CACHE_H
+
+/**
+ * Image view cache, keyed by creation parameters.
+ *
+ * Views of the same image, format and subresource range are created once
+ * and shared. The cache owns every view it hands out; before an image is
+ * destroyed, release() must destroy its views, as a later image may be
+ * given the same handle.
+ *
+ * Create infos with a pNext chain are not supported.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan_core.h>
+
+namespace vox {
+    // Every field of a VkImageViewCreateInfo after pNext, the image handle split in two words.
+    struct ImageViewKey {
+        std::array<uint32_t, 14> words;
+
+        bool operator==(const ImageViewKey& other) const = default;
+    };
+
+    struct ImageViewKeyHash {
+        size_t operator()(const ImageViewKey& key) const noexcept;
+    };
+
+    class ImageViewCache {
+        std::unordered_map<ImageViewKey, VkImageView, ImageViewKeyHash> imageViews = {};
+
+        // Keys of the views of every image, for release().
+        std::unordered_map<uint64_t, std::vector<ImageViewKey>> imageKeys = {};
+
+        [[nodiscard]] static uint64_t getHandle(VkImage image);
+
+        [[nodiscard]] static ImageViewKey getKey(const VkImageViewCreateInfo& createInfo);
+
+    public:
+        ImageViewCache() = default;
+
+        ImageViewCache(const ImageViewCache& other) = delete;
+
+        ImageViewCache(ImageViewCache&& other) noexcept = delete;
+
+        ImageViewCache& operator=(const ImageViewCache& other) = delete;
+
+        ImageViewCache& operator=(ImageViewCache&& other) = delete;
+
+        ~ImageViewCache() = default;
+
+        // Returns the view created with the same parameters, creating it on first use.
+        VkResult get(const VkDevice& device, const VkImageViewCreateInfo& createInfo, VkImageView& imageView);
+
+        // Views of an image, e.g. to drop what was written with them before release().
+        [[nodiscard]] std::vector<VkImageView> getViews(VkImage image) const;
+
+        // Destroys every view of an image, which is about to be destroyed.
+        void release(const VkDevice& device, VkImage image);
+
+        void destroy(const VkDevice& device);
+
+        [[nodiscard]] size_t getCount() const;
+    };
+}
+
+#endif
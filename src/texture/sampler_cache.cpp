@@ -0,0 +1,67 @@
+#include "sampler_cache.h"
+
+#include <bit>
+#include <span>
+#include <stdexcept>
+
+#include "../misc/hash.h"
+
+size_t vox::SamplerKeyHash::operator()(const SamplerKey& key) const noexcept {
+    return std::hash<Hash128>()(hash128(std::span(reinterpret_cast<const uint8_t*>(key.words.data()), sizeof(key.words))));
+}
+
+vox::SamplerKey vox::SamplerCache::getKey(const VkSamplerCreateInfo& createInfo) {
+    return {{
+        createInfo.flags,
+        static_cast<uint32_t>(createInfo.magFilter),
+        static_cast<uint32_t>(createInfo.minFilter),
+        static_cast<uint32_t>(createInfo.mipmapMode),
+        static_cast<uint32_t>(createInfo.addressModeU),
+        static_cast<uint32_t>(createInfo.addressModeV),
+        static_cast<uint32_t>(createInfo.addressModeW),
+        std::bit_cast<uint32_t>(createInfo.mipLodBias),
+        createInfo.anisotropyEnable,
+        std::bit_cast<uint32_t>(createInfo.maxAnisotropy),
+        createInfo.compareEnable,
+        static_cast<uint32_t>(createInfo.compareOp),
+        std::bit_cast<uint32_t>(createInfo.minLod),
+        std::bit_cast<uint32_t>(createInfo.maxLod),
+        static_cast<uint32_t>(createInfo.borderColor),
+        createInfo.unnormalizedCoordinates
+    }};
+}
+
+VkResult vox::SamplerCache::get(const VkDevice& device, const VkSamplerCreateInfo& createInfo, VkSampler& sampler) {
+    if (createInfo.pNext != nullptr) {
+        throw std::runtime_error("[Sampler] Cached samplers cannot have a pNext chain!");
+    }
+
+    const auto key = getKey(createInfo);
+
+    if (const auto cached = samplers.find(key); cached != samplers.end()) {
+        sampler = cached->second;
+
+        return VK_SUCCESS;
+    }
+
+    if (const auto result = vkCreateSampler(device, &createInfo, nullptr, &sampler);
+        result != VK_SUCCESS) {
+        return result;
+    }
+
+    samplers.emplace(key, sampler);
+
+    return VK_SUCCESS;
+}
+
+void vox::SamplerCache::destroy(const VkDevice& device) {
+    for (const auto& [key, sampler] : samplers) {
+        vkDestroySampler(device, sampler, nullptr);
+    }
+
+    samplers.clear();
+}
+
+size_t vox::SamplerCache::getCount() const {
+    return samplers.size();
+}
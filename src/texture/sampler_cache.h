@@ -0,0 +1,61 @@
+#ifndef VOX_SAMPLER_CACHE_H
+#define VOX_SAMPLER_CACHE_H
+
+/**
+ * Sampler cache, keyed by creation parameters.
+ *
+ * Samplers are immutable and tiny, but devices only allow a few thousand
+ * of them (maxSamplerAllocationCount), so textures and materials asking for
+ * the same filtering share one object instead of creating their own.
+ *
+ * The cache owns every sampler it hands out; callers never destroy them.
+ * Create infos with a pNext chain are not supported.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include <vulkan/vulkan_core.h>
+
+namespace vox {
+    // Every field of a VkSamplerCreateInfo after pNext, floats by their bits.
+    struct SamplerKey {
+        std::array<uint32_t, 16> words;
+
+        bool operator==(const SamplerKey& other) const = default;
+    };
+
+    struct SamplerKeyHash {
+        size_t operator()(const SamplerKey& key) const noexcept;
+    };
+
+    class SamplerCache {
+        std::unordered_map<SamplerKey, VkSampler, SamplerKeyHash> samplers = {};
+
+        [[nodiscard]] static SamplerKey getKey(const VkSamplerCreateInfo& createInfo);
+
+    public:
+        SamplerCache() = default;
+
+        SamplerCache(const SamplerCache& other) = delete;
+
+        SamplerCache(SamplerCache&& other) noexcept = delete;
+
+        SamplerCache& operator=(const SamplerCache& other) = delete;
+
+        SamplerCache& operator=(SamplerCache&& other) = delete;
+
+        ~SamplerCache() = default;
+
+        // Returns the sampler created with the same parameters, creating it on first use.
+        VkResult get(const VkDevice& device, const VkSamplerCreateInfo& createInfo, VkSampler& sampler);
+
+        void destroy(const VkDevice& device);
+
+        [[nodiscard]] size_t getCount() const;
+    };
+}
+
+#endif
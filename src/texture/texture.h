@@ -8,7 +8,7 @@
 namespace vox {
     class Texture {
         const uint32_t id;
-        uint32_t atlasId;
+        uint32_t atlasId = 0;
 
         const std::string path;
 
@@ -29,11 +29,15 @@ namespace vox {
         }
 
         Texture(const Texture& other)
-                : id(other.id), path(other.path) {
+                : id(other.id), atlasId(other.atlasId), path(other.path),
+                  minU(other.minU), minV(other.minV), maxU(other.maxU), maxV(other.maxV),
+                  width(other.width), height(other.height) {
         }
 
         Texture(Texture&& other) noexcept
-                : id(other.id), path(std::move(other.path)) {
+                : id(other.id), atlasId(other.atlasId), path(std::move(other.path)),
+                  minU(other.minU), minV(other.minV), maxU(other.maxU), maxV(other.maxV),
+                  width(other.width), height(other.height) {
         }
 
         Texture& operator=(const Texture& other) = delete;
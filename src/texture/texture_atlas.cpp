@@ -2,15 +2,70 @@
 // Created by vini2003 on 13/05/2024.
 //
 
-#include <ranges>
+#include <bit>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
 #include "texture_manager.h"
 #include "texture_atlas.h"
-
-#include "stb_image.h"
+#include "texture_packer.h"
+#include "texture_blit.h"
+#include "texture_mipmap.h"
+#include "../misc/thread_pool.h"
 
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "stb_image_write.h"
 
+uint32_t vox::TextureAtlas::getId() const {
+    return id;
+}
+
+uint32_t vox::TextureAtlas::getWidth() const {
+    return width;
+}
+
+uint32_t vox::TextureAtlas::getHeight() const {
+    return height;
+}
+
+uint32_t vox::TextureAtlas::getMipLevels() const {
+    return mipLevels;
+}
+
+float vox::TextureAtlas::getOccupancy() const {
+    return occupancy;
+}
+
+float vox::TextureAtlas::getFragmentation() const {
+    return packer.has_value() ? packer->getFragmentation() : 0.0f;
+}
+
+uint64_t vox::TextureAtlas::getRevision() const {
+    return revision;
+}
+
+const std::vector<uint32_t> &vox::TextureAtlas::getTextureIds() const {
+    return textureIds;
+}
+
+const std::vector<std::pair<uint32_t, vox::TexturePackerRect>> &vox::TextureAtlas::getPlacements() const {
+    return placements;
+}
+
+size_t vox::TextureAtlas::getSize() const {
+    return getLevelOffset(mipLevels);
+}
+
+size_t vox::TextureAtlas::getLevelOffset(const uint32_t level) const {
+    size_t offset = 0;
+
+    for (uint32_t i = 0; i < level; ++i) {
+        offset += static_cast<size_t>(getMipDimension(width, i)) * getMipDimension(height, i) * 4;
+    }
+
+    return offset;
+}
+
 void vox::TextureAtlas::addTexture(uint32_t textureId) {
     textureIds.push_back(textureId);
 }
@@ -19,51 +74,388 @@ void vox::TextureAtlas::removeTexture(uint32_t textureId) {
     textureIds.erase(std::remove(textureIds.begin(), textureIds.end(), textureId), textureIds.end());
 }
 
-// This is a horizontal atlas, for now.
-void vox::TextureAtlas::stitchTextures(TextureManager& textureManager) {
-    int totalWidth = 0;
-    int totalHeight = 0;
+std::vector<uint32_t> vox::TextureAtlas::stitchTextures(TextureManager& textureManager, const uint32_t maxDimension, const uint32_t padding, const uint32_t mipLevels) {
+    this->padding = padding;
+    this->mipLevels = mipLevels;
 
-    const auto textures = textureIds | std::ranges::views::transform([&textureManager](uint32_t textureId) {
-        return textureManager.getTexture(textureId);
-    });
+    const auto alignment = 1u << (mipLevels - 1);
+
+    uint32_t maxCellWidth = 0;
+    uint32_t maxCellHeight = 0;
+
+    uint64_t totalCellArea = 0;
+
+    for (const auto textureId : textureIds) {
+        const auto [textureWidth, textureHeight] = textureManager.getPlacedSize(textureId);
+
+        const auto cellWidth = TexturePacker::getCellSize(textureWidth, padding, alignment);
+        const auto cellHeight = TexturePacker::getCellSize(textureHeight, padding, alignment);
 
-    for (const auto& texture : textures) {
-        int width;
-        int height;
-        int channels;
+        if (cellWidth > maxDimension || cellHeight > maxDimension) {
+            throw std::runtime_error("[Atlas] Texture exceeds maximum atlas dimension: " + textureManager.getTexture(textureId).getPath());
+        }
 
-        stbi_info(texture.getPath().c_str(), &width, &height, &channels);
+        maxCellWidth = std::max(maxCellWidth, cellWidth);
+        maxCellHeight = std::max(maxCellHeight, cellHeight);
 
-        totalWidth = std::max(totalWidth, width);
-        totalHeight = std::max(totalHeight, height);
+        totalCellArea += static_cast<uint64_t>(cellWidth) * cellHeight;
     }
 
-    totalWidth *= textures.size();
+    sortTextureIds(textureManager);
+
+    // Start from the smallest power-of-two page that could hold everything,
+    // and grow it until everything fits or the device limit is reached.
+    width = std::bit_ceil(std::max(maxCellWidth, 1u));
+    height = std::bit_ceil(std::max(maxCellHeight, 1u));
+
+    const auto grow = [this, maxDimension] {
+        if (width <= height && width < maxDimension) {
+            width *= 2;
+        } else if (height < maxDimension) {
+            height *= 2;
+        } else if (width < maxDimension) {
+            width *= 2;
+        } else {
+            return false;
+        }
+
+        return true;
+    };
 
-    std::vector<uint8_t> data(totalWidth * totalHeight * 4);
+    while (static_cast<uint64_t>(width) * height < totalCellArea && grow()) {
+    }
+
+    std::vector<uint32_t> overflowIds;
 
-    int xOffset = 0;
+    while (true) {
+        packer.emplace(width, height, padding, alignment);
 
-    for (const auto& texture : textures) {
-        int width;
-        int height;
-        int channels;
+        placements.clear();
+        overflowIds.clear();
 
-        stbi_uc* image = stbi_load(texture.getPath().c_str(), &width, &height, &channels, 4);
+        for (const auto textureId : textureIds) {
+            const auto [textureWidth, textureHeight] = textureManager.getPlacedSize(textureId);
 
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                for (int c = 0; c < 4; c++) {
-                    data[(y * totalWidth + x + xOffset) * 4 + c] = image[(y * width + x) * 4 + c];
-                }
+            if (const auto rect = packer->insert(textureWidth, textureHeight); rect.has_value()) {
+                placements.emplace_back(textureId, rect.value());
+            } else {
+                overflowIds.push_back(textureId);
             }
         }
 
-        xOffset += width;
+        occupancy = packer->getOccupancy();
+
+        if (overflowIds.empty() || !grow()) {
+            break;
+        }
+    }
+
+    for (const auto textureId : overflowIds) {
+        removeTexture(textureId);
+    }
+
+    // The whole atlas is uploaded after stitching.
+    dirtyTextureIds.clear();
+
+    ++revision;
+
+    applyPlacements(textureManager);
+
+    std::cout << "[Atlas] Stitched atlas " << id << ": " << width << " x " << height << ", " << placements.size() << " textures, " << occupancy * 100.0f << "% filled.\n" << std::flush;
+
+    return overflowIds;
+}
+
+bool vox::TextureAtlas::insertTexture(TextureManager& textureManager, const uint32_t textureId) {
+    if (!packer.has_value()) {
+        throw std::runtime_error("[Atlas] Atlas " + std::to_string(id) + " must be stitched before inserting textures\n");
+    }
+
+    auto& texture = textureManager.getTexture(textureId);
+
+    const auto [textureWidth, textureHeight] = textureManager.getPlacedSize(textureId);
+
+    const auto rect = packer->insert(textureWidth, textureHeight);
+
+    if (!rect.has_value()) {
+        return false;
+    }
+
+    textureIds.push_back(textureId);
+    placements.emplace_back(textureId, rect.value());
+    dirtyTextureIds.push_back(textureId);
+
+    occupancy = packer->getOccupancy();
+
+    ++revision;
+
+    texture.updateAfterUploaded(
+        id,
+        static_cast<float>(rect->x) / static_cast<float>(width),
+        static_cast<float>(rect->y) / static_cast<float>(height),
+        static_cast<float>(rect->x + rect->width) / static_cast<float>(width),
+        static_cast<float>(rect->y + rect->height) / static_cast<float>(height)
+    );
+
+    return true;
+}
+
+void vox::TextureAtlas::eraseTexture(const uint32_t textureId) {
+    if (!packer.has_value()) {
+        throw std::runtime_error("[Atlas] Atlas " + std::to_string(id) + " must be stitched before erasing textures\n");
+    }
+
+    const auto placement = std::ranges::find(placements, textureId, &std::pair<uint32_t, TexturePackerRect>::first);
+
+    if (placement == placements.end()) {
+        throw std::runtime_error("[Atlas] Texture " + std::to_string(textureId) + " is not placed in atlas " + std::to_string(id) + "\n");
+    }
+
+    packer->remove(placement->second);
+
+    placements.erase(placement);
+    removeTexture(textureId);
+    std::erase(dirtyTextureIds, textureId);
+
+    occupancy = packer->getOccupancy();
+
+    ++revision;
+}
+
+std::optional<vox::TextureAtlas> vox::TextureAtlas::repackTextures() const {
+    auto atlas = TextureAtlas(id);
+    atlas.width = width;
+    atlas.height = height;
+    atlas.padding = padding;
+    atlas.mipLevels = mipLevels;
+    atlas.revision = revision;
+
+    // Sized by their current rects rather than their textures, which other threads may be changing.
+    auto sortedPlacements = placements;
+
+    std::ranges::stable_sort(sortedPlacements, [](const auto& lhs, const auto& rhs) {
+        if (lhs.second.height != rhs.second.height) {
+            return lhs.second.height > rhs.second.height;
+        }
+
+        return lhs.second.width > rhs.second.width;
+    });
+
+    auto& packer = atlas.packer.emplace(width, height, padding, 1u << (mipLevels - 1));
+
+    for (const auto& [textureId, currentRect] : sortedPlacements) {
+        const auto rect = packer.insert(currentRect.width, currentRect.height);
+
+        if (!rect.has_value()) {
+            return std::nullopt;
+        }
+
+        atlas.textureIds.push_back(textureId);
+        atlas.placements.emplace_back(textureId, rect.value());
+    }
+
+    atlas.occupancy = packer.getOccupancy();
 
-        stbi_image_free(image);
+    return atlas;
+}
+
+void vox::TextureAtlas::applyPlacements(TextureManager& textureManager) const {
+    for (const auto& [textureId, rect] : placements) {
+        auto& texture = textureManager.getTexture(textureId);
+
+        texture.updateAfterUploaded(
+            id,
+            static_cast<float>(rect.x) / static_cast<float>(width),
+            static_cast<float>(rect.y) / static_cast<float>(height),
+            static_cast<float>(rect.x + rect.width) / static_cast<float>(width),
+            static_cast<float>(rect.y + rect.height) / static_cast<float>(height)
+        );
     }
+}
+
+bool vox::TextureAtlas::hasDirtyTextures() const {
+    return !dirtyTextureIds.empty();
+}
+
+size_t vox::TextureAtlas::getDirtySize() const {
+    const auto alignment = 1u << (mipLevels - 1);
+
+    size_t size = 0;
+
+    for (const auto& [textureId, rect] : placements) {
+        if (std::ranges::find(dirtyTextureIds, textureId) == dirtyTextureIds.end()) {
+            continue;
+        }
+
+        const auto cellWidth = TexturePacker::getCellSize(rect.width, padding, alignment);
+        const auto cellHeight = TexturePacker::getCellSize(rect.height, padding, alignment);
+
+        for (uint32_t level = 0; level < mipLevels; ++level) {
+            size += static_cast<size_t>(getMipDimension(cellWidth, level)) * getMipDimension(cellHeight, level) * 4;
+        }
+    }
+
+    return size;
+}
+
+void vox::TextureAtlas::sortTextureIds(const TextureManager& textureManager) {
+    // Tall textures first; MaxRects packs noticeably tighter this way.
+    std::ranges::sort(textureIds, [&textureManager](const uint32_t lhs, const uint32_t rhs) {
+        const auto [lhsWidth, lhsHeight] = textureManager.getPlacedSize(lhs);
+        const auto [rhsWidth, rhsHeight] = textureManager.getPlacedSize(rhs);
+
+        if (lhsHeight != rhsHeight) {
+            return lhsHeight > rhsHeight;
+        }
+
+        return lhsWidth > rhsWidth;
+    });
+}
+
+void vox::TextureAtlas::buildCell(const TextureManager& textureManager, const uint32_t textureId, const TexturePackerRect& rect, const std::function<void(uint32_t, const uint8_t*, uint32_t, uint32_t)>& function) const {
+    const auto alignment = 1u << (mipLevels - 1);
+
+    auto pixels = textureManager.getPixels(textureId);
+
+    // Textures placed from a lower base level are reduced to it first.
+    const auto& texture = textureManager.getTexture(textureId);
+
+    auto sourceWidth = texture.getWidth();
+    auto sourceHeight = texture.getHeight();
+
+    std::vector<uint8_t> reduced;
+    std::vector<uint8_t> nextReduced;
+
+    while (sourceWidth > rect.width || sourceHeight > rect.height) {
+        nextReduced.resize(static_cast<size_t>(getMipDimension(sourceWidth, 1)) * getMipDimension(sourceHeight, 1) * 4);
+        downsampleBox(pixels.data(), sourceWidth, sourceHeight, nextReduced.data());
+
+        std::swap(reduced, nextReduced);
+        pixels = reduced;
+
+        sourceWidth = getMipDimension(sourceWidth, 1);
+        sourceHeight = getMipDimension(sourceHeight, 1);
+    }
+
+    auto cellWidth = TexturePacker::getCellSize(rect.width, padding, alignment);
+    auto cellHeight = TexturePacker::getCellSize(rect.height, padding, alignment);
+
+    // Build the cell with its gutter, clamping to the texture edges.
+    std::vector<uint8_t> cell(static_cast<size_t>(cellWidth) * cellHeight * 4);
+
+    for (uint32_t y = 0; y < cellHeight; ++y) {
+        const auto sourceY = std::clamp<int64_t>(static_cast<int64_t>(y) - padding, 0, rect.height - 1);
+
+        const auto* sourceRow = pixels.data() + static_cast<size_t>(sourceY) * rect.width * 4;
+        auto* cellRow = cell.data() + static_cast<size_t>(y) * cellWidth * 4;
+
+        for (uint32_t x = 0; x < padding; ++x) {
+            memcpy(cellRow + x * 4, sourceRow, 4);
+        }
+
+        memcpy(cellRow + padding * 4, sourceRow, static_cast<size_t>(rect.width) * 4);
+
+        for (auto x = padding + rect.width; x < cellWidth; ++x) {
+            memcpy(cellRow + x * 4, sourceRow + (rect.width - 1) * 4, 4);
+        }
+    }
+
+    std::vector<uint8_t> nextCell;
+
+    for (uint32_t level = 0; level < mipLevels; ++level) {
+        if (level > 0) {
+            nextCell.resize(static_cast<size_t>(getMipDimension(cellWidth, 1)) * getMipDimension(cellHeight, 1) * 4);
+            downsampleBox(cell.data(), cellWidth, cellHeight, nextCell.data());
+
+            std::swap(cell, nextCell);
+
+            cellWidth = getMipDimension(cellWidth, 1);
+            cellHeight = getMipDimension(cellHeight, 1);
+        }
+
+        function(level, cell.data(), cellWidth, cellHeight);
+    }
+}
+
+void vox::TextureAtlas::blitTextures(const TextureManager& textureManager, ThreadPool& threadPool, void* destination) const {
+    auto* atlasPixels = static_cast<uint8_t*>(destination);
+
+    // Staging memory is not zeroed, and free space must not
+    // carry garbage into filtered or mipmapped samples.
+    memset(atlasPixels, 0, getSize());
+
+    threadPool.parallelFor(placements.size(), [&](const size_t i) {
+        const auto& [textureId, rect] = placements[i];
+
+        const auto cellX = rect.x - padding;
+        const auto cellY = rect.y - padding;
+
+        buildCell(textureManager, textureId, rect, [&](const uint32_t level, const uint8_t* cell, const uint32_t cellWidth, const uint32_t cellHeight) {
+            const auto levelWidth = getMipDimension(width, level);
+
+            blitRows(
+                atlasPixels + getLevelOffset(level) + (static_cast<size_t>(cellY >> level) * levelWidth + (cellX >> level)) * 4,
+                static_cast<size_t>(levelWidth) * 4,
+                cell,
+                static_cast<size_t>(cellWidth) * 4,
+                static_cast<size_t>(cellWidth) * 4,
+                cellHeight
+            );
+        });
+    });
+}
+
+std::vector<vox::TextureAtlasRegion> vox::TextureAtlas::blitDirtyTextures(const TextureManager& textureManager, ThreadPool& threadPool, void* destination) {
+    auto* dirtyPixels = static_cast<uint8_t*>(destination);
+
+    const auto alignment = 1u << (mipLevels - 1);
+
+    // Lay out every level of every dirty cell up front, so that
+    // cells can be built in parallel into disjoint ranges.
+    std::vector<std::pair<uint32_t, TexturePackerRect>> dirtyPlacements;
+    std::vector<TextureAtlasRegion> regions;
+
+    size_t offset = 0;
+
+    for (const auto& [textureId, rect] : placements) {
+        if (std::ranges::find(dirtyTextureIds, textureId) == dirtyTextureIds.end()) {
+            continue;
+        }
+
+        dirtyPlacements.emplace_back(textureId, rect);
+
+        const auto cellWidth = TexturePacker::getCellSize(rect.width, padding, alignment);
+        const auto cellHeight = TexturePacker::getCellSize(rect.height, padding, alignment);
+
+        for (uint32_t level = 0; level < mipLevels; ++level) {
+            const TextureAtlasRegion region {
+                level,
+                (rect.x - padding) >> level,
+                (rect.y - padding) >> level,
+                getMipDimension(cellWidth, level),
+                getMipDimension(cellHeight, level),
+                offset
+            };
+
+            offset += static_cast<size_t>(region.width) * region.height * 4;
+
+            regions.push_back(region);
+        }
+    }
+
+    threadPool.parallelFor(dirtyPlacements.size(), [&](const size_t i) {
+        const auto& [textureId, rect] = dirtyPlacements[i];
+
+        buildCell(textureManager, textureId, rect, [&](const uint32_t level, const uint8_t* cell, const uint32_t cellWidth, const uint32_t cellHeight) {
+            memcpy(dirtyPixels + regions[i * mipLevels + level].offset, cell, static_cast<size_t>(cellWidth) * cellHeight * 4);
+        });
+    });
+
+    dirtyTextureIds.clear();
+
+    return regions;
+}
 
-    stbi_write_png("atlas.png", totalWidth, totalHeight, 4, data.data(), totalWidth * 4);
+void vox::TextureAtlas::dump(const std::string& path, const void* data) const {
+    stbi_write_png(path.c_str(), static_cast<int>(width), static_cast<int>(height), 4, data, static_cast<int>(width) * 4);
 }
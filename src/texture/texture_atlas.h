@@ -7,25 +7,134 @@
 
 
 #include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
 #include <vector>
 #include <algorithm>
 
+#include "texture_packer.h"
+
 namespace vox {
     class TextureManager;
+    class ThreadPool;
 
-    class TextureAtlas {
-        const uint32_t id;
+    // Part of one mip level of an atlas, stored tightly packed at offset.
+    struct TextureAtlasRegion {
+        uint32_t level;
 
+        uint32_t x;
+        uint32_t y;
         uint32_t width;
         uint32_t height;
 
+        size_t offset;
+    };
+
+    class TextureAtlas {
+        const uint32_t id;
+
+        uint32_t width = 0;
+        uint32_t height = 0;
+
+        uint32_t padding = 0;
+        uint32_t mipLevels = 1;
+
+        float occupancy = 0.0f;
+
+        // Bumped whenever textures are placed or erased, to tell repacks of an older layout apart.
+        uint64_t revision = 0;
+
         std::vector<uint32_t> textureIds = {};
 
+        std::vector<std::pair<uint32_t, TexturePackerRect>> placements = {};
+
+        // Packer state, kept after stitching so textures can be added and removed in place.
+        std::optional<TexturePacker> packer = std::nullopt;
+
+        // Textures placed since the last upload, whose cells must be uploaded.
+        std::vector<uint32_t> dirtyTextureIds = {};
+
+        void sortTextureIds(const TextureManager& textureManager);
+
+        // Builds the edge-extended cell of a placement, and passes every
+        // mip level of it to function, along with its size in texels.
+        void buildCell(const TextureManager& textureManager, uint32_t textureId, const TexturePackerRect& rect, const std::function<void(uint32_t, const uint8_t*, uint32_t, uint32_t)>& function) const;
+
+    public:
+        TextureAtlas() = delete;
+
+        explicit TextureAtlas(uint32_t id)
+                : id(id) {
+        }
+
+        [[nodiscard]] uint32_t getId() const;
+
+        [[nodiscard]] uint32_t getWidth() const;
+        [[nodiscard]] uint32_t getHeight() const;
+
+        [[nodiscard]] uint32_t getMipLevels() const;
+
+        [[nodiscard]] float getOccupancy() const;
+
+        [[nodiscard]] float getFragmentation() const;
+
+        [[nodiscard]] uint64_t getRevision() const;
+
+        [[nodiscard]] const std::vector<uint32_t>& getTextureIds() const;
+
+        [[nodiscard]] const std::vector<std::pair<uint32_t, TexturePackerRect>>& getPlacements() const;
+
+        // Size in bytes of the RGBA8 atlas image, including every mip level.
+        [[nodiscard]] size_t getSize() const;
+
+        // Offset in bytes of a mip level, within the tightly packed chain.
+        [[nodiscard]] size_t getLevelOffset(uint32_t level) const;
+
         void addTexture(uint32_t textureId);
 
         void removeTexture(uint32_t textureId);
 
-        void stitchTextures(TextureManager& textureManager);
+        // Packs as many textures as fit into a single power-of-two page no larger
+        // than maxDimension, and returns the ids of those that did not fit.
+        // Cells are aligned so that mipLevels levels can be built without bleeding.
+        std::vector<uint32_t> stitchTextures(TextureManager& textureManager, uint32_t maxDimension, uint32_t padding, uint32_t mipLevels);
+
+        // Places a single texture in the free space of a stitched atlas, without
+        // moving any other; returns false if it does not fit.
+        bool insertTexture(TextureManager& textureManager, uint32_t textureId);
+
+        // Frees the cell of a placed texture. Its texels are left in the image,
+        // but nothing samples them until the cell is reused.
+        void eraseTexture(uint32_t textureId);
+
+        // Packs the current placements again, into a page of the same size, so
+        // that the existing image can be reused; every cell moves, so the whole
+        // image must be uploaded again. Only reads this atlas, so it can run on
+        // a worker thread while the texture manager keeps changing.
+        [[nodiscard]] std::optional<TextureAtlas> repackTextures() const;
+
+        // Writes the placements of this atlas back into their textures.
+        void applyPlacements(TextureManager& textureManager) const;
+
+        [[nodiscard]] bool hasDirtyTextures() const;
+
+        // Size in bytes of every dirty cell, including every mip level.
+        [[nodiscard]] size_t getDirtySize() const;
+
+        // Copies every placed texture, and its mip chain, into destination, which
+        // must hold getSize() bytes; this is normally the mapped staging buffer
+        // of the atlas image. Gutters are filled by extending the texture edges.
+        void blitTextures(const TextureManager& textureManager, ThreadPool& threadPool, void* destination) const;
+
+        // Copies every dirty cell, and its mip chain, tightly packed into destination,
+        // which must hold getDirtySize() bytes, and clears the dirty list. Returns
+        // the regions of the atlas image to copy them to.
+        std::vector<TextureAtlasRegion> blitDirtyTextures(const TextureManager& textureManager, ThreadPool& threadPool, void* destination);
+
+        // Debug helper, writes the given atlas pixels to a PNG file.
+        void dump(const std::string& path, const void* data) const;
     };
 }
 
@@ -0,0 +1,482 @@
+#include "texture_bc.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "../misc/thread_pool.h"
+
+namespace vox {
+    using BlockTexels = std::array<std::array<float, 4>, 16>;
+
+    static BlockTexels loadBlockTexels(const uint8_t* texels) {
+        BlockTexels result;
+
+        for (size_t i = 0; i < 16; ++i) {
+            for (size_t c = 0; c < 4; ++c) {
+                result[i][c] = texels[i * 4 + c];
+            }
+        }
+
+        return result;
+    }
+
+    // Fits a line through the block along its principal axis, found by power
+    // iteration on the covariance matrix, and returns the two extreme points.
+    template<size_t Channels>
+    static std::pair<std::array<float, 4>, std::array<float, 4>> fitEndpoints(const BlockTexels& texels) {
+        std::array<float, 4> mean = {};
+
+        for (const auto& texel : texels) {
+            for (size_t c = 0; c < Channels; ++c) {
+                mean[c] += texel[c] / 16.0f;
+            }
+        }
+
+        std::array<std::array<float, 4>, 4> covariance = {};
+
+        for (const auto& texel : texels) {
+            for (size_t i = 0; i < Channels; ++i) {
+                for (size_t j = 0; j < Channels; ++j) {
+                    covariance[i][j] += (texel[i] - mean[i]) * (texel[j] - mean[j]);
+                }
+            }
+        }
+
+        std::array<float, 4> axis = {};
+
+        for (size_t c = 0; c < Channels; ++c) {
+            axis[c] = 1.0f;
+        }
+
+        for (int iteration = 0; iteration < 8; ++iteration) {
+            std::array<float, 4> next = {};
+
+            for (size_t i = 0; i < Channels; ++i) {
+                for (size_t j = 0; j < Channels; ++j) {
+                    next[i] += covariance[i][j] * axis[j];
+                }
+            }
+
+            auto length = 0.0f;
+
+            for (size_t c = 0; c < Channels; ++c) {
+                length = std::max(length, std::abs(next[c]));
+            }
+
+            // Flat blocks have no principal axis; any direction will do.
+            if (length < 1e-6f) {
+                break;
+            }
+
+            for (size_t c = 0; c < Channels; ++c) {
+                axis[c] = next[c] / length;
+            }
+        }
+
+        auto axisLengthSquared = 0.0f;
+
+        for (size_t c = 0; c < Channels; ++c) {
+            axisLengthSquared += axis[c] * axis[c];
+        }
+
+        auto minT = 0.0f;
+        auto maxT = 0.0f;
+
+        for (const auto& texel : texels) {
+            auto t = 0.0f;
+
+            for (size_t c = 0; c < Channels; ++c) {
+                t += (texel[c] - mean[c]) * axis[c];
+            }
+
+            t /= axisLengthSquared;
+
+            minT = std::min(minT, t);
+            maxT = std::max(maxT, t);
+        }
+
+        std::array<float, 4> low = {};
+        std::array<float, 4> high = {};
+
+        for (size_t c = 0; c < Channels; ++c) {
+            low[c] = std::clamp(mean[c] + axis[c] * minT, 0.0f, 255.0f);
+            high[c] = std::clamp(mean[c] + axis[c] * maxT, 0.0f, 255.0f);
+        }
+
+        return { low, high };
+    }
+
+    static uint16_t packRGB565(const std::array<float, 4>& color) {
+        const auto r = static_cast<uint16_t>(std::lround(color[0] * 31.0f / 255.0f));
+        const auto g = static_cast<uint16_t>(std::lround(color[1] * 63.0f / 255.0f));
+        const auto b = static_cast<uint16_t>(std::lround(color[2] * 31.0f / 255.0f));
+
+        return static_cast<uint16_t>(r << 11 | g << 5 | b);
+    }
+
+    static std::array<float, 4> unpackRGB565(const uint16_t color) {
+        const auto r = color >> 11 & 31;
+        const auto g = color >> 5 & 63;
+        const auto b = color & 31;
+
+        return { static_cast<float>(r << 3 | r >> 2), static_cast<float>(g << 2 | g >> 4), static_cast<float>(b << 3 | b >> 2), 255.0f };
+    }
+
+    // Picks the closest of the four palette colors for every texel, and returns the total error.
+    static float selectColorIndices(const BlockTexels& texels, const uint16_t color0, const uint16_t color1, uint32_t& indices) {
+        const auto c0 = unpackRGB565(color0);
+        const auto c1 = unpackRGB565(color1);
+
+        std::array<std::array<float, 4>, 4> palette = { c0, c1 };
+
+        for (size_t c = 0; c < 3; ++c) {
+            palette[2][c] = (2.0f * c0[c] + c1[c]) / 3.0f;
+            palette[3][c] = (c0[c] + 2.0f * c1[c]) / 3.0f;
+        }
+
+        indices = 0;
+
+        auto totalError = 0.0f;
+
+        for (size_t i = 0; i < 16; ++i) {
+            auto bestError = std::numeric_limits<float>::max();
+            uint32_t bestIndex = 0;
+
+            for (uint32_t p = 0; p < 4; ++p) {
+                auto error = 0.0f;
+
+                for (size_t c = 0; c < 3; ++c) {
+                    const auto difference = texels[i][c] - palette[p][c];
+                    error += difference * difference;
+                }
+
+                if (error < bestError) {
+                    bestError = error;
+                    bestIndex = p;
+                }
+            }
+
+            indices |= bestIndex << (i * 2);
+            totalError += bestError;
+        }
+
+        return totalError;
+    }
+
+    // Solves for the endpoints that best reproduce the block with the given indices (least squares).
+    static bool refineColorEndpoints(const BlockTexels& texels, const uint32_t indices, std::array<float, 4>& high, std::array<float, 4>& low) {
+        constexpr float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+        auto alpha2 = 0.0f;
+        auto beta2 = 0.0f;
+        auto alphaBeta = 0.0f;
+
+        std::array<float, 4> alphaX = {};
+        std::array<float, 4> betaX = {};
+
+        for (size_t i = 0; i < 16; ++i) {
+            const auto alpha = weights[indices >> (i * 2) & 3];
+            const auto beta = 1.0f - alpha;
+
+            alpha2 += alpha * alpha;
+            beta2 += beta * beta;
+            alphaBeta += alpha * beta;
+
+            for (size_t c = 0; c < 3; ++c) {
+                alphaX[c] += alpha * texels[i][c];
+                betaX[c] += beta * texels[i][c];
+            }
+        }
+
+        const auto determinant = alpha2 * beta2 - alphaBeta * alphaBeta;
+
+        if (std::abs(determinant) < 1e-6f) {
+            return false;
+        }
+
+        for (size_t c = 0; c < 3; ++c) {
+            high[c] = std::clamp((alphaX[c] * beta2 - betaX[c] * alphaBeta) / determinant, 0.0f, 255.0f);
+            low[c] = std::clamp((betaX[c] * alpha2 - alphaX[c] * alphaBeta) / determinant, 0.0f, 255.0f);
+        }
+
+        return true;
+    }
+
+    // Encodes the color half of a BC1 or BC3 block, always in four-color mode.
+    static void encodeColorBlock(const BlockTexels& texels, uint8_t* block) {
+        auto [low, high] = fitEndpoints<3>(texels);
+
+        auto color0 = packRGB565(high);
+        auto color1 = packRGB565(low);
+
+        uint32_t indices = 0;
+        auto error = selectColorIndices(texels, color0, color1, indices);
+
+        if (refineColorEndpoints(texels, indices, high, low)) {
+            const auto refinedColor0 = packRGB565(high);
+            const auto refinedColor1 = packRGB565(low);
+
+            uint32_t refinedIndices = 0;
+
+            if (const auto refinedError = selectColorIndices(texels, refinedColor0, refinedColor1, refinedIndices); refinedError < error) {
+                color0 = refinedColor0;
+                color1 = refinedColor1;
+                indices = refinedIndices;
+                error = refinedError;
+            }
+        }
+
+        // Four-color mode requires color0 > color1; swapping the endpoints
+        // swaps palette entries 0 with 1 and 2 with 3, which is index ^ 1.
+        if (color0 < color1) {
+            std::swap(color0, color1);
+            indices ^= 0x55555555u;
+        } else if (color0 == color1) {
+            indices = 0;
+        }
+
+        block[0] = static_cast<uint8_t>(color0);
+        block[1] = static_cast<uint8_t>(color0 >> 8);
+        block[2] = static_cast<uint8_t>(color1);
+        block[3] = static_cast<uint8_t>(color1 >> 8);
+
+        for (size_t i = 0; i < 4; ++i) {
+            block[4 + i] = static_cast<uint8_t>(indices >> (i * 8));
+        }
+    }
+
+    // Encodes a BC4 alpha block, in eight-value mode.
+    static void encodeAlphaBlock(const BlockTexels& texels, uint8_t* block) {
+        auto alpha0 = 0.0f;
+        auto alpha1 = 255.0f;
+
+        for (const auto& texel : texels) {
+            alpha0 = std::max(alpha0, texel[3]);
+            alpha1 = std::min(alpha1, texel[3]);
+        }
+
+        const auto a0 = static_cast<uint8_t>(alpha0);
+        const auto a1 = static_cast<uint8_t>(alpha1);
+
+        block[0] = a0;
+        block[1] = a1;
+
+        std::array<float, 8> palette = { static_cast<float>(a0), static_cast<float>(a1) };
+
+        for (size_t i = 1; i < 7; ++i) {
+            palette[i + 1] = static_cast<float>(((7 - i) * a0 + i * a1) / 7);
+        }
+
+        uint64_t indices = 0;
+
+        if (a0 != a1) {
+            for (size_t i = 0; i < 16; ++i) {
+                uint64_t bestIndex = 0;
+
+                for (uint64_t p = 1; p < 8; ++p) {
+                    if (std::abs(texels[i][3] - palette[p]) < std::abs(texels[i][3] - palette[bestIndex])) {
+                        bestIndex = p;
+                    }
+                }
+
+                indices |= bestIndex << (i * 3);
+            }
+        }
+
+        for (size_t i = 0; i < 6; ++i) {
+            block[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+        }
+    }
+
+    size_t getBlockSize(const TextureBlockFormat format) {
+        switch (format) {
+            case TextureBlockFormat::BC1:
+                return 8;
+            case TextureBlockFormat::RGBA8:
+                return 4;
+            default:
+                return 16;
+        }
+    }
+
+    size_t getCompressedSize(const TextureBlockFormat format, const uint32_t width, const uint32_t height) {
+        if (format == TextureBlockFormat::RGBA8) {
+            return static_cast<size_t>(width) * height * 4;
+        }
+
+        return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * getBlockSize(format);
+    }
+
+    bool isOpaque(const std::span<const uint8_t> pixels) {
+        for (size_t i = 3; i < pixels.size(); i += 4) {
+            if (pixels[i] != 255) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void encodeBC1Block(const uint8_t* texels, uint8_t* block) {
+        encodeColorBlock(loadBlockTexels(texels), block);
+    }
+
+    void encodeBC3Block(const uint8_t* texels, uint8_t* block) {
+        const auto blockTexels = loadBlockTexels(texels);
+
+        encodeAlphaBlock(blockTexels, block);
+        encodeColorBlock(blockTexels, block + 8);
+    }
+
+    void encodeBC7Block(const uint8_t* texels, uint8_t* block) {
+        constexpr uint32_t weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        const auto blockTexels = loadBlockTexels(texels);
+        const auto [low, high] = fitEndpoints<4>(blockTexels);
+
+        std::array<std::array<uint32_t, 4>, 2> bestEndpoints = {};
+        std::array<uint32_t, 2> bestPBits = {};
+        std::array<uint32_t, 16> bestIndices = {};
+
+        auto bestError = std::numeric_limits<uint64_t>::max();
+
+        // Mode 6 endpoints are 7 bits per channel plus a shared low bit per
+        // endpoint (the p-bit); every p-bit combination is tried.
+        for (uint32_t pBits = 0; pBits < 4; ++pBits) {
+            const std::array<uint32_t, 2> p = { pBits & 1, pBits >> 1 };
+
+            std::array<std::array<uint32_t, 4>, 2> endpoints = {};
+
+            for (size_t c = 0; c < 4; ++c) {
+                const auto quantize = [](const float value, const uint32_t pBit) {
+                    return static_cast<uint32_t>(std::clamp<long>(std::lround((value - static_cast<float>(pBit)) / 2.0f), 0, 127));
+                };
+
+                endpoints[0][c] = quantize(low[c], p[0]);
+                endpoints[1][c] = quantize(high[c], p[1]);
+            }
+
+            std::array<std::array<uint32_t, 4>, 16> palette = {};
+
+            for (size_t w = 0; w < 16; ++w) {
+                for (size_t c = 0; c < 4; ++c) {
+                    const auto e0 = endpoints[0][c] << 1 | p[0];
+                    const auto e1 = endpoints[1][c] << 1 | p[1];
+
+                    palette[w][c] = ((64 - weights[w]) * e0 + weights[w] * e1 + 32) >> 6;
+                }
+            }
+
+            std::array<uint32_t, 16> indices = {};
+            uint64_t totalError = 0;
+
+            for (size_t i = 0; i < 16; ++i) {
+                auto bestTexelError = std::numeric_limits<uint32_t>::max();
+
+                for (uint32_t w = 0; w < 16; ++w) {
+                    uint32_t error = 0;
+
+                    for (size_t c = 0; c < 4; ++c) {
+                        const auto difference = static_cast<int32_t>(texels[i * 4 + c]) - static_cast<int32_t>(palette[w][c]);
+                        error += static_cast<uint32_t>(difference * difference);
+                    }
+
+                    if (error < bestTexelError) {
+                        bestTexelError = error;
+                        indices[i] = w;
+                    }
+                }
+
+                totalError += bestTexelError;
+            }
+
+            if (totalError < bestError) {
+                bestError = totalError;
+                bestEndpoints = endpoints;
+                bestPBits = p;
+                bestIndices = indices;
+            }
+        }
+
+        // The first index is stored with its top bit implied to be zero.
+        if (bestIndices[0] >= 8) {
+            std::swap(bestEndpoints[0], bestEndpoints[1]);
+            std::swap(bestPBits[0], bestPBits[1]);
+
+            for (auto& index : bestIndices) {
+                index = 15 - index;
+            }
+        }
+
+        std::memset(block, 0, 16);
+
+        uint32_t bitOffset = 0;
+
+        const auto writeBits = [&](const uint32_t value, const uint32_t bitCount) {
+            for (uint32_t i = 0; i < bitCount; ++i, ++bitOffset) {
+                block[bitOffset / 8] |= static_cast<uint8_t>((value >> i & 1) << (bitOffset % 8));
+            }
+        };
+
+        writeBits(1 << 6, 7);
+
+        for (size_t c = 0; c < 4; ++c) {
+            writeBits(bestEndpoints[0][c], 7);
+            writeBits(bestEndpoints[1][c], 7);
+        }
+
+        writeBits(bestPBits[0], 1);
+        writeBits(bestPBits[1], 1);
+
+        for (size_t i = 0; i < 16; ++i) {
+            writeBits(bestIndices[i], i == 0 ? 3 : 4);
+        }
+    }
+
+    void compressImage(ThreadPool& threadPool, const TextureBlockFormat format, const uint8_t* source, const uint32_t width, const uint32_t height, uint8_t* destination) {
+        if (format == TextureBlockFormat::RGBA8) {
+            std::memcpy(destination, source, getCompressedSize(format, width, height));
+            return;
+        }
+
+        const auto blocksX = (width + 3) / 4;
+        const auto blocksY = (height + 3) / 4;
+
+        const auto blockSize = getBlockSize(format);
+
+        threadPool.parallelFor(blocksY, [&](const size_t blockY) {
+            uint8_t texels[64];
+
+            for (uint32_t blockX = 0; blockX < blocksX; ++blockX) {
+                for (uint32_t y = 0; y < 4; ++y) {
+                    const auto sourceY = std::min(static_cast<uint32_t>(blockY) * 4 + y, height - 1);
+
+                    for (uint32_t x = 0; x < 4; ++x) {
+                        const auto sourceX = std::min(blockX * 4 + x, width - 1);
+
+                        std::memcpy(texels + (y * 4 + x) * 4, source + (static_cast<size_t>(sourceY) * width + sourceX) * 4, 4);
+                    }
+                }
+
+                auto* block = destination + (blockY * blocksX + blockX) * blockSize;
+
+                switch (format) {
+                    case TextureBlockFormat::BC1:
+                        encodeBC1Block(texels, block);
+                        break;
+                    case TextureBlockFormat::BC3:
+                        encodeBC3Block(texels, block);
+                        break;
+                    case TextureBlockFormat::BC7:
+                        encodeBC7Block(texels, block);
+                        break;
+                    case TextureBlockFormat::RGBA8:
+                        break;
+                }
+            }
+        });
+    }
+}
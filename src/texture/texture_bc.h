@@ -0,0 +1,55 @@
+#ifndef VOX_TEXTURE_BC_H
+#define VOX_TEXTURE_BC_H
+
+/**
+ * Block compression (BCn) encoder for RGBA8 images.
+ *
+ * Every 4x4 texel block is encoded independently:
+ * - BC1 stores opaque RGB in 8 bytes per block (8:1).
+ * - BC3 stores RGB as BC1 plus an interpolated alpha block, in 16 bytes (4:1).
+ * - BC7 stores RGBA in 16 bytes (4:1), at much higher quality; only mode 6
+ *   (a single RGBA line with 4-bit indices) is produced by this encoder.
+ *
+ * Endpoints are fitted along the principal axis of the block, which is
+ * fast enough to run at bake time and close to what offline tools produce
+ * for smooth content.
+ *
+ * RGBA8 is the uncompressed format, with one texel per "block"; it is
+ * used to cache decoded pixels in the same containers.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace vox {
+    class ThreadPool;
+
+    enum class TextureBlockFormat : uint8_t {
+        BC1,
+        BC3,
+        BC7,
+        RGBA8
+    };
+
+    // Size in bytes of a single 4x4 block, or of a texel for RGBA8.
+    [[nodiscard]] size_t getBlockSize(TextureBlockFormat format);
+
+    // Size in bytes of a whole image, whose edges are padded to full blocks.
+    [[nodiscard]] size_t getCompressedSize(TextureBlockFormat format, uint32_t width, uint32_t height);
+
+    // Whether every texel of the given RGBA8 pixels has an alpha of 255.
+    [[nodiscard]] bool isOpaque(std::span<const uint8_t> pixels);
+
+    // Encoders for a single block of 16 RGBA8 texels, in row-major order.
+    void encodeBC1Block(const uint8_t* texels, uint8_t* block);
+    void encodeBC3Block(const uint8_t* texels, uint8_t* block);
+    void encodeBC7Block(const uint8_t* texels, uint8_t* block);
+
+    // Compresses an RGBA8 image into destination, which must hold
+    // getCompressedSize(format, width, height) bytes. Rows of blocks
+    // are encoded in parallel; edge blocks repeat the last texels.
+    void compressImage(ThreadPool& threadPool, TextureBlockFormat format, const uint8_t* source, uint32_t width, uint32_t height, uint8_t* destination);
+}
+
+#endif
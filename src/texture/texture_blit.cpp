@@ -0,0 +1,51 @@
+#include "texture_blit.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VOX_BLIT_AVX2
+#include <immintrin.h>
+#endif
+
+namespace vox {
+#ifdef VOX_BLIT_AVX2
+    __attribute__((target("avx2")))
+    static void blitRowsAVX2(uint8_t* destination, const size_t destinationStride, const uint8_t* source, const size_t sourceStride, const size_t rowSize, const uint32_t rowCount) {
+        for (uint32_t row = 0; row < rowCount; ++row) {
+            auto* destinationRow = destination + row * destinationStride;
+            const auto* sourceRow = source + row * sourceStride;
+
+            // Streaming stores need 32-byte aligned destinations.
+            const auto head = std::min(rowSize, (32 - reinterpret_cast<uintptr_t>(destinationRow) % 32) % 32);
+            memcpy(destinationRow, sourceRow, head);
+
+            size_t offset = head;
+
+            for (; offset + 32 <= rowSize; offset += 32) {
+                const auto pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sourceRow + offset));
+                _mm256_stream_si256(reinterpret_cast<__m256i*>(destinationRow + offset), pixels);
+            }
+
+            memcpy(destinationRow + offset, sourceRow + offset, rowSize - offset);
+        }
+
+        _mm_sfence();
+    }
+#endif
+
+    void blitRows(uint8_t* destination, const size_t destinationStride, const uint8_t* source, const size_t sourceStride, const size_t rowSize, const uint32_t rowCount) {
+#ifdef VOX_BLIT_AVX2
+        static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+
+        if (hasAVX2) {
+            blitRowsAVX2(destination, destinationStride, source, sourceStride, rowSize, rowCount);
+            return;
+        }
+#endif
+
+        for (uint32_t row = 0; row < rowCount; ++row) {
+            memcpy(destination + row * destinationStride, source + row * sourceStride, rowSize);
+        }
+    }
+}
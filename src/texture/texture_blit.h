@@ -0,0 +1,21 @@
+#ifndef VOX_TEXTURE_BLIT_H
+#define VOX_TEXTURE_BLIT_H
+
+/**
+ * Row-wise copy kernels used to place texture pixels into
+ * (usually write-combined) mapped staging memory.
+ *
+ * On x86 CPUs with AVX2 the rows are written with non-temporal
+ * stores, which bypass the cache and avoid the read-for-ownership
+ * traffic that ordinary stores cause on write-combined memory.
+ * Everywhere else each row is a single memcpy.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vox {
+    void blitRows(uint8_t* destination, size_t destinationStride, const uint8_t* source, size_t sourceStride, size_t rowSize, uint32_t rowCount);
+}
+
+#endif
@@ -0,0 +1,45 @@
+#include "texture_cache.h"
+
+#include <functional>
+#include <iostream>
+#include <thread>
+
+#include "../misc/constants.h"
+
+std::filesystem::path vox::TextureCache::getPath(const Hash128& sourceHash, const std::string& kind) const {
+    return directory / (sourceHash.toString() + "-" + kind + ".ktx2");
+}
+
+vox::Hash128 vox::TextureCache::hashSource(const std::span<const uint8_t> sourceBytes) {
+    return hash128(sourceBytes, TEXTURE_CACHE_VERSION);
+}
+
+std::optional<vox::TextureKtx2> vox::TextureCache::find(const Hash128& sourceHash, const std::string& kind) const {
+    const auto path = getPath(sourceHash, kind);
+
+    if (!std::filesystem::exists(path)) {
+        return std::nullopt;
+    }
+
+    // A corrupt entry is treated as a miss, and overwritten by the caller.
+    try {
+        return TextureKtx2::read(path.string());
+    } catch (const std::runtime_error& error) {
+        std::cerr << "[Cache] Ignoring corrupt entry " << path.string() << ": " << error.what() << "\n" << std::flush;
+        return std::nullopt;
+    }
+}
+
+void vox::TextureCache::store(const Hash128& sourceHash, const std::string& kind, const TextureKtx2& texture) const {
+    const auto path = getPath(sourceHash, kind);
+
+    std::filesystem::create_directories(directory);
+
+    // Written next to the entry and renamed over it; identical sources may be stored concurrently.
+    auto temporaryPath = path;
+    temporaryPath += "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+
+    texture.write(temporaryPath.string());
+
+    std::filesystem::rename(temporaryPath, path);
+}
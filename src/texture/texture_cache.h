@@ -0,0 +1,50 @@
+#ifndef VOX_TEXTURE_CACHE_H
+#define VOX_TEXTURE_CACHE_H
+
+/**
+ * Content-addressed on-disk cache of decoded and baked textures.
+ *
+ * Entries are KTX2 files named after the hash of the source image
+ * bytes and the kind of payload they hold (e.g. "rgba8" for decoded
+ * pixels, "bc" for block-compressed mip chains), so a source image
+ * that changes gets a new entry and stale entries are never read.
+ *
+ * Decoded entries only hold the base level: the mip chain of a
+ * standalone texture is blitted on the GPU, and atlases downsample
+ * their cells once placed. Baked entries hold every level.
+ *
+ * Entries are memory mapped when found, and written atomically, so
+ * concurrent loads never observe a partially written file.
+ */
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+
+#include "texture_ktx2.h"
+#include "../misc/hash.h"
+
+namespace vox {
+    class TextureCache {
+        std::filesystem::path directory;
+
+        [[nodiscard]] std::filesystem::path getPath(const Hash128& sourceHash, const std::string& kind) const;
+
+    public:
+        TextureCache() = delete;
+
+        explicit TextureCache(std::filesystem::path directory)
+                : directory(std::move(directory)) {
+        }
+
+        // Hashes source bytes, salted with the cache version.
+        [[nodiscard]] static Hash128 hashSource(std::span<const uint8_t> sourceBytes);
+
+        [[nodiscard]] std::optional<TextureKtx2> find(const Hash128& sourceHash, const std::string& kind) const;
+
+        void store(const Hash128& sourceHash, const std::string& kind, const TextureKtx2& texture) const;
+    };
+}
+
+#endif
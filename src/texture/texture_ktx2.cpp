@@ -0,0 +1,348 @@
+#include "texture_ktx2.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "texture_mipmap.h"
+#include "../misc/thread_pool.h"
+
+namespace {
+    constexpr uint8_t KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+    // Identifier, header and index; the level index follows immediately.
+    constexpr size_t KTX2_HEADER_SIZE = 80;
+    constexpr size_t KTX2_LEVEL_INDEX_ENTRY_SIZE = 24;
+
+    // Data format descriptor constants (Khronos Data Format Specification 1.3).
+    constexpr uint32_t KHR_DF_VERSION = 2;
+    constexpr uint32_t KHR_DF_MODEL_RGBSDA = 1;
+    constexpr uint32_t KHR_DF_MODEL_BC1A = 128;
+    constexpr uint32_t KHR_DF_MODEL_BC3 = 130;
+    constexpr uint32_t KHR_DF_MODEL_BC7 = 134;
+    constexpr uint32_t KHR_DF_PRIMARIES_BT709 = 1;
+    constexpr uint32_t KHR_DF_TRANSFER_SRGB = 2;
+    constexpr uint32_t KHR_DF_CHANNEL_COLOR = 0;
+    constexpr uint32_t KHR_DF_CHANNEL_RED = 0;
+    constexpr uint32_t KHR_DF_CHANNEL_GREEN = 1;
+    constexpr uint32_t KHR_DF_CHANNEL_BLUE = 2;
+    constexpr uint32_t KHR_DF_CHANNEL_ALPHA = 15;
+    constexpr uint32_t KHR_DF_SAMPLE_DATATYPE_LINEAR = 0x10;
+
+    struct Ktx2Sample {
+        uint32_t channelType;
+        uint32_t bitOffset;
+        uint32_t bitLength;
+    };
+
+    size_t alignUp(const size_t value, const size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+vox::TextureKtx2 vox::TextureKtx2::bake(ThreadPool& threadPool, const std::span<const uint8_t> pixels, const uint32_t width, const uint32_t height, const TextureBlockFormat format) {
+    TextureKtx2 texture(format, width, height);
+
+    const auto levelCount = getMipLevelCount(width, height);
+
+    size_t totalSize = 0;
+
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        texture.levelOffsets.push_back(totalSize);
+        totalSize += getCompressedSize(format, getMipDimension(width, level), getMipDimension(height, level));
+    }
+
+    texture.data.resize(totalSize);
+
+    std::vector<uint8_t> levelPixels(pixels.begin(), pixels.end());
+    std::vector<uint8_t> nextLevelPixels;
+
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        const auto levelWidth = getMipDimension(width, level);
+        const auto levelHeight = getMipDimension(height, level);
+
+        if (level > 0) {
+            const auto previousWidth = getMipDimension(width, level - 1);
+            const auto previousHeight = getMipDimension(height, level - 1);
+
+            nextLevelPixels.resize(static_cast<size_t>(levelWidth) * levelHeight * 4);
+            downsampleBox(levelPixels.data(), previousWidth, previousHeight, nextLevelPixels.data());
+
+            std::swap(levelPixels, nextLevelPixels);
+        }
+
+        compressImage(threadPool, format, levelPixels.data(), levelWidth, levelHeight, texture.data.data() + texture.levelOffsets[level]);
+    }
+
+    return texture;
+}
+
+vox::TextureKtx2 vox::TextureKtx2::read(const std::string& path) {
+    MappedFile file(path);
+
+    const auto bytes = file.getBytes();
+    const auto fileSize = bytes.size();
+
+    const auto readU32 = [&](const size_t offset) {
+        if (offset + 4 > fileSize) {
+            throw std::runtime_error("[KTX2] Truncated file: " + path + "\n");
+        }
+
+        uint32_t value;
+        memcpy(&value, bytes.data() + offset, 4);
+
+        return value;
+    };
+
+    const auto readU64 = [&](const size_t offset) {
+        if (offset + 8 > fileSize) {
+            throw std::runtime_error("[KTX2] Truncated file: " + path + "\n");
+        }
+
+        uint64_t value;
+        memcpy(&value, bytes.data() + offset, 8);
+
+        return value;
+    };
+
+    if (fileSize < KTX2_HEADER_SIZE || memcmp(bytes.data(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0) {
+        throw std::runtime_error("[KTX2] Not a KTX2 file: " + path + "\n");
+    }
+
+    const auto vkFormat = readU32(12);
+    const auto width = readU32(20);
+    const auto height = readU32(24);
+    const auto depth = readU32(28);
+    const auto layerCount = readU32(32);
+    const auto faceCount = readU32(36);
+    const auto levelCount = std::max(readU32(40), 1u);
+    const auto supercompressionScheme = readU32(44);
+
+    if (depth != 0 || layerCount > 1 || faceCount != 1 || supercompressionScheme != 0) {
+        throw std::runtime_error("[KTX2] Only uncompressed 2D images are supported: " + path + "\n");
+    }
+
+    TextureBlockFormat format;
+
+    switch (vkFormat) {
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+            format = TextureBlockFormat::BC1;
+            break;
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+            format = TextureBlockFormat::BC3;
+            break;
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+            format = TextureBlockFormat::BC7;
+            break;
+        case VK_FORMAT_R8G8B8A8_SRGB:
+            format = TextureBlockFormat::RGBA8;
+            break;
+        default:
+            throw std::runtime_error("[KTX2] Unsupported format " + std::to_string(vkFormat) + ": " + path + "\n");
+    }
+
+    if (levelCount > getMipLevelCount(width, height)) {
+        throw std::runtime_error("[KTX2] Invalid level count: " + path + "\n");
+    }
+
+    TextureKtx2 texture(format, width, height);
+
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        const auto entryOffset = KTX2_HEADER_SIZE + level * KTX2_LEVEL_INDEX_ENTRY_SIZE;
+
+        const auto byteOffset = readU64(entryOffset);
+        const auto byteLength = readU64(entryOffset + 8);
+
+        if (byteLength != texture.getLevelSize(level) || byteOffset > fileSize || byteLength > fileSize - byteOffset) {
+            throw std::runtime_error("[KTX2] Invalid level " + std::to_string(level) + ": " + path + "\n");
+        }
+
+        texture.levelOffsets.push_back(byteOffset);
+    }
+
+    texture.file = std::move(file);
+
+    return texture;
+}
+
+void vox::TextureKtx2::write(const std::string& path) const {
+    const auto levelCount = getLevelCount();
+    const auto blockSize = getBlockSize(format);
+
+    std::vector<Ktx2Sample> samples;
+    uint32_t colorModel = 0;
+
+    switch (format) {
+        case TextureBlockFormat::BC1:
+            colorModel = KHR_DF_MODEL_BC1A;
+            samples.push_back({ KHR_DF_CHANNEL_COLOR, 0, 63 });
+            break;
+        case TextureBlockFormat::BC3:
+            colorModel = KHR_DF_MODEL_BC3;
+            samples.push_back({ KHR_DF_CHANNEL_ALPHA | KHR_DF_SAMPLE_DATATYPE_LINEAR, 0, 63 });
+            samples.push_back({ KHR_DF_CHANNEL_COLOR, 64, 63 });
+            break;
+        case TextureBlockFormat::BC7:
+            colorModel = KHR_DF_MODEL_BC7;
+            samples.push_back({ KHR_DF_CHANNEL_COLOR, 0, 127 });
+            break;
+        case TextureBlockFormat::RGBA8:
+            colorModel = KHR_DF_MODEL_RGBSDA;
+            samples.push_back({ KHR_DF_CHANNEL_RED, 0, 7 });
+            samples.push_back({ KHR_DF_CHANNEL_GREEN, 8, 7 });
+            samples.push_back({ KHR_DF_CHANNEL_BLUE, 16, 7 });
+            samples.push_back({ KHR_DF_CHANNEL_ALPHA | KHR_DF_SAMPLE_DATATYPE_LINEAR, 24, 7 });
+            break;
+    }
+
+    const auto isBlockCompressed = format != TextureBlockFormat::RGBA8;
+
+    const auto dfdOffset = KTX2_HEADER_SIZE + levelCount * KTX2_LEVEL_INDEX_ENTRY_SIZE;
+    const auto dfdBlockSize = 24 + 16 * samples.size();
+    const auto dfdTotalSize = 4 + dfdBlockSize;
+
+    // Levels are stored smallest first, each aligned to the block size.
+    std::vector<size_t> fileOffsets(levelCount);
+
+    auto cursor = dfdOffset + dfdTotalSize;
+
+    for (auto level = levelCount; level-- > 0;) {
+        fileOffsets[level] = alignUp(cursor, blockSize);
+        cursor = fileOffsets[level] + getLevelSize(level);
+    }
+
+    std::vector<uint8_t> bytes(cursor);
+
+    const auto writeU32 = [&](const size_t offset, const uint32_t value) {
+        memcpy(bytes.data() + offset, &value, 4);
+    };
+
+    const auto writeU64 = [&](const size_t offset, const uint64_t value) {
+        memcpy(bytes.data() + offset, &value, 8);
+    };
+
+    memcpy(bytes.data(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+
+    writeU32(12, getVkFormat());
+    writeU32(16, 1); // typeSize
+    writeU32(20, width);
+    writeU32(24, height);
+    writeU32(28, 0); // pixelDepth
+    writeU32(32, 0); // layerCount
+    writeU32(36, 1); // faceCount
+    writeU32(40, levelCount);
+    writeU32(44, 0); // supercompressionScheme
+
+    writeU32(48, static_cast<uint32_t>(dfdOffset));
+    writeU32(52, static_cast<uint32_t>(dfdTotalSize));
+
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        const auto entryOffset = KTX2_HEADER_SIZE + level * KTX2_LEVEL_INDEX_ENTRY_SIZE;
+
+        writeU64(entryOffset, fileOffsets[level]);
+        writeU64(entryOffset + 8, getLevelSize(level));
+        writeU64(entryOffset + 16, getLevelSize(level));
+
+        memcpy(bytes.data() + fileOffsets[level], getLevel(level).data(), getLevelSize(level));
+    }
+
+    writeU32(dfdOffset, static_cast<uint32_t>(dfdTotalSize));
+    writeU32(dfdOffset + 4, 0); // vendorId, descriptorType
+    writeU32(dfdOffset + 8, KHR_DF_VERSION | static_cast<uint32_t>(dfdBlockSize) << 16);
+    writeU32(dfdOffset + 12, colorModel | KHR_DF_PRIMARIES_BT709 << 8 | KHR_DF_TRANSFER_SRGB << 16);
+    writeU32(dfdOffset + 16, isBlockCompressed ? 3 | 3 << 8 : 0); // 4x4 or 1x1 texel blocks
+    writeU32(dfdOffset + 20, static_cast<uint32_t>(blockSize));
+
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const auto sampleOffset = dfdOffset + 28 + i * 16;
+
+        writeU32(sampleOffset, samples[i].bitOffset | samples[i].bitLength << 16 | samples[i].channelType << 24);
+        writeU32(sampleOffset + 12, isBlockCompressed ? 0xFFFFFFFF : 0xFF); // sampleUpper
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open()) {
+        throw std::runtime_error("[KTX2] Failed to create file: " + path + "\n");
+    }
+
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+vox::TextureBlockFormat vox::TextureKtx2::getFormat() const {
+    return format;
+}
+
+VkFormat vox::TextureKtx2::getVkFormat() const {
+    switch (format) {
+        case TextureBlockFormat::BC1:
+            return VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+        case TextureBlockFormat::BC3:
+            return VK_FORMAT_BC3_SRGB_BLOCK;
+        case TextureBlockFormat::BC7:
+            return VK_FORMAT_BC7_SRGB_BLOCK;
+        case TextureBlockFormat::RGBA8:
+            return VK_FORMAT_R8G8B8A8_SRGB;
+    }
+
+    return VK_FORMAT_UNDEFINED;
+}
+
+uint32_t vox::TextureKtx2::getWidth() const {
+    return width;
+}
+
+uint32_t vox::TextureKtx2::getHeight() const {
+    return height;
+}
+
+uint32_t vox::TextureKtx2::getLevelCount() const {
+    return static_cast<uint32_t>(levelOffsets.size());
+}
+
+size_t vox::TextureKtx2::getLevelSize(const uint32_t level) const {
+    return getCompressedSize(format, getMipDimension(width, level), getMipDimension(height, level));
+}
+
+std::span<const uint8_t> vox::TextureKtx2::getLevel(const uint32_t level) const {
+    return getBytes().subspan(levelOffsets.at(level), getLevelSize(level));
+}
+
+size_t vox::TextureKtx2::getDataSize(const uint32_t baseLevel) const {
+    size_t size = 0;
+
+    for (auto level = baseLevel; level < getLevelCount(); ++level) {
+        size += getLevelSize(level);
+    }
+
+    return size;
+}
+
+void vox::TextureKtx2::copyLevels(const uint32_t baseLevel, uint8_t* data) const {
+    for (auto level = baseLevel; level < getLevelCount(); ++level) {
+        const auto levelData = getLevel(level);
+
+        memcpy(data, levelData.data(), levelData.size());
+
+        data += levelData.size();
+    }
+}
+
+std::span<const uint8_t> vox::TextureKtx2::getBytes() const {
+    if (file.has_value()) {
+        return file->getBytes();
+    }
+
+    return data;
+}
+
+void vox::TextureKtx2::addLevel(const std::span<const uint8_t> level) {
+    if (file.has_value() || level.size() != getLevelSize(getLevelCount())) {
+        throw std::runtime_error("[KTX2] Invalid level " + std::to_string(getLevelCount()) + "\n");
+    }
+
+    levelOffsets.push_back(data.size());
+    data.insert(data.end(), level.begin(), level.end());
+}
@@ -0,0 +1,89 @@
+#ifndef VOX_TEXTURE_KTX2_H
+#define VOX_TEXTURE_KTX2_H
+
+/**
+ * Block-compressed texture, stored in a KTX2 container.
+ *
+ * Textures are baked once from their source image: the full mip chain
+ * is generated on the CPU and every level is BCn encoded. The result is
+ * written as a KTX2 file, so later runs only read the compressed levels
+ * and copy them straight into a BC-format image.
+ *
+ * Only what the engine writes is read back: a single 2D image with no
+ * array layers, faces or supercompression, in BC1, BC3, BC7 or RGBA8 (sRGB).
+ *
+ * Files are memory mapped when read, and levels point straight into the
+ * mapping; baked textures own their levels instead.
+ */
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan_core.h>
+
+#include "texture_bc.h"
+#include "../misc/mapped_file.h"
+
+namespace vox {
+    class ThreadPool;
+
+    class TextureKtx2 {
+        TextureBlockFormat format;
+
+        uint32_t width;
+        uint32_t height;
+
+        // Owned level data, tightly packed, for baked textures.
+        std::vector<uint8_t> data = {};
+
+        // Mapped file, for textures read from disk.
+        std::optional<MappedFile> file = std::nullopt;
+
+        // Offset of every level within data or the mapped file, largest level first.
+        std::vector<size_t> levelOffsets = {};
+
+        [[nodiscard]] std::span<const uint8_t> getBytes() const;
+
+    public:
+        TextureKtx2() = delete;
+
+        TextureKtx2(TextureBlockFormat format, uint32_t width, uint32_t height)
+                : format(format), width(width), height(height) {
+        }
+
+        // Generates the full mip chain of the given RGBA8 pixels and compresses every level.
+        [[nodiscard]] static TextureKtx2 bake(ThreadPool& threadPool, std::span<const uint8_t> pixels, uint32_t width, uint32_t height, TextureBlockFormat format);
+
+        [[nodiscard]] static TextureKtx2 read(const std::string& path);
+
+        void write(const std::string& path) const;
+
+        // Appends the next mip level, which must be getLevelSize(getLevelCount()) bytes.
+        void addLevel(std::span<const uint8_t> level);
+
+        [[nodiscard]] TextureBlockFormat getFormat() const;
+
+        [[nodiscard]] VkFormat getVkFormat() const;
+
+        [[nodiscard]] uint32_t getWidth() const;
+        [[nodiscard]] uint32_t getHeight() const;
+
+        [[nodiscard]] uint32_t getLevelCount() const;
+
+        [[nodiscard]] size_t getLevelSize(uint32_t level) const;
+
+        [[nodiscard]] std::span<const uint8_t> getLevel(uint32_t level) const;
+
+        // Size in bytes of every level from baseLevel on, tightly packed.
+        [[nodiscard]] size_t getDataSize(uint32_t baseLevel = 0) const;
+
+        // Copies every level from baseLevel on into data, tightly packed,
+        // which must hold getDataSize(baseLevel) bytes.
+        void copyLevels(uint32_t baseLevel, uint8_t* data) const;
+    };
+}
+
+#endif
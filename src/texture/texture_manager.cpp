@@ -1,16 +1,42 @@
 #include "texture_manager.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <filesystem>
 #include <iostream>
+#include <ranges>
+#include <stdexcept>
+
+#include "texture_mipmap.h"
+#include "../misc/constants.h"
+
+#include "stb_image.h"
 
 vox::Texture &vox::TextureManager::getTexture(uint32_t textureId) {
     return textures.at(textureId);
 }
 
+const vox::Texture &vox::TextureManager::getTexture(uint32_t textureId) const {
+    return textures.at(textureId);
+}
+
 vox::TextureAtlas &vox::TextureManager::getAtlas(uint32_t atlasId) {
     return atlases.at(atlasId);
 }
 
+std::unordered_map<uint32_t, vox::Texture> &vox::TextureManager::getTextures() {
+    return textures;
+}
+
+std::unordered_map<uint32_t, vox::TextureAtlas> &vox::TextureManager::getAtlases() {
+    return atlases;
+}
+
+const vox::TextureCache& vox::TextureManager::getCache() const {
+    return cache;
+}
+
 void vox::TextureManager::addTexture(uint32_t textureId, vox::Texture texture) {
     textures.emplace(textureId, std::move(texture));
 }
@@ -27,16 +53,485 @@ void vox::TextureManager::removeAtlas(uint32_t atlasId) {
     atlases.erase(atlasId);
 }
 
-void vox::TextureManager::loadAll() {
+uint32_t vox::TextureManager::getCanonicalId(const uint32_t textureId) const {
+    const auto alias = aliases.find(textureId);
+
+    return alias != aliases.end() ? alias->second : textureId;
+}
+
+std::span<const uint8_t> vox::TextureManager::getPixels(const uint32_t textureId) const {
+    const auto& texture = textures.at(textureId);
+
+    return { pixelPool.data() + pixelOffsets.at(textureId), static_cast<size_t>(texture.getWidth()) * texture.getHeight() * 4 };
+}
+
+void vox::TextureManager::loadAll(ThreadPool& threadPool) {
+    const auto startTime = std::chrono::high_resolution_clock::now();
+
     const std::filesystem::directory_iterator textureIterator("textures");
 
+    std::vector<uint32_t> textureIds;
+
     for (const auto& textureEntry : textureIterator) {
-        if (textureEntry.path().extension() == ".png") {
-            auto texture = Texture(textures.size() + 1, textureEntry.path().string());
+        if (const auto extension = textureEntry.path().extension(); extension == ".png" || extension == ".jpg" || extension == ".jpeg") {
+            auto texture = Texture(static_cast<uint32_t>(textures.size() + 1), textureEntry.path().string());
 
-            std::cout << "[Vulkan] Loaded texture file: " << textureEntry.path().stem() << ".png\n" << std::flush;
+            textureIds.push_back(texture.getId());
 
             textures.emplace(texture.getId(), std::move(texture));
         }
     }
+
+    // First pass: map every file once, and either find its decoded pixels
+    // in the cache or parse its header.
+    std::vector<std::optional<MappedFile>> sourceFiles(textureIds.size());
+    std::vector<Hash128> sourceHashes(textureIds.size());
+    std::vector<std::optional<TextureKtx2>> cachedTextures(textureIds.size());
+
+    threadPool.parallelFor(textureIds.size(), [&](const size_t i) {
+        auto& texture = textures.at(textureIds[i]);
+
+        auto& sourceFile = sourceFiles[i].emplace(texture.getPath());
+        const auto sourceBytes = sourceFile.getBytes();
+
+        sourceHashes[i] = TextureCache::hashSource(sourceBytes);
+
+        if (auto cachedTexture = cache.find(sourceHashes[i], "rgba8"); cachedTexture.has_value()) {
+            texture.updateAfterLoaded(cachedTexture->getWidth(), cachedTexture->getHeight());
+
+            cachedTextures[i] = std::move(cachedTexture);
+            sourceFiles[i].reset();
+
+            return;
+        }
+
+        int width;
+        int height;
+        int channels;
+
+        if (!stbi_info_from_memory(sourceBytes.data(), static_cast<int>(sourceBytes.size()), &width, &height, &channels)) {
+            throw std::runtime_error("[STB] Failed to read texture info: " + texture.getPath() + "\n");
+        }
+
+        texture.updateAfterLoaded(width, height);
+    });
+
+    const auto cacheHitCount = std::ranges::count_if(cachedTextures, [](const auto& cachedTexture) {
+        return cachedTexture.has_value();
+    });
+
+    // Byte-identical files decode to identical pixels, so only the first is decoded.
+    std::unordered_map<Hash128, uint32_t> sourceOwners;
+    std::vector<size_t> uniqueIndices;
+
+    for (size_t i = 0; i < textureIds.size(); ++i) {
+        if (const auto [owner, inserted] = sourceOwners.try_emplace(sourceHashes[i], textureIds[i]); !inserted) {
+            aliases[textureIds[i]] = owner->second;
+
+            cachedTextures[i].reset();
+            sourceFiles[i].reset();
+
+            continue;
+        }
+
+        uniqueIndices.push_back(i);
+    }
+
+    // Every texture gets a slice of one pooled allocation.
+    size_t poolSize = 0;
+
+    for (const auto i : uniqueIndices) {
+        const auto& texture = textures.at(textureIds[i]);
+
+        pixelOffsets[textureIds[i]] = poolSize;
+        poolSize += static_cast<size_t>(texture.getWidth()) * texture.getHeight() * 4;
+    }
+
+    pixelPool.resize(poolSize);
+
+    std::vector<Hash128> pixelHashes(uniqueIndices.size());
+
+    // Second pass: copy cached pixels out of their mapping, or decode
+    // straight from the mapped source and add the result to the cache.
+    // Either way, the pixels are hashed to find textures that only
+    // differ in their encoding.
+    threadPool.parallelFor(uniqueIndices.size(), [&](const size_t j) {
+        const auto i = uniqueIndices[j];
+
+        const auto& texture = textures.at(textureIds[i]);
+
+        auto* destination = pixelPool.data() + pixelOffsets.at(textureIds[i]);
+        const auto size = static_cast<size_t>(texture.getWidth()) * texture.getHeight() * 4;
+
+        // The size is part of the seed, so that a 2x8 and a 4x4 texture never match.
+        const auto pixelSeed = static_cast<uint64_t>(texture.getWidth()) << 32 | texture.getHeight();
+
+        if (cachedTextures[i].has_value()) {
+            const auto level = cachedTextures[i]->getLevel(0);
+
+            memcpy(destination, level.data(), level.size());
+
+            cachedTextures[i].reset();
+
+            pixelHashes[j] = hash128({ destination, size }, pixelSeed);
+
+            return;
+        }
+
+        const auto sourceBytes = sourceFiles[i]->getBytes();
+
+        int width;
+        int height;
+        int channels;
+
+        stbi_uc* pixels = stbi_load_from_memory(sourceBytes.data(), static_cast<int>(sourceBytes.size()), &width, &height, &channels, STBI_rgb_alpha);
+
+        if (!pixels) {
+            throw std::runtime_error("[STB] Failed to decode texture: " + texture.getPath() + "\n");
+        }
+
+        const std::span<const uint8_t> decodedPixels(pixels, static_cast<size_t>(width) * height * 4);
+
+        memcpy(destination, decodedPixels.data(), decodedPixels.size());
+
+        TextureKtx2 decodedTexture(TextureBlockFormat::RGBA8, width, height);
+        decodedTexture.addLevel(decodedPixels);
+
+        // A failed store only costs the next run a decode; it must not unwind the other loads.
+        try {
+            cache.store(sourceHashes[i], "rgba8", decodedTexture);
+        } catch (const std::runtime_error& error) {
+            std::cerr << "[Cache] Failed to store decoded texture " << texture.getPath() << ": " << error.what() << "\n" << std::flush;
+        }
+
+        stbi_image_free(pixels);
+
+        sourceFiles[i].reset();
+
+        pixelHashes[j] = hash128(decodedPixels, pixelSeed);
+    });
+
+    // Collapse pixel-identical textures, and close the gaps they leave in the pool.
+    std::unordered_map<Hash128, uint32_t> pixelOwners;
+
+    size_t compactedSize = 0;
+
+    for (size_t j = 0; j < uniqueIndices.size(); ++j) {
+        const auto textureId = textureIds[uniqueIndices[j]];
+        const auto pixels = getPixels(textureId);
+
+        if (const auto owner = pixelOwners.find(pixelHashes[j]); owner != pixelOwners.end()) {
+            const auto ownerPixels = getPixels(owner->second);
+
+            if (ownerPixels.size() == pixels.size() && memcmp(ownerPixels.data(), pixels.data(), pixels.size()) == 0) {
+                aliases[textureId] = owner->second;
+                continue;
+            }
+        } else {
+            pixelOwners.emplace(pixelHashes[j], textureId);
+        }
+
+        memmove(pixelPool.data() + compactedSize, pixels.data(), pixels.size());
+
+        pixelOffsets[textureId] = compactedSize;
+        compactedSize += pixels.size();
+    }
+
+    pixelPool.resize(compactedSize);
+    pixelPool.shrink_to_fit();
+
+    // Aliases of aliases point straight at the texture that owns the pixels.
+    for (auto& ownerId : aliases | std::views::values) {
+        while (aliases.contains(ownerId)) {
+            ownerId = aliases.at(ownerId);
+        }
+    }
+
+    size_t savedSize = 0;
+
+    for (const auto& [textureId, ownerId] : aliases) {
+        const auto& texture = textures.at(textureId);
+
+        pixelOffsets[textureId] = pixelOffsets.at(ownerId);
+        savedSize += static_cast<size_t>(texture.getWidth()) * texture.getHeight() * 4;
+    }
+
+    const auto elapsedTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    for (const auto textureId : textureIds) {
+        std::cout << "[Vulkan] Loaded texture file: " << std::filesystem::path(textures.at(textureId).getPath()).filename().string() << "\n";
+    }
+
+    std::cout << "[Vulkan] Loaded " << textureIds.size() << " textures (" << compactedSize / 1024 << " KiB, " << cacheHitCount << " from cache) on " << threadPool.getThreadCount() << " threads in " << elapsedTime << " ms.\n" << std::flush;
+
+    if (!aliases.empty()) {
+        std::cout << "[Vulkan] Collapsed " << aliases.size() << " duplicate textures, saving " << savedSize / 1024 << " KiB.\n" << std::flush;
+    }
+}
+
+void vox::TextureManager::stitchAll(const uint32_t maxDimension) {
+    atlases.clear();
+
+    std::vector<uint32_t> remainingIds;
+
+    // Duplicates share the cell of the texture they alias.
+    for (const auto textureId : textures | std::views::keys) {
+        if (!aliases.contains(textureId)) {
+            remainingIds.push_back(textureId);
+        }
+    }
+
+    std::ranges::sort(remainingIds);
+
+    const auto textureCount = remainingIds.size();
+
+    while (!remainingIds.empty()) {
+        auto atlas = TextureAtlas(static_cast<uint32_t>(atlases.size() + 1));
+
+        for (const auto textureId : remainingIds) {
+            atlas.addTexture(textureId);
+        }
+
+        const auto overflowIds = atlas.stitchTextures(*this, maxDimension, ATLAS_PADDING, ATLAS_MIP_LEVELS);
+
+        if (overflowIds.size() == remainingIds.size()) {
+            throw std::runtime_error("[Atlas] Failed to fit any texture into atlas " + std::to_string(atlas.getId()) + "\n");
+        }
+
+        remainingIds = overflowIds;
+
+        atlases.emplace(atlas.getId(), std::move(atlas));
+    }
+
+    updateAliases();
+
+    // Every texture fits somewhere, as overflow goes to a new page.
+    placedIds.clear();
+    placedUserCounts.clear();
+
+    for (const auto textureId : textures | std::views::keys) {
+        placedIds.insert(textureId);
+        ++placedUserCounts[getCanonicalId(textureId)];
+    }
+
+    compactedRevisions.clear();
+
+    for (const auto& [atlasId, atlas] : atlases) {
+        compactedRevisions[atlasId] = atlas.getRevision();
+    }
+
+    // Compare against the previous horizontal layout, where every slot
+    // was as wide and as tall as the largest texture.
+    uint32_t maxWidth = 0;
+    uint32_t maxHeight = 0;
+
+    for (const auto& texture : textures | std::views::values) {
+        maxWidth = std::max(maxWidth, texture.getWidth());
+        maxHeight = std::max(maxHeight, texture.getHeight());
+    }
+
+    uint64_t atlasBytes = 0;
+
+    for (const auto& atlas : atlases | std::views::values) {
+        atlasBytes += static_cast<uint64_t>(atlas.getWidth()) * atlas.getHeight() * 4;
+    }
+
+    const auto horizontalBytes = static_cast<uint64_t>(maxWidth) * textureCount * maxHeight * 4;
+
+    std::cout << "[Atlas] Stitched " << textureCount << " textures into " << atlases.size() << " atlas page(s): "
+              << atlasBytes / 1024 << " KiB, versus " << horizontalBytes / 1024 << " KiB with a horizontal layout.\n" << std::flush;
+}
+
+std::optional<uint32_t> vox::TextureManager::placeTexture(const uint32_t textureId) {
+    const auto canonicalId = getCanonicalId(textureId);
+
+    if (placedIds.contains(textureId)) {
+        return textures.at(canonicalId).getAtlasId();
+    }
+
+    // A duplicate of a placed texture only takes a share of its cell.
+    if (const auto userCount = placedUserCounts.find(canonicalId); userCount != placedUserCounts.end()) {
+        placedIds.insert(textureId);
+        ++userCount->second;
+
+        updateAliases();
+
+        return textures.at(canonicalId).getAtlasId();
+    }
+
+    for (auto& [atlasId, atlas] : atlases) {
+        if (atlas.insertTexture(*this, canonicalId)) {
+            placedIds.insert(textureId);
+            placedUserCounts[canonicalId] = 1;
+
+            updateAliases();
+
+            return atlasId;
+        }
+    }
+
+    return std::nullopt;
+}
+
+void vox::TextureManager::evictTexture(const uint32_t textureId) {
+    if (!placedIds.erase(textureId)) {
+        throw std::runtime_error("[Atlas] Texture " + std::to_string(textureId) + " is not placed\n");
+    }
+
+    const auto canonicalId = getCanonicalId(textureId);
+
+    if (--placedUserCounts.at(canonicalId) > 0) {
+        return;
+    }
+
+    placedUserCounts.erase(canonicalId);
+
+    atlases.at(textures.at(canonicalId).getAtlasId()).eraseTexture(canonicalId);
+}
+
+bool vox::TextureManager::isPlaced(const uint32_t textureId) const {
+    return placedIds.contains(textureId);
+}
+
+uint32_t vox::TextureManager::getBaseLevel(const uint32_t textureId) const {
+    const auto baseLevel = baseLevels.find(getCanonicalId(textureId));
+
+    return baseLevel != baseLevels.end() ? baseLevel->second : 0;
+}
+
+std::pair<uint32_t, uint32_t> vox::TextureManager::getPlacedSize(const uint32_t textureId) const {
+    const auto& texture = textures.at(textureId);
+    const auto baseLevel = getBaseLevel(textureId);
+
+    return { getMipDimension(texture.getWidth(), baseLevel), getMipDimension(texture.getHeight(), baseLevel) };
+}
+
+bool vox::TextureManager::setBaseLevel(const uint32_t textureId, const uint32_t baseLevel) {
+    const auto canonicalId = getCanonicalId(textureId);
+    const auto currentLevel = getBaseLevel(canonicalId);
+
+    if (baseLevel == currentLevel) {
+        return true;
+    }
+
+    // Every user of the cell is evicted, and placed again at the new size.
+    std::vector<uint32_t> userIds;
+
+    for (const auto placedId : placedIds) {
+        if (getCanonicalId(placedId) == canonicalId) {
+            userIds.push_back(placedId);
+        }
+    }
+
+    for (const auto userId : userIds) {
+        evictTexture(userId);
+    }
+
+    baseLevels[canonicalId] = baseLevel;
+
+    if (userIds.empty()) {
+        return true;
+    }
+
+    // The cell just freed is free again, so the previous size always fits back.
+    const auto placed = placeTexture(userIds.front()).has_value();
+
+    if (!placed) {
+        baseLevels[canonicalId] = currentLevel;
+    }
+
+    for (const auto userId : userIds) {
+        if (!placeTexture(userId).has_value()) {
+            throw std::runtime_error("[Atlas] Failed to place texture " + std::to_string(userId) + " back into an atlas\n");
+        }
+    }
+
+    return placed;
+}
+
+void vox::TextureManager::compactAtlases(ThreadPool& threadPool, const float threshold) {
+    for (const auto& [atlasId, atlas] : atlases) {
+        if (compactions.contains(atlasId) || atlas.getFragmentation() <= threshold) {
+            continue;
+        }
+
+        // A layout that was already repacked, successfully or not, is left alone until it changes.
+        if (const auto revision = compactedRevisions.find(atlasId); revision != compactedRevisions.end() && revision->second == atlas.getRevision()) {
+            continue;
+        }
+
+        compactedRevisions[atlasId] = atlas.getRevision();
+
+        // The repack works on a copy, so the atlas stays usable meanwhile.
+        compactions.emplace(atlasId, threadPool.submit([atlas] {
+            return atlas.repackTextures();
+        }));
+    }
+}
+
+std::vector<uint32_t> vox::TextureManager::finishCompactions() {
+    std::vector<uint32_t> compactedIds;
+
+    for (auto compaction = compactions.begin(); compaction != compactions.end();) {
+        auto& [atlasId, future] = *compaction;
+
+        if (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            ++compaction;
+            continue;
+        }
+
+        auto repackedAtlas = future.get();
+
+        const auto& atlas = atlases.at(atlasId);
+        const auto fragmentation = atlas.getFragmentation();
+
+        // Textures placed or evicted while repacking make the result stale;
+        // it is dropped, and the atlas is repacked again if still fragmented.
+        // A repack that packs no tighter is dropped too, as swapping it in
+        // would only cost a full upload.
+        if (repackedAtlas.has_value() && repackedAtlas->getRevision() == atlas.getRevision() && repackedAtlas->getFragmentation() < fragmentation) {
+            std::cout << "[Atlas] Compacted atlas " << atlasId << ": " << fragmentation * 100.0f << "% to " << repackedAtlas->getFragmentation() * 100.0f << "% fragmented.\n" << std::flush;
+
+            repackedAtlas->applyPlacements(*this);
+
+            atlases.erase(atlasId);
+            atlases.emplace(atlasId, std::move(repackedAtlas.value()));
+
+            compactedIds.push_back(atlasId);
+        }
+
+        compaction = compactions.erase(compaction);
+    }
+
+    if (!compactedIds.empty()) {
+        updateAliases();
+    }
+
+    return compactedIds;
+}
+
+void vox::TextureManager::updateAliases() {
+    for (const auto& [textureId, ownerId] : aliases) {
+        const auto& owner = textures.at(ownerId);
+
+        textures.at(textureId).updateAfterUploaded(owner.getAtlasId(), owner.getMinU(), owner.getMinV(), owner.getMaxU(), owner.getMaxV());
+    }
+}
+
+void vox::TextureManager::registerAll(const VkDevice& device, TextureTable& table, const std::map<uint32_t, VkImageView>& atlasImageViews, VkSampler sampler) {
+    for (const auto atlasIndex : atlasTableIndices | std::views::values) {
+        table.remove(atlasIndex);
+    }
+
+    atlasTableIndices.clear();
+
+    for (const auto& [atlasId, atlasImageView] : atlasImageViews) {
+        atlasTableIndices[atlasId] = table.add(device, atlasImageView, sampler);
+    }
+
+    std::cout << "[Atlas] Registered " << atlasTableIndices.size() << " atlas page(s) into the texture table.\n" << std::flush;
+}
+
+uint32_t vox::TextureManager::getTableIndex(const uint32_t textureId) const {
+    return atlasTableIndices.at(textures.at(textureId).getAtlasId());
 }
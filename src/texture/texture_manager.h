@@ -11,12 +11,44 @@
  * This class is responsible for managing textures.
  *
  * Textures have an ID and path.
+ *
+ * Every texture file is read and decoded exactly once, in parallel,
+ * into a single pooled pixel buffer (RGBA8, tightly packed).
+ *
+ * Decoded pixels are kept in a content-addressed disk cache, so
+ * that later runs copy them from a mapped file instead of decoding.
+ *
+ * Identical textures are stored once: byte-identical files are only
+ * decoded once, and textures with identical pixels are collapsed after
+ * decoding. Every duplicate keeps its id, as an alias of the first
+ * texture with that content, and shares its pixels and atlas cell.
+ *
+ * Textures can also be placed into, and evicted from, stitched atlas
+ * pages at runtime; only their cells are uploaded again. A texture can
+ * be placed from a lower mip level, which shrinks its cell, so that
+ * texture residency can drop the levels it has no use for. Pages that
+ * fragment past a threshold are repacked on the thread pool, and the
+ * result is swapped in once it is ready.
+ *
+ * Once uploaded, every atlas page is registered into the bindless
+ * texture table; textures are then drawn through their page's index.
  */
 
 #include <unordered_map>
+#include <unordered_set>
 #include <cstdint>
+#include <future>
+#include <map>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
 #include "texture_atlas.h"
 #include "texture.h"
+#include "texture_cache.h"
+#include "texture_table.h"
+#include "../misc/constants.h"
+#include "../misc/thread_pool.h"
 
 namespace vox {
     class TextureManager {
@@ -24,6 +56,34 @@ namespace vox {
         std::unordered_map<uint32_t, TextureAtlas> atlases = {};
         std::unordered_map<uint32_t, Texture> textures = {};
 
+        std::vector<uint8_t> pixelPool = {};
+        std::unordered_map<uint32_t, size_t> pixelOffsets = {};
+
+        // Duplicate textures, mapped to the texture whose content they share.
+        std::unordered_map<uint32_t, uint32_t> aliases = {};
+
+        // Textures with an atlas cell, and the number of them sharing each canonical
+        // texture's cell; the cell is only freed once its last user is evicted.
+        std::unordered_set<uint32_t> placedIds = {};
+        std::unordered_map<uint32_t, uint32_t> placedUserCounts = {};
+
+        // Sharpest mip level canonical textures are placed from, when not 0.
+        std::unordered_map<uint32_t, uint32_t> baseLevels = {};
+
+        TextureCache cache = TextureCache(TEXTURE_CACHE_DIRECTORY);
+
+        std::unordered_map<uint32_t, uint32_t> atlasTableIndices = {};
+
+        // Repacks running in the background, by atlas.
+        std::unordered_map<uint32_t, std::future<std::optional<TextureAtlas>>> compactions = {};
+
+        // Revision of every atlas when it was stitched or last repacked; an atlas is
+        // only repacked again once textures have been placed or evicted since.
+        std::unordered_map<uint32_t, uint64_t> compactedRevisions = {};
+
+        // Copies the atlas placement of every aliased texture to its aliases.
+        void updateAliases();
+
     public:
         TextureManager() = default;
 
@@ -39,8 +99,16 @@ namespace vox {
 
         Texture &getTexture(uint32_t textureId);
 
+        [[nodiscard]] const Texture &getTexture(uint32_t textureId) const;
+
         TextureAtlas &getAtlas(uint32_t atlasId);
 
+        std::unordered_map<uint32_t, Texture>& getTextures();
+
+        std::unordered_map<uint32_t, TextureAtlas>& getAtlases();
+
+        [[nodiscard]] const TextureCache& getCache() const;
+
         void addTexture(uint32_t textureId, Texture texture);
 
         void addAtlas(uint32_t atlasId, TextureAtlas atlas);
@@ -49,7 +117,54 @@ namespace vox {
 
         void removeAtlas(uint32_t atlasId);
 
-        void loadAll();
+        // Returns the decoded RGBA8 pixels of a texture.
+        [[nodiscard]] std::span<const uint8_t> getPixels(uint32_t textureId) const;
+
+        // Returns the id of the texture that holds the content of the given one;
+        // this is the texture itself unless it is a duplicate.
+        [[nodiscard]] uint32_t getCanonicalId(uint32_t textureId) const;
+
+        void loadAll(ThreadPool& threadPool);
+
+        // Packs every texture into as few atlas pages as possible,
+        // with no page exceeding maxDimension on either side.
+        void stitchAll(uint32_t maxDimension);
+
+        // Places a loaded texture into the first stitched atlas with room for it,
+        // and returns that atlas, or nothing if a restitch is needed. Duplicates
+        // share the cell of the texture they alias, placing it if needed.
+        std::optional<uint32_t> placeTexture(uint32_t textureId);
+
+        // Evicts a placed texture; its cell is freed once no duplicate uses it either.
+        void evictTexture(uint32_t textureId);
+
+        [[nodiscard]] bool isPlaced(uint32_t textureId) const;
+
+        [[nodiscard]] uint32_t getBaseLevel(uint32_t textureId) const;
+
+        // Size of the texture in its atlas cell, that of its base level.
+        [[nodiscard]] std::pair<uint32_t, uint32_t> getPlacedSize(uint32_t textureId) const;
+
+        // Places a texture, and its duplicates, from another mip level. Returns false,
+        // leaving it at its current level, when no atlas has room for the new cell;
+        // a lower level always fits, as it takes less than the cell it frees.
+        bool setBaseLevel(uint32_t textureId, uint32_t baseLevel);
+
+        // Starts repacking, on the thread pool, every atlas whose fragmentation
+        // is above the threshold and that changed since it was last repacked.
+        // Repacks work on a copy, so textures may be placed and evicted meanwhile.
+        void compactAtlases(ThreadPool& threadPool, float threshold);
+
+        // Swaps in every finished repack that is still current and less fragmented
+        // than the atlas, and returns the ids of the atlases that changed; every
+        // cell of them moved, so their images must be uploaded whole.
+        std::vector<uint32_t> finishCompactions();
+
+        // Registers every uploaded atlas page into the texture table.
+        void registerAll(const VkDevice& device, TextureTable& table, const std::map<uint32_t, VkImageView>& atlasImageViews, VkSampler sampler);
+
+        // Returns the texture table index of the atlas page holding a texture.
+        [[nodiscard]] uint32_t getTableIndex(uint32_t textureId) const;
     };
 }
 
@@ -0,0 +1,81 @@
+#include "texture_mipmap.h"
+
+#include <algorithm>
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define VOX_MIPMAP_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace vox {
+    uint32_t getMipLevelCount(const uint32_t width, const uint32_t height) {
+        return std::bit_width(std::max(std::max(width, height), 1u));
+    }
+
+    uint32_t getMipDimension(const uint32_t dimension, const uint32_t level) {
+        return std::max(dimension >> level, 1u);
+    }
+
+    static void downsampleBoxScalar(const uint8_t* source, const uint32_t sourceWidth, const uint32_t sourceHeight, uint8_t* destination, const uint32_t startX) {
+        const auto destinationWidth = getMipDimension(sourceWidth, 1);
+        const auto destinationHeight = getMipDimension(sourceHeight, 1);
+
+        for (uint32_t y = 0; y < destinationHeight; ++y) {
+            const auto* row0 = source + static_cast<size_t>(std::min(y * 2, sourceHeight - 1)) * sourceWidth * 4;
+            const auto* row1 = source + static_cast<size_t>(std::min(y * 2 + 1, sourceHeight - 1)) * sourceWidth * 4;
+
+            for (uint32_t x = startX; x < destinationWidth; ++x) {
+                const auto x0 = std::min(x * 2, sourceWidth - 1) * 4;
+                const auto x1 = std::min(x * 2 + 1, sourceWidth - 1) * 4;
+
+                for (uint32_t c = 0; c < 4; ++c) {
+                    destination[(static_cast<size_t>(y) * destinationWidth + x) * 4 + c] = static_cast<uint8_t>((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+                }
+            }
+        }
+    }
+
+    void downsampleBox(const uint8_t* source, const uint32_t sourceWidth, const uint32_t sourceHeight, uint8_t* destination) {
+        uint32_t vectorWidth = 0;
+
+#ifdef VOX_MIPMAP_SSE2
+        // Two destination texels (four source texels per row) per iteration,
+        // widened to 16 bits so the rounding matches the scalar path exactly.
+        if (sourceWidth % 2 == 0 && sourceHeight % 2 == 0) {
+            const auto destinationWidth = sourceWidth / 2;
+            const auto destinationHeight = sourceHeight / 2;
+
+            vectorWidth = destinationWidth & ~1u;
+
+            const auto zero = _mm_setzero_si128();
+            const auto bias = _mm_set1_epi16(2);
+
+            for (uint32_t y = 0; y < destinationHeight; ++y) {
+                const auto* row0 = source + static_cast<size_t>(y) * 2 * sourceWidth * 4;
+                const auto* row1 = row0 + static_cast<size_t>(sourceWidth) * 4;
+
+                auto* destinationRow = destination + static_cast<size_t>(y) * destinationWidth * 4;
+
+                for (uint32_t x = 0; x < vectorWidth; x += 2) {
+                    const auto top = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8));
+                    const auto bottom = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8));
+
+                    // Lanes 0-3 hold texel 0 and lanes 4-7 texel 1 of each pair.
+                    const auto sumLow = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+                    const auto sumHigh = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+
+                    const auto pairLow = _mm_add_epi16(sumLow, _mm_srli_si128(sumLow, 8));
+                    const auto pairHigh = _mm_add_epi16(sumHigh, _mm_srli_si128(sumHigh, 8));
+
+                    const auto average = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(pairLow, pairHigh), bias), 2);
+
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(destinationRow + x * 4), _mm_packus_epi16(average, zero));
+                }
+            }
+        }
+#endif
+
+        downsampleBoxScalar(source, sourceWidth, sourceHeight, destination, vectorWidth);
+    }
+}
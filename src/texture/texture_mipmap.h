@@ -0,0 +1,25 @@
+#ifndef VOX_TEXTURE_MIPMAP_H
+#define VOX_TEXTURE_MIPMAP_H
+
+/**
+ * CPU mipmap generation for RGBA8 images.
+ *
+ * Standalone textures get their mip chain on the GPU through
+ * vkCmdBlitImage, but atlases cannot: a blit filters across the
+ * whole image and bleeds neighbouring textures into each other.
+ * Atlas cells are instead downsampled one by one with a 2x2 box
+ * filter at bake time.
+ */
+
+#include <cstdint>
+
+namespace vox {
+    [[nodiscard]] uint32_t getMipLevelCount(uint32_t width, uint32_t height);
+
+    [[nodiscard]] uint32_t getMipDimension(uint32_t dimension, uint32_t level);
+
+    // Writes the next mip level of source, which is max(1, width / 2) x max(1, height / 2) texels.
+    void downsampleBox(const uint8_t* source, uint32_t sourceWidth, uint32_t sourceHeight, uint8_t* destination);
+}
+
+#endif
@@ -0,0 +1,190 @@
+#include "texture_packer.h"
+
+#include <algorithm>
+#include <limits>
+
+vox::TexturePacker::TexturePacker(const uint32_t width, const uint32_t height, const uint32_t padding, const uint32_t alignment)
+        : width(width), height(height), padding(padding), alignment(alignment) {
+    freeRects.push_back({ 0, 0, width, height });
+}
+
+uint32_t vox::TexturePacker::getCellSize(const uint32_t size, const uint32_t padding, const uint32_t alignment) {
+    return (size + padding * 2 + alignment - 1) & ~(alignment - 1);
+}
+
+std::optional<vox::TexturePackerRect> vox::TexturePacker::insert(const uint32_t width, const uint32_t height) {
+    // Free rectangles are bounded by cell edges, so as long as every cell
+    // is a multiple of the alignment, every placement stays aligned too.
+    const auto cellWidth = getCellSize(width, padding, alignment);
+    const auto cellHeight = getCellSize(height, padding, alignment);
+
+    auto bestShortSide = std::numeric_limits<uint32_t>::max();
+    auto bestLongSide = std::numeric_limits<uint32_t>::max();
+
+    std::optional<TexturePackerRect> bestCell = std::nullopt;
+
+    for (const auto& freeRect : freeRects) {
+        if (freeRect.width < cellWidth || freeRect.height < cellHeight) {
+            continue;
+        }
+
+        const auto leftoverX = freeRect.width - cellWidth;
+        const auto leftoverY = freeRect.height - cellHeight;
+
+        const auto shortSide = std::min(leftoverX, leftoverY);
+        const auto longSide = std::max(leftoverX, leftoverY);
+
+        if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide)) {
+            bestShortSide = shortSide;
+            bestLongSide = longSide;
+
+            bestCell = TexturePackerRect { freeRect.x, freeRect.y, cellWidth, cellHeight };
+        }
+    }
+
+    if (!bestCell.has_value()) {
+        return std::nullopt;
+    }
+
+    splitFreeRects(bestCell.value());
+    pruneFreeRects();
+
+    usedArea += static_cast<uint64_t>(width) * height;
+    usedCellArea += bestCell->getArea();
+
+    return TexturePackerRect { bestCell->x + padding, bestCell->y + padding, width, height };
+}
+
+void vox::TexturePacker::remove(const TexturePackerRect& rect) {
+    const TexturePackerRect cell {
+        rect.x - padding,
+        rect.y - padding,
+        getCellSize(rect.width, padding, alignment),
+        getCellSize(rect.height, padding, alignment)
+    };
+
+    usedArea -= rect.getArea();
+    usedCellArea -= cell.getArea();
+
+    freeRects.push_back(cell);
+
+    mergeFreeRects();
+    pruneFreeRects();
+}
+
+// Every free rectangle overlapping the placed cell is replaced by
+// the (up to four) maximal rectangles that remain around it.
+void vox::TexturePacker::splitFreeRects(const TexturePackerRect& usedRect) {
+    std::vector<TexturePackerRect> splitRects;
+
+    for (const auto& freeRect : freeRects) {
+        if (!freeRect.intersects(usedRect)) {
+            splitRects.push_back(freeRect);
+            continue;
+        }
+
+        if (usedRect.x > freeRect.x) {
+            splitRects.push_back({ freeRect.x, freeRect.y, usedRect.x - freeRect.x, freeRect.height });
+        }
+
+        if (usedRect.x + usedRect.width < freeRect.x + freeRect.width) {
+            const auto x = usedRect.x + usedRect.width;
+            splitRects.push_back({ x, freeRect.y, freeRect.x + freeRect.width - x, freeRect.height });
+        }
+
+        if (usedRect.y > freeRect.y) {
+            splitRects.push_back({ freeRect.x, freeRect.y, freeRect.width, usedRect.y - freeRect.y });
+        }
+
+        if (usedRect.y + usedRect.height < freeRect.y + freeRect.height) {
+            const auto y = usedRect.y + usedRect.height;
+            splitRects.push_back({ freeRect.x, y, freeRect.width, freeRect.y + freeRect.height - y });
+        }
+    }
+
+    freeRects = std::move(splitRects);
+}
+
+// Free rectangles that share a whole edge are joined, until no two do.
+void vox::TexturePacker::mergeFreeRects() {
+    bool merged = true;
+
+    while (merged) {
+        merged = false;
+
+        for (size_t i = 0; i < freeRects.size() && !merged; ++i) {
+            for (size_t j = i + 1; j < freeRects.size(); ++j) {
+                auto& lhs = freeRects[i];
+                const auto& rhs = freeRects[j];
+
+                if (lhs.y == rhs.y && lhs.height == rhs.height && (lhs.x + lhs.width == rhs.x || rhs.x + rhs.width == lhs.x)) {
+                    lhs.x = std::min(lhs.x, rhs.x);
+                    lhs.width += rhs.width;
+                } else if (lhs.x == rhs.x && lhs.width == rhs.width && (lhs.y + lhs.height == rhs.y || rhs.y + rhs.height == lhs.y)) {
+                    lhs.y = std::min(lhs.y, rhs.y);
+                    lhs.height += rhs.height;
+                } else {
+                    continue;
+                }
+
+                freeRects.erase(freeRects.begin() + static_cast<std::ptrdiff_t>(j));
+                merged = true;
+
+                break;
+            }
+        }
+    }
+}
+
+void vox::TexturePacker::pruneFreeRects() {
+    for (size_t i = 0; i < freeRects.size(); ++i) {
+        for (size_t j = i + 1; j < freeRects.size(); ++j) {
+            if (freeRects[j].contains(freeRects[i])) {
+                freeRects.erase(freeRects.begin() + static_cast<std::ptrdiff_t>(i));
+                --i;
+                break;
+            }
+
+            if (freeRects[i].contains(freeRects[j])) {
+                freeRects.erase(freeRects.begin() + static_cast<std::ptrdiff_t>(j));
+                --j;
+            }
+        }
+    }
+}
+
+uint32_t vox::TexturePacker::getWidth() const {
+    return width;
+}
+
+uint32_t vox::TexturePacker::getHeight() const {
+    return height;
+}
+
+uint32_t vox::TexturePacker::getPadding() const {
+    return padding;
+}
+
+uint32_t vox::TexturePacker::getAlignment() const {
+    return alignment;
+}
+
+float vox::TexturePacker::getOccupancy() const {
+    return static_cast<float>(static_cast<double>(usedArea) / (static_cast<double>(width) * height));
+}
+
+float vox::TexturePacker::getFragmentation() const {
+    const auto freeArea = static_cast<uint64_t>(width) * height - usedCellArea;
+
+    if (freeArea == 0) {
+        return 0.0f;
+    }
+
+    uint64_t largestFreeArea = 0;
+
+    for (const auto& freeRect : freeRects) {
+        largestFreeArea = std::max(largestFreeArea, freeRect.getArea());
+    }
+
+    return 1.0f - static_cast<float>(static_cast<double>(largestFreeArea) / static_cast<double>(freeArea));
+}
@@ -0,0 +1,89 @@
+#ifndef VOX_TEXTURE_PACKER_H
+#define VOX_TEXTURE_PACKER_H
+
+/**
+ * MaxRects bin packer used to lay out textures in an atlas page.
+ *
+ * The packer keeps a list of maximal free rectangles and places
+ * every new rectangle in the free rectangle that leaves the
+ * shortest leftover side (best short side fit). Every placed
+ * rectangle is surrounded by a padding gutter so that filtering
+ * never samples a neighbouring texture.
+ *
+ * Cells (content plus gutter) can be aligned to a power of two,
+ * so that mip levels up to log2(alignment) never mix two cells.
+ *
+ * Placed rectangles can be removed again. Their cell is returned
+ * to the free list and merged with free neighbours along shared
+ * edges; this does not restore every maximal rectangle, so pages
+ * with a lot of churn should be repacked once they fragment.
+ */
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace vox {
+    struct TexturePackerRect {
+        uint32_t x;
+        uint32_t y;
+        uint32_t width;
+        uint32_t height;
+
+        [[nodiscard]] uint64_t getArea() const {
+            return static_cast<uint64_t>(width) * height;
+        }
+
+        [[nodiscard]] bool contains(const TexturePackerRect& other) const {
+            return other.x >= x && other.y >= y && other.x + other.width <= x + width && other.y + other.height <= y + height;
+        }
+
+        [[nodiscard]] bool intersects(const TexturePackerRect& other) const {
+            return other.x < x + width && other.x + other.width > x && other.y < y + height && other.y + other.height > y;
+        }
+    };
+
+    class TexturePacker {
+        uint32_t width;
+        uint32_t height;
+        uint32_t padding;
+        uint32_t alignment;
+
+        uint64_t usedArea = 0;
+        uint64_t usedCellArea = 0;
+
+        std::vector<TexturePackerRect> freeRects = {};
+
+        void splitFreeRects(const TexturePackerRect& usedRect);
+        void mergeFreeRects();
+        void pruneFreeRects();
+
+    public:
+        TexturePacker() = delete;
+
+        TexturePacker(uint32_t width, uint32_t height, uint32_t padding = 0, uint32_t alignment = 1);
+
+        // Size of the aligned cell that holds content of the given size.
+        [[nodiscard]] static uint32_t getCellSize(uint32_t size, uint32_t padding, uint32_t alignment);
+
+        // Returns the placement of the content, excluding the padding gutter.
+        [[nodiscard]] std::optional<TexturePackerRect> insert(uint32_t width, uint32_t height);
+
+        // Frees the cell of a placement previously returned by insert.
+        void remove(const TexturePackerRect& rect);
+
+        [[nodiscard]] uint32_t getWidth() const;
+        [[nodiscard]] uint32_t getHeight() const;
+        [[nodiscard]] uint32_t getPadding() const;
+        [[nodiscard]] uint32_t getAlignment() const;
+
+        // Fraction of the page covered by placed content, excluding padding.
+        [[nodiscard]] float getOccupancy() const;
+
+        // How scattered the free space is: 0 when it is a single rectangle,
+        // approaching 1 as the largest free rectangle shrinks relative to it.
+        [[nodiscard]] float getFragmentation() const;
+    };
+}
+
+#endif
@@ -0,0 +1,258 @@
+#include "texture_residency.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+
+#include "texture_mipmap.h"
+#include "../misc/constants.h"
+
+size_t vox::TextureResidency::getSize(const Entry& entry, const uint32_t baseLevel) {
+    size_t size = 0;
+
+    for (auto level = baseLevel; level < entry.levelCount; ++level) {
+        size += getCompressedSize(entry.format, getMipDimension(entry.width, level), getMipDimension(entry.height, level));
+    }
+
+    return size;
+}
+
+void vox::TextureResidency::addTexture(const uint32_t textureId, const TextureBlockFormat format, const uint32_t width, const uint32_t height, const uint32_t levelCount, const uint32_t residentLevel) {
+    if (residentLevel >= levelCount) {
+        throw std::runtime_error("[Residency] Resident level out of range for texture " + std::to_string(textureId) + "\n");
+    }
+
+    Entry entry = {
+        .format = format,
+        .width = width,
+        .height = height,
+        .levelCount = levelCount,
+        .residentLevel = residentLevel,
+        .desiredLevel = residentLevel
+    };
+
+    residentSize += getSize(entry, residentLevel);
+
+    entries.insert_or_assign(textureId, entry);
+}
+
+void vox::TextureResidency::removeTexture(const uint32_t textureId) {
+    const auto entry = entries.find(textureId);
+
+    if (entry == entries.end()) {
+        return;
+    }
+
+    residentSize -= getSize(entry->second, entry->second.residentLevel);
+
+    if (entry->second.streamingLevel.has_value()) {
+        streamingSize -= getSize(entry->second, entry->second.streamingLevel.value()) - getSize(entry->second, entry->second.residentLevel);
+    }
+
+    entries.erase(entry);
+}
+
+uint32_t vox::TextureResidency::getDesiredLevel(const uint32_t width, const uint32_t height, const uint32_t levelCount, const float screenSize) {
+    // Textures that are not visible only keep their smallest level.
+    if (screenSize <= 0.0f) {
+        return levelCount - 1;
+    }
+
+    const auto texelsPerPixel = static_cast<float>(std::max(width, height)) / screenSize;
+
+    if (texelsPerPixel <= 1.0f) {
+        return 0;
+    }
+
+    return std::min(static_cast<uint32_t>(std::floor(std::log2(texelsPerPixel))), levelCount - 1);
+}
+
+void vox::TextureResidency::requestLevel(const uint32_t textureId, const uint32_t level) {
+    auto& entry = entries.at(textureId);
+
+    const auto clampedLevel = std::min(level, entry.levelCount - 1);
+
+    entry.desiredLevel = entry.lastUsedFrame == frame ? std::min(entry.desiredLevel, clampedLevel) : clampedLevel;
+    entry.lastUsedFrame = frame;
+}
+
+bool vox::TextureResidency::evictLevel(const std::optional<uint32_t> excludedId, const bool allowUsed, std::unordered_map<uint32_t, TextureResidencyChange>& evictions) {
+    std::optional<uint32_t> victimId = std::nullopt;
+
+    for (const auto& [textureId, entry] : entries) {
+        if (textureId == excludedId || entry.streamingLevel.has_value() || entry.residentLevel + 1 >= entry.levelCount) {
+            continue;
+        }
+
+        // Textures drawn this frame only give up levels sharper than they need.
+        if (!allowUsed && entry.lastUsedFrame == frame && entry.residentLevel >= entry.desiredLevel) {
+            continue;
+        }
+
+        if (!victimId.has_value()) {
+            victimId = textureId;
+            continue;
+        }
+
+        const auto& victim = entries.at(victimId.value());
+
+        if (entry.lastUsedFrame < victim.lastUsedFrame || (entry.lastUsedFrame == victim.lastUsedFrame && textureId < victimId.value())) {
+            victimId = textureId;
+        }
+    }
+
+    if (!victimId.has_value()) {
+        return false;
+    }
+
+    auto& victim = entries.at(victimId.value());
+
+    const auto fromLevel = victim.residentLevel;
+    const auto toLevel = fromLevel + 1;
+
+    const auto freedSize = getSize(victim, fromLevel) - getSize(victim, toLevel);
+
+    residentSize -= freedSize;
+    victim.residentLevel = toLevel;
+
+    addEvent(TextureResidencyEventType::Evict, victimId.value(), fromLevel, toLevel, freedSize);
+
+    // Several levels dropped from one texture are applied as a single change.
+    if (const auto [eviction, inserted] = evictions.try_emplace(victimId.value(), TextureResidencyChange { victimId.value(), fromLevel, toLevel }); !inserted) {
+        eviction->second.toLevel = toLevel;
+    }
+
+    return true;
+}
+
+std::vector<vox::TextureResidencyChange> vox::TextureResidency::update() {
+    std::unordered_map<uint32_t, TextureResidencyChange> evictions;
+    std::vector<TextureResidencyChange> streams;
+
+    // A lowered budget is enforced first, even against textures in use.
+    while (residentSize + streamingSize > budget && evictLevel(std::nullopt, true, evictions)) {
+    }
+
+    // Textures drawn this frame that need sharper levels, largest gain first.
+    std::vector<uint32_t> candidateIds;
+
+    for (const auto& [textureId, entry] : entries) {
+        if (entry.lastUsedFrame == frame && !entry.streamingLevel.has_value() && entry.desiredLevel < entry.residentLevel) {
+            candidateIds.push_back(textureId);
+        }
+    }
+
+    std::ranges::sort(candidateIds, [this](const uint32_t lhs, const uint32_t rhs) {
+        const auto& lhsEntry = entries.at(lhs);
+        const auto& rhsEntry = entries.at(rhs);
+
+        const auto lhsGain = lhsEntry.residentLevel - lhsEntry.desiredLevel;
+        const auto rhsGain = rhsEntry.residentLevel - rhsEntry.desiredLevel;
+
+        return lhsGain != rhsGain ? lhsGain > rhsGain : lhs < rhs;
+    });
+
+    for (const auto textureId : candidateIds) {
+        auto& entry = entries.at(textureId);
+
+        auto targetLevel = entry.desiredLevel;
+
+        // Make room by evicting other textures; when nothing else can
+        // give up a level, settle for a coarser one instead.
+        while (targetLevel < entry.residentLevel) {
+            const auto growth = getSize(entry, targetLevel) - getSize(entry, entry.residentLevel);
+
+            if (residentSize + streamingSize + growth <= budget) {
+                break;
+            }
+
+            if (!evictLevel(textureId, false, evictions)) {
+                ++targetLevel;
+            }
+        }
+
+        if (targetLevel >= entry.residentLevel) {
+            continue;
+        }
+
+        streamingSize += getSize(entry, targetLevel) - getSize(entry, entry.residentLevel);
+        entry.streamingLevel = targetLevel;
+
+        streams.push_back({ textureId, entry.residentLevel, targetLevel });
+    }
+
+    ++frame;
+
+    std::vector<TextureResidencyChange> changes;
+
+    for (const auto& eviction : evictions | std::views::values) {
+        changes.push_back(eviction);
+    }
+
+    changes.insert(changes.end(), streams.begin(), streams.end());
+
+    return changes;
+}
+
+void vox::TextureResidency::finishStream(const uint32_t textureId) {
+    auto& entry = entries.at(textureId);
+
+    if (!entry.streamingLevel.has_value()) {
+        throw std::runtime_error("[Residency] No stream in flight for texture " + std::to_string(textureId) + "\n");
+    }
+
+    const auto fromLevel = entry.residentLevel;
+    const auto toLevel = entry.streamingLevel.value();
+
+    const auto growth = getSize(entry, toLevel) - getSize(entry, fromLevel);
+
+    streamingSize -= growth;
+    residentSize += growth;
+
+    entry.residentLevel = toLevel;
+    entry.streamingLevel.reset();
+
+    addEvent(TextureResidencyEventType::Stream, textureId, fromLevel, toLevel, growth);
+}
+
+void vox::TextureResidency::cancelStream(const uint32_t textureId) {
+    auto& entry = entries.at(textureId);
+
+    if (!entry.streamingLevel.has_value()) {
+        throw std::runtime_error("[Residency] No stream in flight for texture " + std::to_string(textureId) + "\n");
+    }
+
+    streamingSize -= getSize(entry, entry.streamingLevel.value()) - getSize(entry, entry.residentLevel);
+
+    entry.streamingLevel.reset();
+}
+
+void vox::TextureResidency::addEvent(const TextureResidencyEventType type, const uint32_t textureId, const uint32_t fromLevel, const uint32_t toLevel, const size_t size) {
+    events.push_back({ type, textureId, fromLevel, toLevel, size, frame });
+
+    while (events.size() > TEXTURE_RESIDENCY_EVENT_COUNT) {
+        events.pop_front();
+    }
+}
+
+void vox::TextureResidency::setBudget(const size_t budget) {
+    this->budget = budget;
+}
+
+size_t vox::TextureResidency::getBudget() const {
+    return budget;
+}
+
+size_t vox::TextureResidency::getResidentSize() const {
+    return residentSize;
+}
+
+uint32_t vox::TextureResidency::getResidentLevel(const uint32_t textureId) const {
+    return entries.at(textureId).residentLevel;
+}
+
+const std::deque<vox::TextureResidencyEvent>& vox::TextureResidency::getEvents() const {
+    return events;
+}
@@ -0,0 +1,156 @@
+#ifndef VOX_TEXTURE_RESIDENCY_H
+#define VOX_TEXTURE_RESIDENCY_H
+
+/**
+ * Texture residency, under a memory budget.
+ *
+ * Every managed texture has a full mip chain on the CPU, but only the
+ * levels from its resident level down to the smallest one are on the GPU.
+ * Each frame, callers request the level a texture needs (usually from
+ * its estimated size on screen), and update() decides what changes:
+ * - textures that need sharper levels are streamed in, asynchronously;
+ * - when that would exceed the budget, the least recently used textures
+ *   lose their sharpest levels first.
+ *
+ * This class only makes the decisions and keeps the books; applying a
+ * change (building the smaller or larger image) is up to the caller,
+ * which reports streams back through finishStream once they completed,
+ * or through cancelStream when they could not be applied.
+ *
+ * The smallest level of every texture always stays resident.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "texture_bc.h"
+
+namespace vox {
+    enum class TextureResidencyEventType : uint8_t {
+        Stream,
+        Evict
+    };
+
+    struct TextureResidencyEvent {
+        TextureResidencyEventType type;
+
+        uint32_t textureId;
+
+        // Sharpest resident level before and after the event.
+        uint32_t fromLevel;
+        uint32_t toLevel;
+
+        // Bytes added to, or removed from, the resident size.
+        size_t size;
+
+        uint64_t frame;
+    };
+
+    // A change of sharpest resident level, which the caller must apply.
+    struct TextureResidencyChange {
+        uint32_t textureId;
+
+        uint32_t fromLevel;
+        uint32_t toLevel;
+
+        [[nodiscard]] bool isEviction() const {
+            return toLevel > fromLevel;
+        }
+    };
+
+    class TextureResidency {
+        struct Entry {
+            TextureBlockFormat format;
+
+            uint32_t width;
+            uint32_t height;
+            uint32_t levelCount;
+
+            uint32_t residentLevel;
+            uint32_t desiredLevel;
+
+            uint64_t lastUsedFrame = 0;
+
+            std::optional<uint32_t> streamingLevel = std::nullopt;
+        };
+
+        std::unordered_map<uint32_t, Entry> entries = {};
+
+        size_t budget;
+
+        size_t residentSize = 0;
+
+        // Size reserved by streams in flight, on top of what they replace.
+        size_t streamingSize = 0;
+
+        // Starts at 1, so that a last used frame of 0 means never used.
+        uint64_t frame = 1;
+
+        std::deque<TextureResidencyEvent> events = {};
+
+        // Size in bytes of every level from baseLevel down to the smallest one.
+        [[nodiscard]] static size_t getSize(const Entry& entry, uint32_t baseLevel);
+
+        // Drops the sharpest level of the least recently used texture that
+        // can lose one, and returns false if there is none.
+        bool evictLevel(std::optional<uint32_t> excludedId, bool allowUsed, std::unordered_map<uint32_t, TextureResidencyChange>& evictions);
+
+        void addEvent(TextureResidencyEventType type, uint32_t textureId, uint32_t fromLevel, uint32_t toLevel, size_t size);
+
+    public:
+        explicit TextureResidency(size_t budget)
+                : budget(budget) {
+        }
+
+        TextureResidency(const TextureResidency& other) = delete;
+
+        TextureResidency(TextureResidency&& other) noexcept = delete;
+
+        TextureResidency& operator=(const TextureResidency& other) = delete;
+
+        TextureResidency& operator=(TextureResidency&& other) = delete;
+
+        ~TextureResidency() = default;
+
+        // Starts managing a texture, whose levels from residentLevel on are resident.
+        void addTexture(uint32_t textureId, TextureBlockFormat format, uint32_t width, uint32_t height, uint32_t levelCount, uint32_t residentLevel = 0);
+
+        void removeTexture(uint32_t textureId);
+
+        // Level needed to draw a texture spanning screenSize pixels along
+        // its longest side, at about one texel per pixel.
+        [[nodiscard]] static uint32_t getDesiredLevel(uint32_t width, uint32_t height, uint32_t levelCount, float screenSize);
+
+        // Marks a texture as used this frame, at the given level. When requested
+        // more than once per frame, the sharpest level wins.
+        void requestLevel(uint32_t textureId, uint32_t level);
+
+        // Ends the frame, and returns the evictions and streams to apply.
+        // Evictions take effect immediately; streams once finishStream is called.
+        [[nodiscard]] std::vector<TextureResidencyChange> update();
+
+        // Marks the stream in flight for a texture as resident.
+        void finishStream(uint32_t textureId);
+
+        // Drops the stream in flight for a texture, which keeps its resident level;
+        // it is streamed again once next requested.
+        void cancelStream(uint32_t textureId);
+
+        void setBudget(size_t budget);
+
+        [[nodiscard]] size_t getBudget() const;
+
+        [[nodiscard]] size_t getResidentSize() const;
+
+        [[nodiscard]] uint32_t getResidentLevel(uint32_t textureId) const;
+
+        // Most recent events, oldest first.
+        [[nodiscard]] const std::deque<TextureResidencyEvent>& getEvents() const;
+    };
+}
+
+#endif
@@ -0,0 +1,140 @@
+#include "texture_table.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+void vox::TextureTable::build(const VkDevice& device, const uint32_t capacity) {
+    this->capacity = capacity;
+
+    constexpr VkDescriptorBindingFlags bindingFlags =
+            VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT |
+            VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT |
+            VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT_EXT;
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsCreateInfo = {};
+    bindingFlagsCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+    bindingFlagsCreateInfo.bindingCount = 1;
+    bindingFlagsCreateInfo.pBindingFlags = &bindingFlags;
+
+    VkDescriptorSetLayoutBinding binding = {};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    binding.descriptorCount = capacity;
+    binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    binding.pImmutableSamplers = nullptr;
+
+    VkDescriptorSetLayoutCreateInfo layoutCreateInfo = {};
+    layoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutCreateInfo.pNext = &bindingFlagsCreateInfo;
+    layoutCreateInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+    layoutCreateInfo.bindingCount = 1;
+    layoutCreateInfo.pBindings = &binding;
+
+    if (VK_SUCCESS != vkCreateDescriptorSetLayout(device, &layoutCreateInfo, nullptr, &descriptorSetLayout)) {
+        throw std::runtime_error("[Texture] Failed to create texture table descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize poolSize = {};
+    poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSize.descriptorCount = capacity;
+
+    VkDescriptorPoolCreateInfo poolCreateInfo = {};
+    poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+    poolCreateInfo.maxSets = 1;
+    poolCreateInfo.poolSizeCount = 1;
+    poolCreateInfo.pPoolSizes = &poolSize;
+
+    if (VK_SUCCESS != vkCreateDescriptorPool(device, &poolCreateInfo, nullptr, &descriptorPool)) {
+        throw std::runtime_error("[Texture] Failed to create texture table descriptor pool!");
+    }
+
+    VkDescriptorSetVariableDescriptorCountAllocateInfoEXT countAllocateInfo = {};
+    countAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO_EXT;
+    countAllocateInfo.descriptorSetCount = 1;
+    countAllocateInfo.pDescriptorCounts = &capacity;
+
+    VkDescriptorSetAllocateInfo allocateInfo = {};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocateInfo.pNext = &countAllocateInfo;
+    allocateInfo.descriptorPool = descriptorPool;
+    allocateInfo.descriptorSetCount = 1;
+    allocateInfo.pSetLayouts = &descriptorSetLayout;
+
+    if (VK_SUCCESS != vkAllocateDescriptorSets(device, &allocateInfo, &descriptorSet)) {
+        throw std::runtime_error("[Texture] Failed to allocate texture table descriptor set!");
+    }
+}
+
+uint32_t vox::TextureTable::add(const VkDevice& device, VkImageView imageView, VkSampler sampler) {
+    uint32_t index;
+
+    if (!freeIndices.empty()) {
+        index = freeIndices.back();
+        freeIndices.pop_back();
+    } else if (count < capacity) {
+        index = count++;
+    } else {
+        throw std::runtime_error("[Texture] Texture table is full (" + std::to_string(capacity) + " slots)!");
+    }
+
+    set(device, index, imageView, sampler);
+
+    return index;
+}
+
+void vox::TextureTable::set(const VkDevice& device, const uint32_t index, VkImageView imageView, VkSampler sampler) const {
+    VkDescriptorImageInfo imageInfo = {};
+    imageInfo.sampler = sampler;
+    imageInfo.imageView = imageView;
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkWriteDescriptorSet writeDescriptorSet = {};
+    writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writeDescriptorSet.dstSet = descriptorSet;
+    writeDescriptorSet.dstBinding = 0;
+    writeDescriptorSet.dstArrayElement = index;
+    writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    writeDescriptorSet.descriptorCount = 1;
+    writeDescriptorSet.pImageInfo = &imageInfo;
+
+    vkUpdateDescriptorSets(device, 1, &writeDescriptorSet, 0, nullptr);
+}
+
+void vox::TextureTable::remove(const uint32_t index) {
+    if (index >= count || std::ranges::find(freeIndices, index) != freeIndices.end()) {
+        throw std::runtime_error("[Texture] Texture table slot " + std::to_string(index) + " is not in use!");
+    }
+
+    freeIndices.push_back(index);
+}
+
+void vox::TextureTable::destroy(const VkDevice& device) {
+    // The set is freed along with its pool.
+    vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+    vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+
+    descriptorPool = VK_NULL_HANDLE;
+    descriptorSetLayout = VK_NULL_HANDLE;
+    descriptorSet = VK_NULL_HANDLE;
+
+    count = 0;
+    freeIndices.clear();
+}
+
+VkDescriptorSetLayout vox::TextureTable::getDescriptorSetLayout() const {
+    return descriptorSetLayout;
+}
+
+VkDescriptorSet vox::TextureTable::getDescriptorSet() const {
+    return descriptorSet;
+}
+
+uint32_t vox::TextureTable::getCapacity() const {
+    return capacity;
+}
+
+uint32_t vox::TextureTable::getCount() const {
+    return count - static_cast<uint32_t>(freeIndices.size());
+}
@@ -0,0 +1,69 @@
+#ifndef VOX_TEXTURE_TABLE_H
+#define VOX_TEXTURE_TABLE_H
+
+/**
+ * Bindless texture table, built on descriptor indexing.
+ *
+ * A single descriptor set holds a runtime-sized array of combined
+ * image samplers, bound once per command buffer at its own set index.
+ * Textures and atlas pages are registered into a slot, and draws refer
+ * to them by that index instead of rebinding descriptors.
+ *
+ * Slots are partially bound and update-after-bind, so entries can be
+ * added or replaced while the set is in use, as long as no pending draw
+ * reads that slot; unused slots are never written.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan_core.h>
+
+namespace vox {
+    class TextureTable {
+        VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+        VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+
+        uint32_t capacity = 0;
+
+        // Slots handed out so far; released slots are reused first.
+        uint32_t count = 0;
+        std::vector<uint32_t> freeIndices = {};
+
+    public:
+        TextureTable() = default;
+
+        TextureTable(const TextureTable& other) = delete;
+
+        TextureTable(TextureTable&& other) noexcept = delete;
+
+        TextureTable& operator=(const TextureTable& other) = delete;
+
+        TextureTable& operator=(TextureTable&& other) = delete;
+
+        ~TextureTable() = default;
+
+        // Creates the layout, pool and set, with room for capacity textures.
+        void build(const VkDevice& device, uint32_t capacity);
+
+        // Writes the image into a free slot, and returns its index.
+        [[nodiscard]] uint32_t add(const VkDevice& device, VkImageView imageView, VkSampler sampler);
+
+        // Rewrites an existing slot, e.g. when its image is recreated.
+        void set(const VkDevice& device, uint32_t index, VkImageView imageView, VkSampler sampler) const;
+
+        // Releases a slot; its descriptor is left as is until it is reused.
+        void remove(uint32_t index);
+
+        void destroy(const VkDevice& device);
+
+        [[nodiscard]] VkDescriptorSetLayout getDescriptorSetLayout() const;
+        [[nodiscard]] VkDescriptorSet getDescriptorSet() const;
+
+        [[nodiscard]] uint32_t getCapacity() const;
+        [[nodiscard]] uint32_t getCount() const;
+    };
+}
+
+#endif